@@ -0,0 +1,1166 @@
+/*
+ *
+ *
+ * Parser generator. Reads the grammar of the language (docs/grammar.txt,
+ * whose first lines describe the notation) and writes the LALR(1) tables
+ * used by the parser: src/parsetables.c and src/parsetables.h.
+ *
+ * The states are those of the LR(0) automaton of the grammar. The LR(1)
+ * lookaheads of their items are then propagated along the transitions until
+ * nothing changes, which gives the LALR(1) lookaheads. Shift/reduce
+ * conflicts are settled with the precedence of the operators, like yacc
+ * does, or by shifting (they must be announced with %expect).
+ *
+ * The AST built by each rule is written as a short program for the parser
+ * (see ParseCode in parser.h).
+ *
+ * Usage: lrgen <grammar> <tables.c> <tables.h>
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// Maximum length of a line of the grammar
+#define MAX_LINE 1024
+
+// Maximum length of a symbol name
+#define MAX_NAME 64
+
+// Maximum number of symbols (terminals and non-terminals)
+#define MAX_SYMBOLS 256
+
+// Maximum number of rules, once the optional symbols are expanded
+#define MAX_RULES 512
+
+// Maximum number of symbols written in an alternative
+#define MAX_RHS 24
+
+// Maximum number of optional groups ([...]) in an alternative
+#define MAX_GROUPS 4
+
+// Maximum number of elements in the action of an alternative
+#define MAX_ACTION 64
+
+// Maximum number of states of the automaton
+#define MAX_STATES 1024
+
+// Maximum number of kernel items in a state
+#define MAX_KERNEL 64
+
+// Maximum number of entries in the code of the rules
+#define MAX_CODE 16384
+
+// Words in a set of terminals (one bit per column)
+#define SET_WORDS 4
+
+// Bits in a word of a set of terminals
+#define WORD_BITS 64
+
+// Encodes an item (a rule with a dot before the symbol number dot)
+#define ITEM(rule, dot) ((rule) * (MAX_RHS + 1) + (dot))
+
+// Rule of an item
+#define ITEM_RULE(item) ((item) / (MAX_RHS + 1))
+
+// Dot position of an item
+#define ITEM_DOT(item) ((item) % (MAX_RHS + 1))
+
+typedef unsigned long long TermSet[SET_WORDS];
+
+// Associativity of the operators
+typedef enum enAssoc {
+  ASSOC_NONE,
+  ASSOC_LEFT,
+  ASSOC_RIGHT
+} Assoc;
+
+// Elements of the actions (what follows -> in an alternative)
+typedef enum enActionKind {
+  ACT_POS,  // a symbol of the alternative
+  ACT_NODE,  // Name(...)
+  ACT_LIST  // [...]
+} ActionKind;
+
+typedef struct stSymbol {
+  char name[MAX_NAME];
+  int terminal;
+  int column;  // terminals: column in the ACTION table (0 if precedence only)
+  int number;  // non-terminals: column in the GOTO table
+  char tokenType[MAX_NAME];  // terminals: name of the token type
+  int prec;  // precedence level (0 if none)
+  Assoc assoc;
+  int isList;  // non-terminals: whether the value is a list
+  int nullable;
+  TermSet first;
+} Symbol;
+
+typedef struct stRule {
+  int lhs;
+  int rhs[MAX_RHS];
+  int length;
+  int prec;  // precedence level (0 if none)
+  int code;  // start of the action in the code
+  int nodes;  // nodes created by the action
+  int line;  // line of the grammar
+} Rule;
+
+// An alternative as written in the grammar
+typedef struct stAlternative {
+  char lhs[MAX_NAME];
+  char words[MAX_RHS + 2][MAX_NAME];
+  int nWords;
+  char action[MAX_LINE];
+  int line;
+} Alternative;
+
+typedef struct stAction {
+  ActionKind kind;
+  int pos;  // ACT_POS: position in the alternative (from 1)
+  char name[MAX_NAME];  // ACT_NODE: the node type, without NT
+  int children[MAX_ACTION];
+  int nChildren;
+} Action;
+
+typedef struct stState {
+  int kernel[MAX_KERNEL];  // sorted items
+  TermSet la[MAX_KERNEL];  // lookaheads of the kernel items
+  int nKernel;
+  int trans[MAX_SYMBOLS];  // target state for each symbol (-1 if none)
+} State;
+
+char* grammarFile;
+
+Symbol symbols[MAX_SYMBOLS];
+int nSymbols;
+int nColumns = 2;  // column 0: tokens not in the grammar, 1: end of file
+int nNonterminals;
+
+Rule rules[MAX_RULES];
+int nRules;
+
+Alternative alts[MAX_RULES];
+int nAlts;
+
+Action actions[MAX_ACTION];
+int nActions;
+
+char* code[MAX_CODE];
+int nCode;
+int maxOperands;
+
+State states[MAX_STATES];
+int nStates;
+
+int expected = 0;
+int precLevels = 0;
+
+// Work areas of the closure of a state (indexed by symbol)
+int ntIn[MAX_SYMBOLS];
+TermSet ntLa[MAX_SYMBOLS];
+
+// The tables
+short actionTable[MAX_STATES][MAX_SYMBOLS];
+short gotoTable[MAX_STATES][MAX_SYMBOLS];
+
+/*
+ * Prints an error about the grammar and exits.
+ *
+ * line: line of the grammar where the error is (0 if unknown).
+ * msg: the error message.
+ * name: a name to be printed after the message (or NULL).
+ *
+ */
+void fail(int line, char* msg, char* name);
+
+/*
+ * Finds a symbol by its name.
+ *
+ * name: the name of the symbol.
+ * returns: its index, or -1 if there is no such symbol.
+ *
+ */
+int findSymbol(char* name);
+
+/*
+ * Adds a symbol.
+ *
+ * name: the name of the symbol.
+ * terminal: 1 for terminals, 0 for non-terminals.
+ * returns: the index of the symbol.
+ *
+ */
+int addSymbol(char* name, int terminal);
+
+/*
+ * Reads the grammar file: the directives (lines starting with %token,
+ * %left, %right or %expect) and the alternatives of the rules.
+ *
+ * filename: the grammar file.
+ *
+ */
+void readGrammar(char* filename);
+
+/*
+ * Turns an alternative into rules (one for each combination of present and
+ * absent optional groups).
+ *
+ * alt: the alternative.
+ *
+ */
+void addAlternative(Alternative* alt);
+
+/*
+ * Parses an action.
+ *
+ * str: pointer to the text of the action, advanced past the parsed element.
+ * line: line of the grammar, for messages.
+ * returns: the index of the parsed element in the actions array.
+ *
+ */
+int parseAction(char** str, int line);
+
+/*
+ * Adds the code of an element of an action to the code of a rule.
+ *
+ * rule: the rule.
+ * act: the element of the action.
+ * posMap: index in the rule of each written symbol (-1 if absent).
+ * inside: 1 if the value is a child of a node or an element of a list.
+ * depth: operands already on the stack of the parser.
+ *
+ */
+void emitAction(Rule* rule, int act, int* posMap, int inside, int depth);
+
+/*
+ * Adds an entry to the code of the rules.
+ *
+ * text: the entry (C expression).
+ *
+ */
+void emit(char* text);
+
+/*
+ * Adds the rules of the list non-terminal for NAME* (created when first
+ * used).
+ *
+ * name: the name of the listed non-terminal.
+ * line: line of the grammar, for messages.
+ * returns: the list non-terminal.
+ *
+ */
+int listSymbol(char* name, int line);
+
+/*
+ * Computes which non-terminals are nullable and the FIRST sets.
+ *
+ */
+void computeFirst();
+
+/*
+ * Adds the FIRST set of a sequence of symbols to a set.
+ *
+ * syms: the symbols.
+ * n: number of symbols.
+ * set: the set to be extended.
+ * returns: 1 if the sequence is nullable, 0 otherwise.
+ *
+ */
+int firstOfSequence(int* syms, int n, TermSet set);
+
+/*
+ * Adds a set of terminals to another one.
+ *
+ * dest: the set to be extended.
+ * src: the added set.
+ * returns: 1 if dest changed, 0 otherwise.
+ *
+ */
+int setUnion(TermSet dest, TermSet src);
+
+/*
+ * Builds the states of the LR(0) automaton and its transitions.
+ *
+ */
+void buildStates();
+
+/*
+ * Computes the closure of a state in the work areas: which non-terminals
+ * have their rules in the closure (ntIn), and with which lookaheads (ntLa).
+ *
+ * state: the state.
+ *
+ */
+void closure(State* state);
+
+/*
+ * Finds the state with some kernel, or adds it.
+ *
+ * kernel: the sorted items of the kernel.
+ * n: number of items.
+ * returns: the index of the state.
+ *
+ */
+int findState(int* kernel, int n);
+
+/*
+ * Propagates the lookaheads between states until nothing changes.
+ *
+ */
+void propagateLookaheads();
+
+/*
+ * Fills the ACTION and GOTO tables, settling the conflicts.
+ *
+ */
+void buildTables();
+
+/*
+ * Puts a reduction in the ACTION table, settling conflicts.
+ *
+ * s: the state.
+ * col: the column of the lookahead.
+ * rule: the rule to be reduced.
+ * conflicts: number of conflicts settled by shifting, to be increased.
+ *
+ */
+void addReduction(int s, int col, int rule, int* conflicts);
+
+/*
+ * Writes the parse tables.
+ *
+ * cFile: the C file with the tables.
+ * hFile: the header file declaring them.
+ *
+ */
+void writeTables(char* cFile, char* hFile);
+
+/*
+ * Prints a rule, for messages and comments.
+ *
+ * out: where to print.
+ * rule: the rule.
+ * dot: position of the dot of an item (-1 to print no dot).
+ *
+ */
+void printRule(FILE* out, int rule, int dot);
+
+
+int main(int argc, char** argv) {
+  if(argc != 4) {
+    fprintf(stderr, "Usage: %s <grammar> <tables.c> <tables.h>\n", argv[0]);
+    return 1;
+  }
+
+  grammarFile = argv[1];
+  readGrammar(argv[1]);
+  computeFirst();
+  buildStates();
+  propagateLookaheads();
+  buildTables();
+  writeTables(argv[2], argv[3]);
+  return 0;
+}
+
+void fail(int line, char* msg, char* name) {
+  if(line > 0) fprintf(stderr, "%s:%d: ", grammarFile, line);
+  else fprintf(stderr, "%s: ", grammarFile);
+
+  if(name) fprintf(stderr, "%s '%s'.\n", msg, name);
+  else fprintf(stderr, "%s.\n", msg);
+  exit(1);
+}
+
+int findSymbol(char* name) {
+  for(int i = 0; i < nSymbols; i++)
+    if(strcmp(symbols[i].name, name) == 0) return i;
+  return -1;
+}
+
+int addSymbol(char* name, int terminal) {
+  if(nSymbols == MAX_SYMBOLS) fail(0, "Too many symbols", NULL);
+  if(strlen(name) >= MAX_NAME) fail(0, "Symbol name too long", name);
+
+  Symbol* sym = &symbols[nSymbols];
+  memset(sym, 0, sizeof(Symbol));
+  strcpy(sym->name, name);
+  sym->terminal = terminal;
+  if(!terminal) sym->number = nNonterminals++;
+  return nSymbols++;
+}
+
+void readGrammar(char* filename) {
+  FILE* file = fopen(filename, "r");
+  if(!file) fail(0, "Cannot open the grammar", NULL);
+
+  // the augmented rule comes first: $accept := <start symbol>
+  int accept = addSymbol("$accept", 0);
+  int eof = addSymbol("$end", 1);
+  symbols[eof].column = 1;
+  strcpy(symbols[eof].tokenType, "TTEof");
+
+  char line[MAX_LINE];
+  int lnum = 0;
+  Alternative* alt = NULL;  // alternative being read
+  char lhs[MAX_NAME] = "";
+
+  while(fgets(line, MAX_LINE, file)) {
+    lnum++;
+    char* p = line;
+    while(isspace(*p)) p++;
+    if(*p == '#' || *p == '\0') continue;
+
+    char first[MAX_NAME];
+    int n = 0;
+    sscanf(p, "%63s%n", first, &n);
+
+    if(strcmp(first, "%token") == 0) {
+      char name[MAX_NAME], type[MAX_NAME];
+      if(sscanf(p + n, "%63s %63s", name, type) != 2)
+        fail(lnum, "Bad %token line", NULL);
+      int sym = findSymbol(name);
+      if(sym >= 0 && symbols[sym].column > 0)
+        fail(lnum, "Token declared twice", name);
+
+      if(sym < 0) sym = addSymbol(name, 1);
+      symbols[sym].column = nColumns++;
+      strcpy(symbols[sym].tokenType, type);
+      continue;
+    }
+
+    if(strcmp(first, "%left") == 0 || strcmp(first, "%right") == 0) {
+      Assoc assoc = first[1] == 'l' ? ASSOC_LEFT : ASSOC_RIGHT;
+      precLevels++;
+      p += n;
+
+      char name[MAX_NAME];
+      while(sscanf(p, "%63s%n", name, &n) == 1) {
+        int sym = findSymbol(name);
+        if(sym < 0) sym = addSymbol(name, 1);  // %token or %prec later
+        symbols[sym].prec = precLevels;
+        symbols[sym].assoc = assoc;
+        p += n;
+      }
+      continue;
+    }
+
+    if(strcmp(first, "%expect") == 0) {
+      if(sscanf(p + n, "%d", &expected) != 1)
+        fail(lnum, "Bad %expect line", NULL);
+      continue;
+    }
+
+    // a line of a rule, split into words
+    char word[MAX_NAME];
+    while(sscanf(p, "%63s%n", word, &n) == 1) {
+      char next[MAX_NAME] = "";
+      sscanf(p + n, "%63s", next);
+
+      if(strcmp(next, ":=") == 0) { // start of a new rule
+        strcpy(lhs, word);
+        alt = NULL;
+        p = strstr(p, ":=") + 2;
+        continue;
+      }
+      if(lhs[0] == '\0') fail(lnum, "Alternative outside a rule", NULL);
+
+      if(strcmp(word, "|") == 0) {
+        alt = NULL;
+      } else {
+        if(!alt) {
+          if(nAlts == MAX_RULES) fail(lnum, "Too many alternatives", NULL);
+          alt = &alts[nAlts++];
+          memset(alt, 0, sizeof(Alternative));
+          strcpy(alt->lhs, lhs);
+          alt->line = lnum;
+        }
+
+        if(strcmp(word, "->") == 0) { // the action: rest of the line
+          p += n;
+          while(isspace(*p)) p++;
+          strcpy(alt->action, p);
+          alt->action[strcspn(alt->action, "\r\n")] = '\0';
+          alt = NULL;
+          break;
+        }
+
+        if(alt->nWords == MAX_RHS + 2) fail(lnum, "Alternative too long", NULL);
+        strcpy(alt->words[alt->nWords++], word);
+      }
+      p += n;
+    }
+  }
+  fclose(file);
+
+  if(nAlts == 0) fail(0, "No rules in the grammar", NULL);
+
+  // every left side is a non-terminal
+  for(int i = 0; i < nAlts; i++) {
+    int sym = findSymbol(alts[i].lhs);
+    if(sym >= 0 && symbols[sym].terminal)
+      fail(alts[i].line, "Terminal used as a rule", alts[i].lhs);
+    if(sym < 0) addSymbol(alts[i].lhs, 0);
+  }
+
+  rules[0] = (Rule) {
+    .lhs = accept,
+    .rhs = { findSymbol(alts[0].lhs) },
+    .length = 1,
+    .code = 0,
+    .line = alts[0].line
+  };
+  nRules = 1;
+  emit("PC_VALUE");
+  emit("0");
+  emit("PC_END");
+  maxOperands = 1;
+
+  // list values are known from the top of the actions
+  for(int i = 0; i < nAlts; i++) {
+    char* a = alts[i].action;
+    if(*a == '[') symbols[findSymbol(alts[i].lhs)].isList = 1;
+  }
+
+  for(int i = 0; i < nAlts; i++) addAlternative(&alts[i]);
+}
+
+void addAlternative(Alternative* alt) {
+  int syms[MAX_RHS];  // written symbols
+  int groups[MAX_RHS];  // optional group of each (-1 if none)
+  int nSyms = 0;
+  int nGroups = 0;
+  int inGroup = -1;
+  int precSym = -1;
+  int lhs = findSymbol(alt->lhs);
+
+  for(int i = 0; i < alt->nWords; i++) {
+    char* word = alt->words[i];
+
+    if(strcmp(word, "%prec") == 0) {
+      if(i + 1 == alt->nWords) fail(alt->line, "Missing symbol after %prec",
+        NULL);
+      precSym = findSymbol(alt->words[++i]);
+      if(precSym < 0 || !symbols[precSym].prec)
+        fail(alt->line, "No precedence for", alt->words[i]);
+      continue;
+    }
+
+    // brackets attached to the symbols mark the optional groups
+    if(word[0] == '[' && word[1] != '\0') {
+      if(inGroup >= 0) fail(alt->line, "Nested optional symbols", NULL);
+      if(nGroups == MAX_GROUPS) fail(alt->line, "Too many optional groups",
+        NULL);
+      inGroup = nGroups++;
+      word++;
+    }
+    int closes = 0;
+    int len = strlen(word);
+    if(len > 1 && word[len - 1] == ']') {
+      if(inGroup < 0) fail(alt->line, "Unbalanced ']'", NULL);
+      word[--len] = '\0';
+      closes = 1;
+    }
+
+    int sym;
+    if(len > 1 && word[len - 1] == '*') {
+      word[len - 1] = '\0';
+      sym = listSymbol(word, alt->line);
+    } else {
+      sym = findSymbol(word);
+      if(sym < 0) fail(alt->line, "Unknown symbol", word);
+    }
+    if(symbols[sym].terminal && symbols[sym].column == 0)
+      fail(alt->line, "Precedence-only symbol used in a rule", word);
+
+    if(nSyms == MAX_RHS) fail(alt->line, "Alternative too long", NULL);
+    syms[nSyms] = sym;
+    groups[nSyms++] = inGroup;
+    if(closes) inGroup = -1;
+  }
+  if(inGroup >= 0) fail(alt->line, "Unbalanced '['", NULL);
+
+  // the action
+  nActions = 0;
+  int top;
+  if(alt->action[0] == '\0') {
+    if(nSyms != 1) fail(alt->line, "Missing action", NULL);
+    actions[0] = (Action) { .kind = ACT_POS, .pos = 1 };
+    top = nActions++;
+  } else {
+    char* str = alt->action;
+    top = parseAction(&str, alt->line);
+    while(isspace(*str)) str++;
+    if(*str != '\0') fail(alt->line, "Unexpected text in action", str);
+  }
+
+  // every list must be used, and only at the start of a list action
+  int used[MAX_RHS] = { 0 };
+  for(int a = 0; a < nActions; a++) {
+    Action* act = &actions[a];
+    if(act->kind == ACT_POS) {
+      if(act->pos < 1 || act->pos > nSyms)
+        fail(alt->line, "Bad position in action", NULL);
+      used[act->pos - 1] = 1;
+    } else if(act->kind == ACT_LIST) {
+      for(int c = 1; c < act->nChildren; c++) {
+        Action* child = &actions[act->children[c]];
+        if(child->kind == ACT_POS && symbols[syms[child->pos - 1]].isList)
+          fail(alt->line, "A list can only be extended at its end", NULL);
+      }
+    }
+  }
+  for(int i = 0; i < nSyms; i++) {
+    if(!symbols[syms[i]].terminal && symbols[syms[i]].isList && !used[i])
+      fail(alt->line, "Unused list", symbols[syms[i]].name);
+  }
+
+  // tokens are referred to by their position in the stack of the parser,
+  // so they cannot be the value of a rule
+  Action* act = &actions[top];
+  if(act->kind == ACT_POS && symbols[syms[act->pos - 1]].terminal)
+    fail(alt->line, "A token must be put in a node", NULL);
+
+  // one rule for each combination of the optional groups
+  for(int mask = 0; mask < (1 << nGroups); mask++) {
+    if(nRules == MAX_RULES) fail(alt->line, "Too many rules", NULL);
+    Rule* rule = &rules[nRules++];
+    memset(rule, 0, sizeof(Rule));
+    rule->lhs = lhs;
+    rule->line = alt->line;
+
+    int posMap[MAX_RHS];
+    for(int i = 0; i < nSyms; i++) {
+      if(groups[i] >= 0 && !(mask & (1 << groups[i]))) {
+        posMap[i] = -1;
+      } else {
+        posMap[i] = rule->length;
+        rule->rhs[rule->length++] = syms[i];
+
+        if(symbols[syms[i]].terminal && symbols[syms[i]].prec)
+          rule->prec = symbols[syms[i]].prec;
+      }
+    }
+    if(precSym >= 0) rule->prec = symbols[precSym].prec;
+
+    rule->code = nCode;
+    emitAction(rule, top, posMap, 0, 0);
+    emit("PC_END");
+  }
+}
+
+int parseAction(char** str, int line) {
+  char* p = *str;
+  while(isspace(*p)) p++;
+
+  if(nActions == MAX_ACTION) fail(line, "Action too long", NULL);
+  int index = nActions++;
+  Action* act = &actions[index];
+  memset(act, 0, sizeof(Action));
+
+  if(isdigit(*p)) {
+    act->kind = ACT_POS;
+    act->pos = strtol(p, &p, 10);
+    *str = p;
+    return index;
+  }
+
+  char close;
+  if(*p == '[') {
+    act->kind = ACT_LIST;
+    close = ']';
+    p++;
+  } else if(isalpha(*p)) {
+    act->kind = ACT_NODE;
+    int len = 0;
+    while(isalnum(p[len])) len++;
+    if(len >= MAX_NAME) fail(line, "Node type too long", NULL);
+    memcpy(act->name, p, len);
+    act->name[len] = '\0';
+    p += len;
+    if(*p != '(') fail(line, "Missing '(' after", act->name);
+    close = ')';
+    p++;
+  } else fail(line, "Bad action", p);
+
+  while(1) {
+    while(isspace(*p)) p++;
+    if(*p == close) break;
+    if(*p == '\0') fail(line, "Unfinished action", NULL);
+
+    int child = parseAction(&p, line);
+    act = &actions[index];
+    if(act->nChildren == MAX_ACTION) fail(line, "Action too long", NULL);
+    act->children[act->nChildren++] = child;
+  }
+
+  *str = p + 1;
+  return index;
+}
+
+void emitAction(Rule* rule, int act, int* posMap, int inside, int depth) {
+  Action* a = &actions[act];
+  char text[MAX_NAME + 2];
+
+  if(depth + 1 > maxOperands) maxOperands = depth + 1;
+
+  if(a->kind == ACT_POS) {
+    int index = posMap[a->pos - 1];
+    if(index < 0) {
+      emit("PC_NONE");
+    } else {
+      emit("PC_VALUE");
+      sprintf(text, "%d", index);
+      emit(text);
+      if(inside && symbols[rule->rhs[index]].terminal) rule->nodes++;
+    }
+    return;
+  }
+
+  for(int c = 0; c < a->nChildren; c++)
+    emitAction(rule, a->children[c], posMap, 1, depth + c);
+
+  if(a->kind == ACT_NODE) {
+    emit("PC_NODE");
+    sprintf(text, "NT%s", a->name);
+    emit(text);
+    rule->nodes++;
+  } else emit("PC_LIST");
+
+  sprintf(text, "%d", a->nChildren);
+  emit(text);
+}
+
+void emit(char* text) {
+  if(nCode == MAX_CODE) fail(0, "Too much code for the rules", NULL);
+  code[nCode++] = strdup(text);
+}
+
+int listSymbol(char* name, int line) {
+  char listName[MAX_NAME + 1];
+  sprintf(listName, "%s*", name);
+
+  int list = findSymbol(listName);
+  if(list >= 0) return list;
+
+  int item = findSymbol(name);
+  if(item < 0 || symbols[item].terminal)
+    fail(line, "Only non-terminals can be repeated", name);
+
+  list = addSymbol(listName, 0);
+  symbols[list].isList = 1;
+
+  // NAME* := -> []   and   NAME* := NAME* NAME -> [1 2]
+  if(nRules + 2 > MAX_RULES) fail(line, "Too many rules", NULL);
+  rules[nRules++] = (Rule) {
+    .lhs = list, .length = 0, .code = nCode, .line = line
+  };
+  emit("PC_LIST");
+  emit("0");
+  emit("PC_END");
+
+  rules[nRules++] = (Rule) {
+    .lhs = list, .rhs = { list, item }, .length = 2, .code = nCode,
+    .nodes = symbols[item].terminal, .line = line
+  };
+  emit("PC_VALUE");
+  emit("0");
+  emit("PC_VALUE");
+  emit("1");
+  emit("PC_LIST");
+  emit("2");
+  emit("PC_END");
+  if(maxOperands < 2) maxOperands = 2;
+  return list;
+}
+
+void computeFirst() {
+  for(int i = 0; i < nSymbols; i++) {
+    if(symbols[i].terminal && symbols[i].column > 0) {
+      int col = symbols[i].column;
+      symbols[i].first[col / WORD_BITS] |= 1ULL << (col % WORD_BITS);
+    }
+  }
+
+  int changed = 1;
+  while(changed) {
+    changed = 0;
+    for(int r = 0; r < nRules; r++) {
+      Symbol* lhs = &symbols[rules[r].lhs];
+      TermSet first = { 0 };
+      int nullable = firstOfSequence(rules[r].rhs, rules[r].length, first);
+
+      if(setUnion(lhs->first, first)) changed = 1;
+      if(nullable && !lhs->nullable) {
+        lhs->nullable = 1;
+        changed = 1;
+      }
+    }
+  }
+}
+
+int firstOfSequence(int* syms, int n, TermSet set) {
+  for(int i = 0; i < n; i++) {
+    setUnion(set, symbols[syms[i]].first);
+    if(!symbols[syms[i]].nullable) return 0;
+  }
+  return 1;
+}
+
+int setUnion(TermSet dest, TermSet src) {
+  int changed = 0;
+  for(int w = 0; w < SET_WORDS; w++) {
+    unsigned long long old = dest[w];
+    dest[w] |= src[w];
+    if(dest[w] != old) changed = 1;
+  }
+  return changed;
+}
+
+void buildStates() {
+  int kernel = ITEM(0, 0);
+  findState(&kernel, 1);
+
+  for(int s = 0; s < nStates; s++) {
+    State* state = &states[s];
+    closure(state);
+
+    for(int x = 0; x < nSymbols; x++) {
+      int items[MAX_KERNEL];
+      int n = 0;
+
+      for(int k = 0; k < state->nKernel; k++) {
+        Rule* rule = &rules[ITEM_RULE(state->kernel[k])];
+        int dot = ITEM_DOT(state->kernel[k]);
+        if(dot < rule->length && rule->rhs[dot] == x) {
+          if(n == MAX_KERNEL) fail(0, "State too large", NULL);
+          items[n++] = state->kernel[k] + 1;
+        }
+      }
+      for(int r = 0; r < nRules; r++) {
+        if(ntIn[rules[r].lhs] && rules[r].length > 0 && rules[r].rhs[0] == x) {
+          if(n == MAX_KERNEL) fail(0, "State too large", NULL);
+          items[n++] = ITEM(r, 1);
+        }
+      }
+
+      if(n == 0) {
+        state->trans[x] = -1;
+        continue;
+      }
+
+      // sort the kernel (insertion sort, kernels are small)
+      for(int i = 1; i < n; i++) {
+        int item = items[i];
+        int j = i;
+        while(j > 0 && items[j - 1] > item) {
+          items[j] = items[j - 1];
+          j--;
+        }
+        items[j] = item;
+      }
+
+      state->trans[x] = findState(items, n);
+    }
+  }
+}
+
+void closure(State* state) {
+  memset(ntIn, 0, sizeof(ntIn));
+  memset(ntLa, 0, sizeof(ntLa));
+
+  for(int k = 0; k < state->nKernel; k++) {
+    Rule* rule = &rules[ITEM_RULE(state->kernel[k])];
+    int dot = ITEM_DOT(state->kernel[k]);
+    if(dot == rule->length || symbols[rule->rhs[dot]].terminal) continue;
+
+    int b = rule->rhs[dot];
+    ntIn[b] = 1;
+    if(firstOfSequence(&rule->rhs[dot + 1], rule->length - dot - 1, ntLa[b]))
+      setUnion(ntLa[b], state->la[k]);
+  }
+
+  int changed = 1;
+  while(changed) {
+    changed = 0;
+    for(int r = 0; r < nRules; r++) {
+      Rule* rule = &rules[r];
+      if(!ntIn[rule->lhs] || rule->length == 0) continue;
+      if(symbols[rule->rhs[0]].terminal) continue;
+
+      int c = rule->rhs[0];
+      if(!ntIn[c]) {
+        ntIn[c] = 1;
+        changed = 1;
+      }
+
+      TermSet la = { 0 };
+      if(firstOfSequence(&rule->rhs[1], rule->length - 1, la))
+        setUnion(la, ntLa[rule->lhs]);
+      if(setUnion(ntLa[c], la)) changed = 1;
+    }
+  }
+}
+
+int findState(int* kernel, int n) {
+  for(int s = 0; s < nStates; s++) {
+    if(states[s].nKernel == n &&
+       memcmp(states[s].kernel, kernel, n * sizeof(int)) == 0)
+      return s;
+  }
+
+  if(nStates == MAX_STATES) fail(0, "Too many states", NULL);
+  State* state = &states[nStates];
+  memset(state, 0, sizeof(State));
+  memcpy(state->kernel, kernel, n * sizeof(int));
+  state->nKernel = n;
+
+  // the initial state: $accept := . <start symbol>, at the end of the file
+  if(nStates == 0) state->la[0][0] = 1ULL << 1;
+  return nStates++;
+}
+
+void propagateLookaheads() {
+  int changed = 1;
+  while(changed) {
+    changed = 0;
+
+    for(int s = 0; s < nStates; s++) {
+      State* state = &states[s];
+      closure(state);
+
+      for(int x = 0; x < nSymbols; x++) {
+        if(state->trans[x] < 0) continue;
+        State* target = &states[state->trans[x]];
+
+        for(int k = 0; k < target->nKernel; k++) {
+          int item = target->kernel[k];
+          int r = ITEM_RULE(item);
+
+          if(ITEM_DOT(item) == 1 && ntIn[rules[r].lhs]) {
+            if(setUnion(target->la[k], ntLa[rules[r].lhs])) changed = 1;
+          }
+          for(int j = 0; j < state->nKernel; j++) {
+            if(state->kernel[j] == item - 1 &&
+               setUnion(target->la[k], state->la[j]))
+              changed = 1;
+          }
+        }
+      }
+    }
+  }
+}
+
+void buildTables() {
+  int conflicts = 0;
+
+  for(int s = 0; s < nStates; s++) {
+    State* state = &states[s];
+    closure(state);
+
+    for(int x = 0; x < nSymbols; x++) {
+      if(state->trans[x] < 0) continue;
+      if(symbols[x].terminal)
+        actionTable[s][symbols[x].column] = state->trans[x];
+      else gotoTable[s][symbols[x].number] = state->trans[x];
+    }
+
+    for(int k = 0; k < state->nKernel; k++) {
+      int r = ITEM_RULE(state->kernel[k]);
+      if(ITEM_DOT(state->kernel[k]) < rules[r].length) continue;
+
+      for(int col = 1; col < nColumns; col++) {
+        if(state->la[k][col / WORD_BITS] & (1ULL << (col % WORD_BITS)))
+          addReduction(s, col, r, &conflicts);
+      }
+    }
+    for(int r = 0; r < nRules; r++) {
+      if(!ntIn[rules[r].lhs] || rules[r].length > 0) continue;
+
+      for(int col = 1; col < nColumns; col++) {
+        if(ntLa[rules[r].lhs][col / WORD_BITS] & (1ULL << (col % WORD_BITS)))
+          addReduction(s, col, r, &conflicts);
+      }
+    }
+  }
+
+  if(conflicts != expected) {
+    fprintf(stderr, "%s: %d shift/reduce conflicts settled by shifting, "
+      "%d expected.\n", grammarFile, conflicts, expected);
+    exit(1);
+  }
+}
+
+void addReduction(int s, int col, int rule, int* conflicts) {
+  short action = actionTable[s][col];
+  Symbol* token = NULL;
+  for(int i = 0; i < nSymbols; i++)
+    if(symbols[i].terminal && symbols[i].column == col) token = &symbols[i];
+
+  if(action == 0 || action == -rule - 1) {
+    actionTable[s][col] = -rule - 1;
+    return;
+  }
+
+  if(action < 0) {
+    fprintf(stderr, "%s: reduce/reduce conflict in state %d on '%s':\n",
+      grammarFile, s, token->name);
+    printRule(stderr, -action - 1, rules[-action - 1].length);
+    printRule(stderr, rule, rules[rule].length);
+    exit(1);
+  }
+
+  // shift/reduce: settled by precedence, or by shifting
+  int rulePrec = rules[rule].prec;
+  if(rulePrec && token->prec) {
+    if(rulePrec > token->prec ||
+       (rulePrec == token->prec && token->assoc == ASSOC_LEFT))
+      actionTable[s][col] = -rule - 1;
+    return;
+  }
+
+  (*conflicts)++;
+  if(expected == 0) {
+    fprintf(stderr, "%s: shift/reduce conflict in state %d on '%s' "
+      "(shifting):\n", grammarFile, s, token->name);
+    printRule(stderr, rule, rules[rule].length);
+  }
+}
+
+void printRule(FILE* out, int rule, int dot) {
+  Rule* r = &rules[rule];
+  fprintf(out, "  %s :=", symbols[r->lhs].name);
+  for(int i = 0; i < r->length; i++) {
+    if(i == dot) fprintf(out, " .");
+    fprintf(out, " %s", symbols[r->rhs[i]].name);
+  }
+  if(dot == r->length) fprintf(out, " .");
+  fprintf(out, "   (line %d)\n", r->line);
+}
+
+void writeTables(char* cFile, char* hFile) {
+  FILE* out = fopen(hFile, "w");
+  if(!out) fail(0, "Cannot write", hFile);
+
+  fprintf(out,
+    "/*\n"
+    " *\n"
+    " *\n"
+    " * Parse tables of the LALR(1) parser. Generated by aux/lrgen from\n"
+    " * docs/grammar.txt: do not edit, change the grammar instead.\n"
+    " *\n"
+    " */\n\n"
+    "#ifndef PARSETABLES_H\n"
+    "#define PARSETABLES_H\n\n"
+    "#include \"parser.h\"\n\n"
+    "// Number of states of the parser\n"
+    "#define PARSE_STATES %d\n\n"
+    "// Number of columns of the ACTION table (0: tokens not in the grammar,\n"
+    "// 1: end of file)\n"
+    "#define PARSE_COLUMNS %d\n\n"
+    "// Number of non-terminals (columns of the GOTO table)\n"
+    "#define PARSE_NONTERMINALS %d\n\n"
+    "// Number of rules (0 accepts the program)\n"
+    "#define PARSE_RULES %d\n\n"
+    "// Maximum number of operands of the code of a rule\n"
+    "#define PARSE_MAX_OPERANDS %d\n\n"
+    "// Column of the ACTION table of each token type\n"
+    "extern const unsigned char parseColumn[N_TOKEN_TYPES];\n\n"
+    "// Token type of each column of the ACTION table\n"
+    "extern const short parseColumnToken[PARSE_COLUMNS];\n\n"
+    "// ACTION table: 0 is an error, s > 0 shifts the token and goes to state\n"
+    "// s, and r < 0 reduces rule -r - 1\n"
+    "extern const short parseAction[PARSE_STATES][PARSE_COLUMNS];\n\n"
+    "// GOTO table: state after reducing a rule of a non-terminal\n"
+    "extern const short parseGoto[PARSE_STATES][PARSE_NONTERMINALS];\n\n"
+    "// The rules of the grammar\n"
+    "extern const ParseRule parseRules[PARSE_RULES];\n\n"
+    "// The code of the rules (see ParseCode)\n"
+    "extern const short parseCode[];\n\n"
+    "#endif\n",
+    nStates, nColumns, nNonterminals, nRules, maxOperands);
+  fclose(out);
+
+  out = fopen(cFile, "w");
+  if(!out) fail(0, "Cannot write", cFile);
+
+  fprintf(out,
+    "/*\n"
+    " *\n"
+    " *\n"
+    " * Parse tables of the LALR(1) parser. Generated by aux/lrgen from\n"
+    " * docs/grammar.txt: do not edit, change the grammar instead.\n"
+    " *\n"
+    " */\n\n"
+    "#include \"parsetables.h\"\n\n");
+
+  fprintf(out, "const unsigned char parseColumn[N_TOKEN_TYPES] = {\n");
+  for(int col = 1; col < nColumns; col++) {
+    for(int i = 0; i < nSymbols; i++) {
+      if(symbols[i].terminal && symbols[i].column == col)
+        fprintf(out, "  [%s] = %d,\n", symbols[i].tokenType, col);
+    }
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "const short parseColumnToken[PARSE_COLUMNS] = {\n  TTUnknown");
+  for(int col = 1; col < nColumns; col++) {
+    for(int i = 0; i < nSymbols; i++) {
+      if(symbols[i].terminal && symbols[i].column == col)
+        fprintf(out, ",%s%s", col % 6 == 0 ? "\n  " : " ",
+          symbols[i].tokenType);
+    }
+  }
+  fprintf(out, "\n};\n\n");
+
+  fprintf(out, "const short parseAction[PARSE_STATES][PARSE_COLUMNS] = {\n");
+  for(int s = 0; s < nStates; s++) {
+    fprintf(out, "  {");
+    for(int col = 0; col < nColumns; col++) {
+      fprintf(out, "%s%d", col == 0 ? "" : (col % 16 == 0 ? ",\n   " : ", "),
+        actionTable[s][col]);
+    }
+    fprintf(out, "}%s\n", s + 1 < nStates ? "," : "");
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out,
+    "const short parseGoto[PARSE_STATES][PARSE_NONTERMINALS] = {\n");
+  for(int s = 0; s < nStates; s++) {
+    fprintf(out, "  {");
+    for(int nt = 0; nt < nNonterminals; nt++) {
+      fprintf(out, "%s%d", nt == 0 ? "" : (nt % 16 == 0 ? ",\n   " : ", "),
+        gotoTable[s][nt]);
+    }
+    fprintf(out, "}%s\n", s + 1 < nStates ? "," : "");
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "const ParseRule parseRules[PARSE_RULES] = {\n");
+  for(int r = 0; r < nRules; r++) {
+    fprintf(out, "  { %d, %d, %d, %d }%s  //", symbols[rules[r].lhs].number,
+      rules[r].length, rules[r].nodes, rules[r].code,
+      r + 1 < nRules ? "," : " ");
+    printRule(out, r, -1);
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "const short parseCode[] = {\n");
+  for(int r = 0; r < nRules; r++) {
+    int end = r + 1 < nRules ? rules[r + 1].code : nCode;
+    fprintf(out, "  ");
+    for(int c = rules[r].code; c < end; c++)
+      fprintf(out, "%s%s", code[c], c + 1 == nCode ? "" :
+        (c + 1 == end ? "," : ", "));
+    fprintf(out, "\n");
+  }
+  fprintf(out, "};\n");
+  fclose(out);
+
+  printf("%s: %d states, %d rules, %d columns, %d shift/reduce conflicts "
+    "settled by shifting.\n", grammarFile, nStates, nRules, nColumns,
+    expected);
+}
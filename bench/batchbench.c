@@ -0,0 +1,212 @@
+/*
+ *
+ *
+ * Batch compilation benchmark: compiles many small generated programs by
+ * launching one compiler process per program (one at a time, and one per
+ * thread at a time), and as a batch in a single process (with one thread,
+ * and with all of them), and compares their throughput.
+ *
+ * Usage: build/batchbench [-j<threads>] [number of programs]
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../src/batch.h"
+#include "../src/cli.h"
+#include "../src/threadpool.h"
+
+// Number of programs compiled by default
+#define N_PROGRAMS 1000
+
+// The compiler launched for each program
+#define COMPILER "build/ulpc"
+
+// Where the programs and their executables are written (mkdtemp replaces
+// the Xs)
+#define BENCH_DIR "/tmp/batchbench-XXXXXX"
+
+extern char** environ;
+
+// Functions in each generated program (the program number picks one). The
+// programs are straight-line code, which is what the code generator handles
+// best for now
+int functionCounts[] = { 1, 2, 4, 8, 16 };
+
+/*
+ * Returns the current time, in seconds.
+ *
+ */
+double now();
+
+/*
+ * Writes the generated programs and the list of them.
+ *
+ * dir: the directory where they are written.
+ * nPrograms: number of programs.
+ * returns: the name of the list (to be freed by the caller).
+ *
+ */
+char* writePrograms(char* dir, int nPrograms);
+
+/*
+ * Compiles each program in its own compiler process.
+ *
+ * dir: the directory of the programs.
+ * nPrograms: number of programs.
+ * nProcesses: number of processes running at the same time.
+ *
+ */
+void launchCompilers(char* dir, int nPrograms, int nProcesses);
+
+/*
+ * Prints the time taken to compile the programs one way.
+ *
+ * name: the way they were compiled.
+ * nPrograms: number of programs.
+ * elapsed: the time taken, in seconds.
+ *
+ */
+void report(char* name, int nPrograms, double elapsed);
+
+/*
+ * Removes the programs, their executables and the directory.
+ *
+ * dir: the directory.
+ * nPrograms: number of programs.
+ *
+ */
+void removePrograms(char* dir, int nPrograms);
+
+int main(int argc, char** argv) {
+  int nThreads = availableCores();
+  int nPrograms = N_PROGRAMS;
+
+  for(int i = 1; i < argc; i++) {
+    if(strncmp(argv[i], "-j", 2) == 0) nThreads = atoi(argv[i] + 2);
+    else nPrograms = atoi(argv[i]);
+  }
+  if(nThreads < 1) nThreads = 1;
+
+  char dir[] = BENCH_DIR;
+  if(!mkdtemp(dir)) {
+    fprintf(stderr, "Error creating the benchmark directory.\n");
+    return 1;
+  }
+  char* listName = writePrograms(dir, nPrograms);
+
+  double start = now();
+  launchCompilers(dir, nPrograms, 1);
+  report("processes, 1 at a time", nPrograms, now() - start);
+
+  char name[64];
+  if(nThreads > 1) {
+    start = now();
+    launchCompilers(dir, nPrograms, nThreads);
+    sprintf(name, "processes, %d at a time", nThreads);
+    report(name, nPrograms, now() - start);
+  }
+
+  struct stCli options = { .outputType = OUT_SILENT, .sourceIdx = -1,
+    .outputIdx = -1, .batchIdx = -1, .jobs = 1 };
+  Batch* batch = loadBatch(listName, &options);
+
+  start = now();
+  int nFailed = compileBatch(batch, 1);
+  report("batch, 1 thread", nPrograms, now() - start);
+
+  if(nThreads > 1) {
+    start = now();
+    nFailed += compileBatch(batch, nThreads);
+    sprintf(name, "batch, %d threads", nThreads);
+    report(name, nPrograms, now() - start);
+  }
+
+  if(nFailed > 0) printf("%d compilations failed\n", nFailed);
+  closeBatch(batch);
+  removePrograms(dir, nPrograms);
+  free(listName);
+  return 0;
+}
+
+char* writePrograms(char* dir, int nPrograms) {
+  char* listName = (char*) malloc(strlen(dir) + 16);
+  sprintf(listName, "%s/list", dir);
+  FILE* list = fopen(listName, "w");
+
+  for(int i = 0; i < nPrograms; i++) {
+    char name[64];
+    sprintf(name, "%s/p%d.ul", dir, i);
+    fprintf(list, "%s\n", name);
+
+    FILE* program = fopen(name, "w");
+    int nFunctions = functionCounts[i % 5];
+    for(int f = 0; f < nFunctions; f++) {
+      fprintf(program, "fn f%d => {\n  int a = %d;\n"
+        "  int b = a * 2 + 1;\n  int c = b %% 7 - a;\n"
+        "  return b + c * 3;\n}\n", f, i + f);
+    }
+    fprintf(program, "int total = 0;\n");
+    for(int f = 0; f < nFunctions; f++)
+      fprintf(program, "total += f%d();\n", f);
+    fclose(program);
+  }
+
+  fclose(list);
+  return listName;
+}
+
+void launchCompilers(char* dir, int nPrograms, int nProcesses) {
+  int nRunning = 0;
+
+  for(int i = 0; i < nPrograms || nRunning > 0; ) {
+    if(i < nPrograms && nRunning < nProcesses) {
+      char source[64], output[64];
+      sprintf(source, "%s/p%d.ul", dir, i);
+      sprintf(output, "%s/p%d", dir, i);
+      char* argv[] = { COMPILER, "-s", source, "-o", output, NULL };
+
+      pid_t pid;
+      if(posix_spawn(&pid, COMPILER, NULL, NULL, argv, environ) != 0) {
+        fprintf(stderr, "Error running " COMPILER ".\n");
+        exit(1);
+      }
+      nRunning++;
+      i++;
+    } else {
+      int status;
+      if(wait(&status) > 0) nRunning--;
+    }
+  }
+}
+
+void report(char* name, int nPrograms, double elapsed) {
+  printf("%s: %d programs, %.3f s, %.0f programs/s\n", name, nPrograms,
+    elapsed, nPrograms / elapsed);
+}
+
+void removePrograms(char* dir, int nPrograms) {
+  char name[64];
+  for(int i = 0; i < nPrograms; i++) {
+    sprintf(name, "%s/p%d.ul", dir, i);
+    unlink(name);
+    sprintf(name, "%s/p%d", dir, i);
+    unlink(name);
+  }
+  sprintf(name, "%s/list", dir);
+  unlink(name);
+  rmdir(dir);
+}
+
+double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
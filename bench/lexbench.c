@@ -0,0 +1,157 @@
+/*
+ *
+ *
+ * Lexer microbenchmark: measures how many identifier/keyword tokens per
+ * second the lexer processes, both for the keyword classifier alone and for
+ * a whole lexer run over an in-memory source. Source files given as
+ * arguments are also lexed and timed, serially and in parallel.
+ *
+ * Usage: build/lexbench [-j<threads>] [source files]
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/cli.h"
+#include "../src/lexer.h"
+#include "../src/source.h"
+#include "../src/threadpool.h"
+
+// Number of words in the generated source
+#define N_WORDS 2000000
+
+// Number of times the keyword classifier goes over all the words
+#define CLASSIFY_ROUNDS 10
+
+// Words used to build the benchmark source: keywords, identifiers that
+// look like keywords, and ordinary identifiers of several lengths
+char* words[] = {
+  "if", "or", "fn", "and", "for", "int", "not", "bool", "else", "next",
+  "loop", "true", "break", "float", "while", "match", "false", "string",
+  "return", "x", "i", "id", "of", "fun", "ints", "iff", "loops", "truth",
+  "format", "value", "counter", "returned", "total_sum", "_tmp", "node2",
+  "whiles", "index", "strings", "buffer_size", "matchAll"
+};
+
+/*
+ * Returns the current time, in seconds.
+ *
+ */
+double now();
+
+/*
+ * Generates a source made of random words separated by spaces and line
+ * breaks.
+ *
+ * nWords: number of words to generate.
+ * returns: the generated source (not NUL terminated, like loaded sources).
+ *
+ */
+SourceFile* generateSource(int nWords);
+
+/*
+ * Lexes a whole source and prints the lexer throughput.
+ *
+ * source: the source to be lexed.
+ * nThreads: threads used by the lexer (1 to use lexerStart).
+ *
+ */
+void timeLexer(SourceFile* source, int nThreads);
+
+int main(int argc, char** argv) {
+  cli.outputType = OUT_SILENT;
+  int nThreads = availableCores();
+
+  SourceFile* source = generateSource(N_WORDS);
+
+  // Keyword classifier alone, over the slices of the lexed words
+  lexerStart(source);
+  int nTokens = lexerState.nTokens;
+  Token* tokens = lexerState.tokens;
+
+  long nKeywords = 0;
+  double start = now();
+  for(int round = 0; round < CLASSIFY_ROUNDS; round++) {
+    for(int i = 0; i < nTokens; i++) {
+      Token* token = &tokens[i];
+      nKeywords += keywordType(source->data + token->start,
+        token->nameSize) != TTId;
+    }
+  }
+  double elapsed = now() - start;
+  printf("keywordType: %d words x %d, %ld keywords, %.1f M words/s\n",
+    nTokens, CLASSIFY_ROUNDS, nKeywords,
+    (double) nTokens * CLASSIFY_ROUNDS / elapsed / 1e6);
+  free(tokens);
+
+  // Whole lexer run
+  timeLexer(source, 1);
+  closeSource(source);
+
+  for(int i = 1; i < argc; i++) {
+    if(strncmp(argv[i], "-j", 2) == 0) {
+      nThreads = atoi(argv[i] + 2);
+      continue;
+    }
+
+    source = loadSource(argv[i]);
+    if(!source) {
+      fprintf(stderr, "Could not read %s.\n", argv[i]);
+      return 1;
+    }
+    timeLexer(source, 1);
+    if(nThreads > 1) timeLexer(source, nThreads);
+    closeSource(source);
+  }
+
+  return 0;
+}
+
+void timeLexer(SourceFile* source, int nThreads) {
+  double start = now();
+  if(nThreads > 1) lexerStartParallel(source, nThreads);
+  else lexerStart(source);
+  double elapsed = now() - start;
+
+  printf("%s: %s: %d tokens, %.1f MB, %.3f s, %.1f M tokens/s\n",
+    nThreads > 1 ? "lexerStartParallel" : "lexerStart",
+    source->filename, lexerState.nTokens, source->size / 1e6, elapsed,
+    lexerState.nTokens / elapsed / 1e6);
+  free(lexerState.tokens);
+}
+
+double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+SourceFile* generateSource(int nWords) {
+  int nChoices = sizeof(words) / sizeof(words[0]);
+  long maxSize = 16;
+  for(int i = 0; i < nChoices; i++) {
+    if(strlen(words[i]) + 1 > (size_t) maxSize) maxSize = strlen(words[i]) + 1;
+  }
+  maxSize *= nWords;
+
+  SourceFile* source = (SourceFile*) malloc(sizeof(SourceFile));
+  source->filename = "<lexbench>";
+  source->data = (char*) malloc(maxSize);
+  source->size = 0;
+  source->mapped = 0;
+
+  srand(42);
+  for(int i = 0; i < nWords; i++) {
+    char* word = words[rand() % nChoices];
+    int size = strlen(word);
+    memcpy(source->data + source->size, word, size);
+    source->size += size;
+    source->data[source->size++] = (i % 8 == 7) ? '\n' : ' ';
+  }
+
+  return source;
+}
@@ -0,0 +1,135 @@
+/*
+ *
+ *
+ * Parser microbenchmark: measures how many tokens per second the parser
+ * processes (building the AST), over tokens already lexed. The source is a
+ * generated program with functions, declarations, loops and expressions;
+ * source files given as arguments are also parsed and timed.
+ *
+ * Usage: build/parsebench [source files]
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/arena.h"
+#include "../src/ast.h"
+#include "../src/cli.h"
+#include "../src/lexer.h"
+#include "../src/parser.h"
+#include "../src/source.h"
+
+// Number of functions in the generated source
+#define N_FUNCTIONS 40000
+
+// Number of times each source is parsed (the best time is reported)
+#define PARSE_ROUNDS 5
+
+// Function repeated in the generated source (%d is replaced by its number)
+char* function =
+  "fn f%d int a, int b => {\n"
+  "  int c = a + b * 2;\n"
+  "  int d = (c - a) / 3 + a % 7;\n"
+  "  if c > 10 and d <= 4: c = c - 1;\n"
+  "  else c += d * (a - 3);\n"
+  "  while d < 100: {\n"
+  "    d += 3;\n"
+  "    c = -c + d * d - f0(c, d + 1);\n"
+  "  }\n"
+  "  print c, d;\n"
+  "  d++;\n"
+  "  return c + d;\n"
+  "}\n"
+  "int g%d = f%d(1, 2);\n";
+
+/*
+ * Returns the current time, in seconds.
+ *
+ */
+double now();
+
+/*
+ * Generates a source made of copies of a function.
+ *
+ * nFunctions: number of functions to generate.
+ * returns: the generated source (not NUL terminated, like loaded sources).
+ *
+ */
+SourceFile* generateSource(int nFunctions);
+
+/*
+ * Lexes a whole source, parses its tokens several times and prints the
+ * parser throughput.
+ *
+ * source: the source to be parsed.
+ *
+ */
+void timeParser(SourceFile* source);
+
+int main(int argc, char** argv) {
+  cli.outputType = OUT_SILENT;
+  arenaInit(&compArena, 0);
+
+  SourceFile* source = generateSource(N_FUNCTIONS);
+  timeParser(source);
+  closeSource(source);
+
+  for(int i = 1; i < argc; i++) {
+    source = loadSource(argv[i]);
+    if(!source) {
+      fprintf(stderr, "Could not read %s.\n", argv[i]);
+      return 1;
+    }
+    timeParser(source);
+    closeSource(source);
+  }
+
+  return 0;
+}
+
+void timeParser(SourceFile* source) {
+  lexerStart(source);
+  double best = 0;
+  int nNodes = 0;
+
+  for(int round = 0; round < PARSE_ROUNDS; round++) {
+    double start = now();
+    parserStart(source, lexerState.nTokens, lexerState.tokens);
+    double elapsed = now() - start;
+
+    if(round == 0 || elapsed < best) best = elapsed;
+    nNodes = compAst.nNodes;
+    arenaReset(&compArena);
+  }
+
+  printf("parserStart: %s: %d tokens, %d nodes, %.3f s, "
+    "%.1f M tokens/s\n", source->filename, lexerState.nTokens, nNodes,
+    best, lexerState.nTokens / best / 1e6);
+  free(lexerState.tokens);
+}
+
+double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+SourceFile* generateSource(int nFunctions) {
+  long maxSize = (strlen(function) + 40) * (long) nFunctions;
+
+  SourceFile* source = (SourceFile*) malloc(sizeof(SourceFile));
+  source->filename = "<parsebench>";
+  source->data = (char*) malloc(maxSize);
+  source->size = 0;
+  source->mapped = 0;
+
+  for(int i = 0; i < nFunctions; i++) {
+    source->size += sprintf(source->data + source->size, function, i, i, i);
+  }
+
+  return source;
+}
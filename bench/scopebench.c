@@ -0,0 +1,134 @@
+/*
+ *
+ *
+ * Scope checker microbenchmark: measures how the scope checker scales with
+ * the number of declarations in a scope. Generated programs declare many
+ * global variables, many functions, or many local variables in a single
+ * function, each one using the previous declaration.
+ *
+ * Usage: build/scopebench
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/arena.h"
+#include "../src/ast.h"
+#include "../src/cli.h"
+#include "../src/lexer.h"
+#include "../src/parser.h"
+#include "../src/scoper.h"
+#include "../src/source.h"
+
+// Number of times each program is checked (the best time is reported)
+#define SCOPE_ROUNDS 3
+
+// A shape of generated program: the code before the declarations, each
+// declaration (%d are replaced by its number and the previous one) and the
+// code after them
+typedef struct stProgramShape {
+  char* name;
+  char* head;
+  char* declaration;
+  char* tail;
+} ProgramShape;
+
+ProgramShape shapes[] = {
+  { "globals", "int g0 = 1;\n", "int g%d = g%d + 1;\n", "" },
+  { "functions", "fn f0 int a => return a;\n",
+    "fn f%d int a => return f%d(a);\n", "" },
+  { "locals", "fn main => {\n  int v0 = 1;\n", "  int v%d = v%d + 1;\n",
+    "}\n" }
+};
+
+// Numbers of declarations of the generated programs
+int sizes[] = { 1000, 10000, 100000 };
+
+/*
+ * Returns the current time, in seconds.
+ *
+ */
+double now();
+
+/*
+ * Generates a program with a number of declarations.
+ *
+ * shape: the shape of the program.
+ * nDeclarations: number of declarations.
+ * returns: the generated source (not NUL terminated, like loaded sources).
+ *
+ */
+SourceFile* generateSource(ProgramShape* shape, int nDeclarations);
+
+/*
+ * Parses a source and times the scope checker over its AST.
+ *
+ * source: the source to be checked.
+ * nDeclarations: number of declarations in the source.
+ *
+ */
+void timeScoper(SourceFile* source, int nDeclarations);
+
+int main() {
+  cli.outputType = OUT_SILENT;
+  arenaInit(&compArena, 0);
+
+  for(size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+    for(size_t j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+      SourceFile* source = generateSource(&shapes[i], sizes[j]);
+      source->filename = shapes[i].name;
+      timeScoper(source, sizes[j]);
+      closeSource(source);
+    }
+  }
+
+  return 0;
+}
+
+void timeScoper(SourceFile* source, int nDeclarations) {
+  lexerStart(source);
+  parserStart(source, lexerState.nTokens, lexerState.tokens);
+  double best = 0;
+
+  // the symbol tables of each round are left in the arena
+  for(int round = 0; round < SCOPE_ROUNDS; round++) {
+    double start = now();
+    scopeCheckerStart(source, parserState.ast);
+    double elapsed = now() - start;
+
+    if(round == 0 || elapsed < best) best = elapsed;
+  }
+
+  printf("scopeCheckerStart: %d %s, %.4f s, %.2f M declarations/s\n",
+    nDeclarations, source->filename, best, nDeclarations / best / 1e6);
+  free(lexerState.tokens);
+  arenaReset(&compArena);
+}
+
+double now() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+SourceFile* generateSource(ProgramShape* shape, int nDeclarations) {
+  long maxSize = strlen(shape->head) + strlen(shape->tail) + 1
+    + (strlen(shape->declaration) + 20) * (long) nDeclarations;
+
+  SourceFile* source = (SourceFile*) malloc(sizeof(SourceFile));
+  source->data = (char*) malloc(maxSize);
+  source->size = sprintf(source->data, "%s", shape->head);
+  source->mapped = 0;
+
+  for(int i = 1; i < nDeclarations; i++) {
+    source->size += sprintf(source->data + source->size, shape->declaration,
+      i, i - 1);
+  }
+  source->size += sprintf(source->data + source->size, "%s", shape->tail);
+
+  return source;
+}
@@ -2,333 +2,1154 @@
  *
  *
  * This file contains the code for architecture-dependent (x86) code
- * generation, especially functions that generate x86 nasm code.
+ * generation, especially functions that write the instructions as x86 nasm
+ * code or encode them as machine code.
  *
  */
+
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include "codegen.h"
 #include "util.h"
 #include "scoper.h"
+#include "ast.h"
+#include "arena.h"
+#include "intern.h"
+#include "cli.h"
+#include "xgen.h"
+#include "incremental.h"
 
+// Length of the text of an instruction, not counting the names (of
+// variables and functions) and literals of its operands
 #define MAX_INSTRUCTION_LEN 300
 
+// Numbers of the registers in the machine code (r8 to r15 are 8 to 15)
+#define REG_AX 0
+#define REG_CX 1
+#define REG_DX 2
+#define REG_BX 3
+#define REG_SP 4
+#define REG_BP 5
+#define REG_SI 6
+#define REG_DI 7
+
+// Initial size of the tables of labels, calls and jumps of the encoder
+#define INITIAL_ENCODER_TABLE 256
+
+__thread EncoderState encoderState;
+
+// Text of each instruction, indexed by InstructionType: %1 and %2 stand for
+// its first and second operand
+char* instructionTemplates[] = {
+  [INS_LABEL] = "%1:\n",
+  [INS_GLOBAL] = "global %1\n",
+  [INS_EXTERN] = "extern %1\n",
+  [INS_SYSCALL] = "syscall\n",
+  [INS_SECTION] = "section .%1\n",
+  [INS_DIVISION] = "mov eax, %1\ncdq\nidiv %2\n",
+  [INS_GETQUOTIENT] = "mov %1, eax\n",
+  [INS_GETREMAINDER] = "mov %1, edx\n",
+  [INS_EXIT] = "mov eax, 60\nmov edi, %1\nsyscall\n",
+  [INS_PROLOGUE] = "push rbp\nmov rbp, rsp\n"
+    "push rbx\npush r12\npush r13\npush r14\npush r15\n",
+  [INS_PROLOGUE_STACK] = "push rbp\nmov rbp, rsp\nsub rsp, %1\n"
+    "push rbx\npush r12\npush r13\npush r14\npush r15\n",
+  [INS_EPILOGUE] = ".epilogue:\n"
+    "pop r15\npop r14\npop r13\npop r12\npop rbx\n"
+    "mov rsp, rbp\npop rbp\nret\n",
+  [INS_SETRET] = "mov eax, %1\n",
+  [INS_GETRET] = "mov %1, eax\n",
+  [INS_RESERVE] = "%1: res%2 1\n",
+  [INS_MOV] = "mov %1, %2\n",
+  [INS_ADD] = "add %1, %2\n",
+  [INS_SUB] = "sub %1, %2\n",
+  [INS_NOP] = "nop\n",
+  [INS_INC] = "inc %1\n",
+  [INS_DEC] = "dec %1\n",
+  [INS_NEG] = "neg %1\n",
+  [INS_NOT] = "not %1\n",
+  [INS_RET] = "ret\n",
+  [INS_CALL] = "call %1\n",
+  [INS_AND] = "and %1, %2\n",
+  [INS_OR] = "or %1, %2\n",
+  [INS_XOR] = "xor %1, %2\n",
+  [INS_MUL] = "mul %1\n",
+  [INS_IMUL] = "imul %1, %2\n",
+  [INS_CMP] = "cmp %1, %2\n",
+  [INS_JMP] = "jmp %1\n",
+  [INS_JZ] = "jz %1\n",
+  [INS_JNZ] = "jnz %1\n",
+  [INS_JG] = "jg %1\n",
+  [INS_JGE] = "jge %1\n",
+  [INS_JE] = "je %1\n",
+  [INS_JNE] = "jne %1\n",
+  [INS_JL] = "jl %1\n",
+  [INS_JLE] = "jle %1\n",
+  [INS_PUSH] = "push %1\n",
+  [INS_POP] = "pop %1\n"
+};
+
+// Names of the registers of the arguments, by position
+char* argRegNames[] = { "edi", "esi", "edx", "ecx", "r8d", "r9d" };
+
+// Size prefixes of memory operands, and reserve directives of globals, by
+// size in bytes
+char* sizeNames[] = {
+  "", "byte ", "word ", "", "dword ", "", "", "", "qword " };
+char* reserveNames[] = { "", "b", "w", "", "d", "", "", "", "q" };
+
+// Numbers of the general purpose registers (named in initializeRegisters)
+// and of the registers of the arguments, in the machine code
+char gprCodes[N_GPR] = { REG_BX, 10, 11, 12, 13, 14, 15 };
+char argRegCodes[] = { REG_DI, REG_SI, REG_DX, REG_CX, 8, 9 };
+
+// Registers saved by the prologue of the functions, in the order they are
+// pushed
+char savedRegCodes[] = { REG_BX, 12, 13, 14, 15 };
+
+// Opcode extensions of the arithmetic instructions: the opcode with a
+// register source is 8 times the extension plus 1, and with a register
+// destination, plus 3
+char arithmeticCodes[] = {
+  [INS_ADD] = 0, [INS_OR] = 1, [INS_AND] = 4, [INS_SUB] = 5, [INS_XOR] = 6,
+  [INS_CMP] = 7
+};
+
+// Condition codes of the conditional jumps
+char conditionCodes[] = {
+  [INS_JZ] = 0x4, [INS_JNZ] = 0x5, [INS_JG] = 0xF, [INS_JGE] = 0xD,
+  [INS_JE] = 0x4, [INS_JNE] = 0x5, [INS_JL] = 0xC, [INS_JLE] = 0xE
+};
+
+/*
+ * Writes the text of an instruction.
+ *
+ * ins: the instruction.
+ * out: where to write it, with room for MAX_INSTRUCTION_LEN characters plus
+ *   the names in its operands (see nameSize).
+ * returns: the number of characters written (a NUL follows them).
+ *
+ */
+int formatInstruction(Instruction* ins, char* out);
+
+/*
+ * Writes the text of an operand.
+ *
+ * op: the operand.
+ * out: where to write it.
+ * returns: a pointer to the end of the text written.
+ *
+ */
+char* formatOperand(Operand* op, char* out);
+
+/*
+ * Writes a number in decimal.
+ *
+ * value: the number.
+ * out: where to write it.
+ * returns: a pointer to the end of the text written.
+ *
+ */
+char* formatNumber(long value, char* out);
+
+/*
+ * Tells how long the name (of a variable or function) or literal in an
+ * operand is.
+ *
+ * op: the operand.
+ * returns: the number of characters of the name, 0 if it has none.
+ *
+ */
+int nameSize(Operand* op);
+
+/*
+ * Encodes an instruction as machine code, at the end of the code being
+ * written.
+ *
+ * ins: the instruction.
+ *
+ */
+void encodeInstruction(Instruction* ins);
+
+/*
+ * Encodes a mov between registers, memory and immediates.
+ *
+ * dst: the destination operand.
+ * src: the source operand.
+ *
+ */
+void encodeMove(Operand* dst, Operand* src);
+
+/*
+ * Encodes a mov of an operand to a given register.
+ *
+ * reg: the number of the register.
+ * src: the source operand.
+ *
+ */
+void encodeLoad(int reg, Operand* src);
+
+/*
+ * Encodes an arithmetic instruction (add, sub, and, or, xor or cmp).
+ *
+ * extension: the opcode extension of the instruction (see arithmeticCodes).
+ * dst: the destination operand.
+ * src: the source operand.
+ *
+ */
+void encodeArithmetic(int extension, Operand* dst, Operand* src);
+
+/*
+ * Encodes an instruction with a register (or opcode extension) and a
+ * register or memory operand: its prefix, opcode, ModRM byte and
+ * displacement.
+ *
+ * opcode: the opcode (two bytes if it is greater than 0xFF).
+ * reg: the number of the register, or the opcode extension.
+ * rm: the register or memory operand.
+ * wide: whether the operation is on 64 bits.
+ * immSize: size of the immediate that follows the instruction, in bytes.
+ *
+ */
+void encodeModRM(int opcode, int reg, Operand* rm, char wide, int immSize);
+
+/*
+ * Encodes an instruction with two registers.
+ *
+ * opcode: the opcode (two bytes if it is greater than 0xFF).
+ * reg: the number of the register (or the opcode extension) in the reg
+ *   field of the ModRM byte.
+ * rm: the number of the register in the rm field.
+ * wide: whether the operation is on 64 bits.
+ *
+ */
+void encodeRegisters(int opcode, int reg, int rm, char wide);
+
+/*
+ * Encodes the REX prefix of an instruction, if it needs one.
+ *
+ * wide: whether the operation is on 64 bits.
+ * reg: the number of the register in the reg field of the ModRM byte.
+ * rm: the number of the register in the rm field (or in the opcode).
+ *
+ */
+void encodeRex(char wide, int reg, int rm);
+
+/*
+ * Encodes the opcode of an instruction.
+ *
+ * opcode: the opcode (two bytes if it is greater than 0xFF).
+ *
+ */
+void encodeOpcode(int opcode);
+
+/*
+ * Encodes a push or a pop of a 64-bit register.
+ *
+ * opcode: the opcode of the instruction with the register 0.
+ * reg: the number of the register.
+ *
+ */
+void encodePushPop(int opcode, int reg);
+
+/*
+ * Encodes a jump to a local label. Jumps back are short when they can be,
+ * and jumps forward are filled in once the code of the function is encoded.
+ *
+ * condition: the condition code of the jump (-1 for jmp).
+ * label: the label operand.
+ *
+ */
+void encodeJump(int condition, Operand* label);
+
+/*
+ * Encodes a call to a function, which is filled in at the end if the
+ * function comes later in the code.
+ *
+ * name: the name operand of the function.
+ *
+ */
+void encodeCall(Operand* name);
+
+/*
+ * Gives a label the address of the end of the code being written.
+ *
+ * label: the operand of the label (a local label, or a name).
+ *
+ */
+void defineLabel(Operand* label);
+
+/*
+ * Reserves room for a global variable, after the previous ones.
+ *
+ * nameId: the id of its name.
+ * size: its size in bytes.
+ *
+ */
+void reserveGlobal(int nameId, int size);
+
+/*
+ * Fills in the jumps forward of the code being written.
+ *
+ */
+void resolveJumps();
+
+/*
+ * Writes the symbols and relocations of an object file (-c), after its
+ * machine code.
+ *
+ */
+void writeObjectSymbols();
+
+/*
+ * Leaves a 32-bit displacement of an object file to the linker.
+ *
+ * offset: where it is, from the start of the machine code.
+ * nameId: the id of the name it refers to.
+ * addend: added to the address of the name.
+ *
+ */
+void addObjectRelocation(long offset, int nameId, long addend);
+
+/*
+ * Gets the address of a local label.
+ *
+ * label: the number of the label, or LABEL_EPILOGUE.
+ * returns: its address, -1 if it is not defined yet.
+ *
+ */
+long labelAddress(long label);
+
+/*
+ * Gets the number of a register operand.
+ *
+ * op: the operand.
+ * returns: the number of its register, -1 if it is not a register.
+ *
+ */
+int registerCode(Operand* op);
+
+/*
+ * Tells whether an operand is 64 bits wide.
+ *
+ * op: the operand.
+ * returns: 1 if it is wide, 0 otherwise.
+ *
+ */
+char isWide(Operand* op);
+
+/*
+ * Tells whether an operand is an immediate (a number or a literal).
+ *
+ * op: the operand.
+ * returns: 1 if it is an immediate, 0 otherwise.
+ *
+ */
+char isImmediate(Operand* op);
+
+/*
+ * Gets the value of an immediate operand. String literals are packed in a
+ * number, like nasm does; as with nasm, a 32-bit operand keeps only their
+ * first 4 characters.
+ *
+ * op: the operand.
+ * returns: the value.
+ *
+ */
+long immediateValue(Operand* op);
+
+/*
+ * Gets the address of the end of the machine code being written.
+ *
+ */
+long currentAddress();
+
+/*
+ * Appends a byte to the machine code.
+ *
+ * byte: the byte.
+ *
+ */
+void emitByte(int byte);
+
+/*
+ * Appends a 32-bit number (little endian) to the machine code.
+ *
+ * value: the number (only its lowest 32 bits are used).
+ *
+ */
+void emitInt32(long value);
+
+/*
+ * Overwrites a 32-bit number of the machine code, whether it was already
+ * written to the file or not.
+ *
+ * offset: where the number is, from the start of the machine code.
+ * value: the number.
+ *
+ */
+void patchCode(long offset, long value);
+
+/*
+ * Adds a fixup to a table of fixups.
+ *
+ * fixups: the table.
+ * nFixups: number of fixups in the table.
+ * maxFixups: allocated size of the table.
+ * offset: where the displacement to be filled in is.
+ * target: what it refers to.
+ *
+ */
+void addFixup(Fixup** fixups, int* nFixups, int* maxFixups, long offset,
+              long target);
+
+/*
+ * Grows a table of the encoder to hold a number of elements.
+ *
+ * table: the table (its address is updated).
+ * elemSize: size of each element.
+ * needed: number of elements needed.
+ * maxSize: allocated number of elements (it is updated).
+ *
+ */
+void growTable(void** table, size_t elemSize, int needed, int* maxSize);
+
 void initializeRegisters() {
   const char gprSize = N_GPR;
   codegenState.nGPR = N_GPR;
-  codegenState.busyRegisters = (char*) malloc(sizeof(char) * N_GPR);
-  codegenState.nameGPR = (char**) malloc(sizeof(char*) * N_GPR);
+  codegenState.busyRegisters = (char*) arenaAlloc(&compArena,
+    sizeof(char) * N_GPR);
+  codegenState.nameGPR = (char**) arenaAlloc(&compArena,
+    sizeof(char*) * N_GPR);
 
   char* regNames[N_GPR] = {
     "ebx", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d" };
 
   for(int i = 0; i < codegenState.nGPR; i++) {
     codegenState.busyRegisters[i] = 0;
-    codegenState.nameGPR[i] = (char*) malloc(sizeof(char) * 5);
-    strcpy(codegenState.nameGPR[i], regNames[i]);
+    codegenState.nameGPR[i] = arenaStrdup(&compArena, regNames[i]);
   }
 }
 
-char* getArgRegName(short argPos) {
-  char* reg = (char*) malloc(sizeof(char) * 4);
+Operand getArgReg(short argPos) {
+  if(argPos > 5) genericError("Code generation error: too many parameters");
+  return makeOperand(OPD_ARG, argPos);
+}
+
+Operand getSymbolRef(Symbol* sym) {
+  if(sym->type == STGlobal) return makeOperand(OPD_GLOBAL, sym->id);
+
+  // the slot in the stack frame was given by the scope checker
+  if(sym->type == STLocal || sym->type == STArg)
+    return makeOperand(OPD_STACK, sym->pos);
+
+  return noOperand;
+}
+
+Operand getSymbolSizeRef(Symbol* sym) {
+  // TODO for now the size is fixed. Should be decided according to data type.
+  Operand ref = getSymbolRef(sym);
+  ref.size = 4;
+  return ref;
+}
+
+void declareGlobalVar(Node* node, int nameId, char size) {
+  appendInstruction(node, INS_RESERVE, makeOperand(OPD_NAME, nameId),
+    makeOperand(OPD_IMM, size));
+}
+
+void initializeEncoder() {
+  // the sections of an object file are placed by the linker
+  encoderState = (EncoderState) {
+    .codeAddress = cli.object ? 0 : EXEC_BASE_ADDRESS,
+    .bssAddress = cli.object ? 0 : EXEC_BASE_ADDRESS,
+    .bssSize = 0,
+    .entry = -1,
+    .nameAddresses = (long*) arenaAlloc(&compArena,
+      sizeof(long) * interner.nNames),
+    .nameFlags = (char*) arenaAlloc(&compArena, interner.nNames),
+    .labelAddresses = NULL,
+    .maxLabels = 0,
+    .epilogueAddress = -1,
+    .calls = NULL,
+    .nCalls = 0,
+    .maxCalls = 0,
+    .jumps = NULL,
+    .nJumps = 0,
+    .maxJumps = 0,
+    .relocations = NULL,
+    .nRelocations = 0,
+    .maxRelocations = 0
+  };
 
-  switch(argPos) {
-    case 0: sprintf(reg, "edi"); break;
-    case 1: sprintf(reg, "esi"); break;
-    case 2: sprintf(reg, "edx"); break;
-    case 3: sprintf(reg, "ecx"); break;
-    case 4: sprintf(reg, "r8d"); break;
-    case 5: sprintf(reg, "r9d"); break;
-    default: genericError("Code generation error: too many parameters");
+  for(int i = 0; i < interner.nNames; i++) encoderState.nameAddresses[i] = -1;
+  memset(encoderState.nameFlags, 0, interner.nNames);
+}
+
+void finishMachineCode() {
+  for(int i = 0; i < encoderState.nCalls; i++) {
+    Fixup* call = &encoderState.calls[i];
+    long target = encoderState.nameAddresses[call->target];
+
+    // functions of other objects are called through the linker
+    if(target < 0 && (encoderState.nameFlags[call->target] & NAME_EXTERNAL)) {
+      if(!cli.object)
+        genericError("Code generation error: external functions need -c.");
+      addObjectRelocation(call->offset, call->target, -4);
+      continue;
+    }
+    if(target < 0)
+      genericError("Code generation error: call to an undefined function.");
+
+    patchCode(call->offset,
+      target - (encoderState.codeAddress + call->offset + 4));
   }
-  return reg;
-}
-
-char* getSymbolRef(Symbol* sym, Node* node) {
-  // TODO: free strings returned by this function
-  if(sym->type == STGlobal) {
-    char* ref = (char*) malloc(sizeof(char) * (sym->token->nameSize + 10));
-    sprintf(ref, "[rel %s]", sym->token->name);
-    return ref;
-  } else if(sym->type == STLocal) {
-    Node* scopeNode = getImmediateScope(node);
-    if(!scopeNode) genericError("Code generation bug: missing AST scope node");
-    if(!scopeNode->symTable) {
-      genericError("Code generation bug: AST scope node without symbol table");
+
+  if(cli.object) writeObjectSymbols();
+  else writeExecHeaders(codegenState.outFd, encoderState.entry,
+    codegenState.outWritten, encoderState.bssSize);
+  releaseEncoder();
+}
+
+void writeObjectSymbols() {
+  ObjectSymbol* symbols = (ObjectSymbol*) arenaAlloc(&compArena,
+    sizeof(ObjectSymbol) * (interner.nNames + 1));
+  int* symbolIndex = (int*) arenaAlloc(&compArena,
+    sizeof(int) * interner.nNames);
+  int nSymbols = 0;
+
+  // the global variables and the functions not exported are local
+  for(int i = 0; i < interner.nNames; i++) {
+    char flags = encoderState.nameFlags[i];
+    long address = encoderState.nameAddresses[i];
+    symbolIndex[i] = -1;
+    if(address < 0 && !(flags & NAME_EXTERNAL)) continue;
+
+    ObjectSymbol* symbol = &symbols[nSymbols];
+    *symbol = (ObjectSymbol) { .name = internedName(i), .value = address };
+    if(flags & NAME_VARIABLE) symbol->section = OBJECT_BSS;
+    else if(address >= 0) {
+      symbol->section = OBJECT_TEXT;
+      symbol->global = (flags & NAME_EXPORTED) != 0;
+    } else {
+      symbol->section = OBJECT_UNDEFINED;
+      symbol->value = 0;
+      symbol->global = 1;
     }
+    symbolIndex[i] = nSymbols++;
+  }
+
+  if(encoderState.entry >= 0) {
+    symbols[nSymbols++] = (ObjectSymbol) { .name = "_start",
+      .value = encoderState.entry, .section = OBJECT_TEXT, .global = 1 };
+  }
 
-    int pos = scopeNode->symTable->nStackVarsAcc -
-      scopeNode->symTable->nLocalVars + sym->pos;
-
-    char* ref = (char*) malloc(sizeof(char) * (sym->token->nameSize + 10));
-    sprintf(ref, "[rbp - %d]", pos * 4);  // TODO: fixed size 4
-    return ref;
-  } else if(sym->type == STArg) {
-    int pos = sym->pos;
-    char* ref = (char*) malloc(sizeof(char) * (sym->token->nameSize + 10));
-    sprintf(ref, "[rbp - %d]", pos * 4);  // TODO: fixed size 4
-    return ref;
+  for(int i = 0; i < encoderState.nRelocations; i++) {
+    ObjectRelocation* relocation = &encoderState.relocations[i];
+    relocation->symbol = symbolIndex[relocation->symbol];
   }
-  return NULL;
+
+  writeObjectHeaders(codegenState.outFd, codegenState.outWritten,
+    encoderState.bssSize, symbols, nSymbols, encoderState.relocations,
+    encoderState.nRelocations);
 }
 
-char* getSymbolSizeRef(Symbol* sym, Node* node) {
-  // TODO for now the size is fixed. Should be decided according to data type.
-  char* ref = getSymbolRef(sym, node);
-  if(!ref) return NULL;
+void addObjectRelocation(long offset, int nameId, long addend) {
+  growTable((void**) &encoderState.relocations, sizeof(ObjectRelocation),
+    encoderState.nRelocations + 1, &encoderState.maxRelocations);
+  encoderState.relocations[encoderState.nRelocations++] = (ObjectRelocation) {
+    .offset = offset, .symbol = nameId, .addend = addend
+  };
+}
+
+void releaseEncoder() {
+  free(encoderState.labelAddresses);
+  free(encoderState.calls);
+  free(encoderState.jumps);
+  free(encoderState.relocations);
+  encoderState.labelAddresses = NULL;
+  encoderState.calls = NULL;
+  encoderState.jumps = NULL;
+  encoderState.relocations = NULL;
+  encoderState.maxLabels = encoderState.maxCalls = encoderState.maxJumps = 0;
+  encoderState.nRelocations = encoderState.maxRelocations = 0;
+}
+
+void writeBlocks(BasicBlock* blocks) {
+  for(BasicBlock* block = blocks; block; block = block->next) {
+    Instruction* ins = block->first;
+
+    for(int i = 0; i < block->nInstructions; i++, ins = ins->next) {
+      int room = MAX_INSTRUCTION_LEN + nameSize(&ins->op1)
+        + nameSize(&ins->op2);
+
+      if(codegenState.outSize + room > OUTPUT_BUFFER_SIZE) {
+        flushCode();
+        if(room > OUTPUT_BUFFER_SIZE)
+          genericError("Code generation error: name too long.");
+      }
+
+      if(!codegenState.native) {
+        codegenState.outSize +=
+          formatInstruction(ins, codegenState.out + codegenState.outSize);
+        continue;
+      }
+
+      // the assembly code is still shown in debug mode
+      if(cli.outputType <= OUT_DEBUG) {
+        char* text = (char*) malloc(sizeof(char) * (room + 1));
+        formatInstruction(ins, text);
+        printf("%s", text);
+        free(text);
+      }
+      encodeInstruction(ins);
+    }
+    codegenState.nBlocks++;
+  }
+
+  if(codegenState.native) resolveJumps();
+}
+
+void writeFunctionCode(CachedFunction* function, int nameId, int* names) {
+  if(codegenState.outSize + function->size > OUTPUT_BUFFER_SIZE) flushCode();
+
+  long start = codegenState.outWritten + codegenState.outSize;
+  defineLabel(&(Operand) { .type = OPD_NAME, .value = nameId });
 
-  char* sizeRef = (char*) malloc(
-    sizeof(char) * (strlen(ref) + strlen("dword ") + 2));
+  for(int done = 0; done < function->size; ) {
+    int size = function->size - done;
+    if(size > OUTPUT_BUFFER_SIZE - codegenState.outSize)
+      size = OUTPUT_BUFFER_SIZE - codegenState.outSize;
 
-  sprintf(sizeRef, "dword %s", ref);
-  free(ref);
-  return sizeRef;
+    memcpy(codegenState.out + codegenState.outSize, function->code + done,
+      size);
+    codegenState.outSize += size;
+    done += size;
+    if(codegenState.outSize == OUTPUT_BUFFER_SIZE) flushCode();
+  }
+
+  // the calls to functions not written yet are filled in at the end
+  for(int i = 0; i < function->nRelocations; i++) {
+    Relocation* relocation = &function->relocations[i];
+    long offset = start + relocation->offset;
+    int target = names[relocation->name];
+    long address = encoderState.nameAddresses[target];
+
+    if(address >= 0) {
+      patchCode(offset, address
+        - (encoderState.codeAddress + offset + 4 + relocation->immSize));
+    } else {
+      addFixup(&encoderState.calls, &encoderState.nCalls,
+        &encoderState.maxCalls, offset, target);
+    }
+  }
+}
+
+void flushCode() {
+  if(cli.outputType <= OUT_DEBUG && !codegenState.native)
+    printf("%.*s", codegenState.outSize, codegenState.out);
+
+  writeOutput(codegenState.outFd, codegenState.out, codegenState.outSize);
+  codegenState.outWritten += codegenState.outSize;
+  codegenState.outSize = 0;
 }
 
-void declareGlobalVar(Node* node, char* varName, char size) {
-  appendNodeCode(node, varName);
-  appendNodeCode(node, ": ");
+int formatInstruction(Instruction* ins, char* out) {
+  char* start = out;
+
+  for(char* t = instructionTemplates[ins->type]; *t; t++) {
+    if(*t != '%') {
+      *out++ = *t;
+      continue;
+    }
+
+    Operand* op = (*++t == '1') ? &ins->op1 : &ins->op2;
+    if(op->type == OPD_NONE)
+      genericError("Code generation bug: empty instruction operand.");
 
-  switch(size) {
-    case 1: appendNodeCode(node, "resb"); break;
-    case 2: appendNodeCode(node, "resw"); break;
-    case 4: appendNodeCode(node, "resd"); break;
-    case 8: appendNodeCode(node, "resq"); break;
+    if(ins->type == INS_RESERVE && op == &ins->op2) {
+      // the size of the global, as the letter of its directive
+      out = stpcpy(out, reserveNames[op->value]);
+    }
+    else out = formatOperand(op, out);
   }
-  appendNodeCode(node, " 1\n");
+
+  *out = '\0';
+  return out - start;
 }
 
-void appendInstruction(Node* node, InstructionType inst, char* op1, char* op2) {
-//  if(!node->cgData) createCgData(node);
+char* formatOperand(Operand* op, char* out) {
+  switch(op->type) {
+    case OPD_REG: return stpcpy(out, codegenState.nameGPR[op->value]);
+    case OPD_ARG: return stpcpy(out, argRegNames[op->value]);
+    case OPD_FP: return stpcpy(out, "rbp");
+    case OPD_SP: return stpcpy(out, "rsp");
+    case OPD_STACK:
+      out = stpcpy(out, sizeNames[(int) op->size]);
+      out = stpcpy(out, "[rbp - ");
+      out = formatNumber(op->value * 4, out);  // TODO: fixed size 4
+      return stpcpy(out, "]");
+    case OPD_GLOBAL:
+      out = stpcpy(out, sizeNames[(int) op->size]);
+      out = stpcpy(out, "[rel ");
+      out = stpcpy(out, internedName(op->value));
+      return stpcpy(out, "]");
+    case OPD_NAME: return stpcpy(out, internedName(op->value));
+    case OPD_ENTRY: return stpcpy(out, "_start");
+    case OPD_IMM: return formatNumber(op->value, out);
+    case OPD_LITERAL: {
+      Token* token = &compAst.tokens[op->value];
+      memcpy(out, tokenText(codegenState.source, token), token->nameSize);
+      return out + token->nameSize;
+    }
+    case OPD_LABEL:
+      if(op->value == LABEL_EPILOGUE) return stpcpy(out, ".epilogue");
+      return formatNumber(op->value, stpcpy(out, ".l"));
+    case OPD_SECTION:
+      return stpcpy(out, op->value == SECTION_BSS ? "bss" : "text");
+  }
+
+  genericError("Code generation bug: invalid operand.");
+  return out;
+}
 
-  char instructionStr[MAX_INSTRUCTION_LEN];
-  char* fmt;
+char* formatNumber(long value, char* out) {
+  char digits[24];
+  int n = 0;
+  unsigned long u = (value < 0) ? -(unsigned long) value :
+    (unsigned long) value;
 
-  switch(inst) {
-    case INS_MOV:
-      if(!op1 || !op2)
-        genericError("Code generation bug: empty instruction operand for MOV.");
-      fmt = "mov %s, %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+  do {
+    digits[n++] = '0' + u % 10;
+    u /= 10;
+  } while(u);
+
+  if(value < 0) *out++ = '-';
+  while(n > 0) *out++ = digits[--n];
+  return out;
+}
+
+int nameSize(Operand* op) {
+  switch(op->type) {
+    case OPD_GLOBAL:
+    case OPD_NAME:
+      return interner.names[op->value].size;
+    case OPD_LITERAL:
+      return compAst.tokens[op->value].nameSize;
+    default:
+      return 0;
+  }
+}
+
+void encodeInstruction(Instruction* ins) {
+  Operand* op1 = &ins->op1;
+  Operand* op2 = &ins->op2;
+  Operand fp = makeOperand(OPD_FP, 0);
+  Operand sp = makeOperand(OPD_SP, 0);
+
+  switch(ins->type) {
+    case INS_LABEL:
+      defineLabel(op1);
       break;
-    case INS_ADD:
-      if(!op1 || !op2)
-        genericError("Code generation bug: empty instruction operand for ADD.");
-      fmt = "add %s, %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+    case INS_GLOBAL:  // the entry point goes in the ELF header
+      if(op1->type == OPD_NAME)
+        encoderState.nameFlags[op1->value] |= NAME_EXPORTED;
       break;
-    case INS_SUB:
-      if(!op1 || !op2)
-        genericError("Code generation bug: empty instruction operand for SUB.");
-      fmt = "sub %s, %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+    case INS_EXTERN:
+      encoderState.nameFlags[op1->value] |= NAME_EXTERNAL;
       break;
-    case INS_IMUL:
-      if(!op1 || !op2) genericError(
-          "Code generation bug: empty instruction operand for IMUL.");
-      fmt = "imul %s, %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+    case INS_SECTION:
+      // the code goes after the global variables, all reserved by now
+      // (the linker places the code of an object file)
+      if(op1->value == SECTION_TEXT && !cli.object)
+        encoderState.codeAddress = execCodeAddress(encoderState.bssSize);
+      break;
+    case INS_RESERVE:
+      reserveGlobal(op1->value, op2->value);
+      break;
+    case INS_SYSCALL:
+      encodeOpcode(0x0F05);
       break;
     case INS_DIVISION:
-      if(!op1 || !op2) genericError(
-          "Code generation bug: empty instruction operand for DIVISION.");
-      fmt = "mov eax, %s\ncdq\nidiv %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+      encodeLoad(REG_AX, op1);
+      emitByte(0x99);  // cdq
+      encodeModRM(0xF7, 7, op2, 0, 0);  // idiv
       break;
     case INS_GETQUOTIENT:
-      if(!op1) genericError(
-          "Code generation bug: empty instruction operand for GET QUOTIENT.");
-      fmt = "mov %s, eax\n";
-      sprintf(instructionStr, fmt, op1);
+    case INS_GETRET:
+      encodeModRM(0x89, REG_AX, op1, 0, 0);
       break;
     case INS_GETREMAINDER:
-      if(!op1) genericError(
-          "Code generation bug: empty instruction operand for GET REMAINDER.");
-      fmt = "mov %s, edx\n";
-      sprintf(instructionStr, fmt, op1);
+      encodeModRM(0x89, REG_DX, op1, 0, 0);
+      break;
+    case INS_SETRET:
+      encodeLoad(REG_AX, op1);
       break;
     case INS_EXIT:
-      if(!op1) genericError(
-          "Code generation bug: empty instruction operand for EXIT.");
-      fmt = "mov eax, 60\nmov edi, %s\nsyscall\n";
-      sprintf(instructionStr, fmt, op1);
+      encodeLoad(REG_AX, &(Operand) { .type = OPD_IMM, .value = 60 });
+      encodeLoad(REG_DI, op1);
+      encodeOpcode(0x0F05);
       break;
-    case INS_AND:
-      if(!op1 || !op2)
-        genericError("Code generation bug: empty instruction operand for AND.");
-      fmt = "and %s, %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+    case INS_PROLOGUE:
+    case INS_PROLOGUE_STACK:
+      encodePushPop(0x50, REG_BP);
+      encodeMove(&fp, &sp);
+      if(ins->type == INS_PROLOGUE_STACK) encodeArithmetic(5, &sp, op1);
+      for(size_t i = 0; i < sizeof(savedRegCodes); i++)
+        encodePushPop(0x50, savedRegCodes[i]);
       break;
-    case INS_OR:
-      if(!op1 || !op2)
-        genericError("Code generation bug: empty instruction operand for OR.");
-      fmt = "or %s, %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+    case INS_EPILOGUE:
+      defineLabel(&(Operand) { .type = OPD_LABEL, .value = LABEL_EPILOGUE });
+      for(int i = sizeof(savedRegCodes) - 1; i >= 0; i--)
+        encodePushPop(0x58, savedRegCodes[i]);
+      encodeMove(&sp, &fp);
+      encodePushPop(0x58, REG_BP);
+      emitByte(0xC3);
+      break;
+    case INS_MOV:
+      encodeMove(op1, op2);
       break;
+    case INS_ADD:
+    case INS_SUB:
+    case INS_AND:
+    case INS_OR:
+    case INS_XOR:
     case INS_CMP:
-      if(!op1 || !op2)
-        genericError("Code generation bug: empty instruction operand for CMP.");
-      fmt = "cmp %s, %s\n";
-      sprintf(instructionStr, fmt, op1, op2);
+      encodeArithmetic(arithmeticCodes[ins->type], op1, op2);
+      break;
+    case INS_NOP:
+      emitByte(0x90);
       break;
     case INS_INC:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for INC.");
-      fmt = "inc %s\n";
-      sprintf(instructionStr, fmt, op1);
+      encodeModRM(0xFF, 0, op1, isWide(op1), 0);
       break;
     case INS_DEC:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for DEC.");
-      fmt = "dec %s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_NEG:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for NEG.");
-      fmt = "neg %s\n";
-      sprintf(instructionStr, fmt, op1);
+      encodeModRM(0xFF, 1, op1, isWide(op1), 0);
       break;
     case INS_NOT:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for NOT.");
-      fmt = "not %s\n";
-      sprintf(instructionStr, fmt, op1);
+      encodeModRM(0xF7, 2, op1, isWide(op1), 0);
       break;
-    case INS_JMP:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JMP.");
-      fmt = "jmp %s\n";
-      sprintf(instructionStr, fmt, op1);
+    case INS_NEG:
+      encodeModRM(0xF7, 3, op1, isWide(op1), 0);
       break;
-    case INS_JZ:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JZ.");
-      fmt = "jz %s\n";
-      sprintf(instructionStr, fmt, op1);
+    case INS_MUL:
+      encodeModRM(0xF7, 4, op1, isWide(op1), 0);
       break;
-    case INS_JNZ:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JNZ.");
-      fmt = "jnz %s\n";
-      sprintf(instructionStr, fmt, op1);
+    case INS_RET:
+      emitByte(0xC3);
       break;
-    case INS_JE:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JE.");
-      fmt = "je %s\n";
-      sprintf(instructionStr, fmt, op1);
+    case INS_CALL:
+      encodeCall(op1);
       break;
-    case INS_JNE:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JNE.");
-      fmt = "jne %s\n";
-      sprintf(instructionStr, fmt, op1);
+    case INS_IMUL:
+      if(registerCode(op1) < 0 || isImmediate(op2))
+        genericError("Code generation bug: invalid operands.");
+      encodeModRM(0x0FAF, registerCode(op1), op2,
+        isWide(op1) || isWide(op2), 0);
       break;
-    case INS_JG:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JG.");
-      fmt = "jg %s\n";
-      sprintf(instructionStr, fmt, op1);
+    case INS_JMP:
+      encodeJump(-1, op1);
       break;
+    case INS_JZ:
+    case INS_JNZ:
+    case INS_JG:
     case INS_JGE:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JGE.");
-      fmt = "jge %s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
+    case INS_JE:
+    case INS_JNE:
     case INS_JL:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JL.");
-      fmt = "jl %s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
     case INS_JLE:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for JLE.");
-      fmt = "jle %s\n";
-      sprintf(instructionStr, fmt, op1);
+      encodeJump(conditionCodes[ins->type], op1);
       break;
     case INS_PUSH:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for PUSH.");
-      fmt = "push %s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
     case INS_POP:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for POP.");
-      fmt = "pop %s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_CALL:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for CALL.");
-      fmt = "call %s\n";
-      sprintf(instructionStr, fmt, op1);
+      if(registerCode(op1) < 0)
+        genericError("Code generation bug: invalid operands.");
+      encodePushPop(ins->type == INS_PUSH ? 0x50 : 0x58, registerCode(op1));
       break;
-    case INS_GLOBAL:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for GLOBAL.");
-      fmt = "global %s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_LABEL:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for LABEL.");
-      fmt = "%s:\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_SECTION:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for SECTION.");
-      fmt = "section .%s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_SETRET:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for SET RETURN.");
-      fmt = "mov eax, %s\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_GETRET:
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for GET RETURN.");
-      fmt = "mov %s, eax\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_PROLOGUE_STACK: // prologue with stack space allocation
-      if(!op1) genericError(
-        "Code generation bug: empty instruction operand for PROLOGUE.");
-      fmt = "push rbp\nmov rbp, rsp\nsub rsp, %s\n"
-        "push rbx\npush r12\npush r13\npush r14\npush r15\n";
-      sprintf(instructionStr, fmt, op1);
-      break;
-    case INS_PROLOGUE:
-      strcpy(instructionStr, "push rbp\nmov rbp, rsp\n"
-        "push rbx\npush r12\npush r13\npush r14\npush r15\n");
+  }
+}
+
+void encodeMove(Operand* dst, Operand* src) {
+  char wide = isWide(dst) || isWide(src);
+  int dstReg = registerCode(dst);
+
+  if(isImmediate(src)) {
+    long value = immediateValue(src);
+
+    if(dstReg >= 0 && !wide) {
+      encodeRex(0, 0, dstReg);
+      emitByte(0xB8 + (dstReg & 7));
+    }
+    else encodeModRM(0xC7, 0, dst, wide, 4);
+    emitInt32(value);
+  }
+  else if(registerCode(src) >= 0)
+    encodeModRM(0x89, registerCode(src), dst, wide, 0);
+  else if(dstReg >= 0) encodeModRM(0x8B, dstReg, src, wide, 0);
+  else genericError("Code generation bug: invalid operands.");
+}
+
+void encodeLoad(int reg, Operand* src) {
+  if(isImmediate(src)) {
+    encodeRex(0, 0, reg);
+    emitByte(0xB8 + (reg & 7));
+    emitInt32(immediateValue(src));
+  }
+  else encodeModRM(0x8B, reg, src, 0, 0);
+}
+
+void encodeArithmetic(int extension, Operand* dst, Operand* src) {
+  char wide = isWide(dst) || isWide(src);
+
+  if(isImmediate(src)) {
+    long value = immediateValue(src);
+
+    if(value >= -128 && value <= 127) {
+      encodeModRM(0x83, extension, dst, wide, 1);
+      emitByte(value);
+    } else {
+      encodeModRM(0x81, extension, dst, wide, 4);
+      emitInt32(value);
+    }
+  }
+  else if(registerCode(src) >= 0)
+    encodeModRM(extension * 8 + 1, registerCode(src), dst, wide, 0);
+  else if(registerCode(dst) >= 0)
+    encodeModRM(extension * 8 + 3, registerCode(dst), src, wide, 0);
+  else genericError("Code generation bug: invalid operands.");
+}
+
+void encodeModRM(int opcode, int reg, Operand* rm, char wide, int immSize) {
+  int rmReg = registerCode(rm);
+  if(rmReg >= 0) {
+    encodeRegisters(opcode, reg, rmReg, wide);
+    return;
+  }
+
+  encodeRex(wide, reg, 0);
+  encodeOpcode(opcode);
+
+  if(rm->type == OPD_STACK) { // [rbp - disp]
+    long disp = -rm->value * 4;  // TODO: fixed size 4, as in formatOperand
+
+    if(disp >= -128) {
+      emitByte(0x45 | (reg & 7) << 3);
+      emitByte(disp);
+    } else {
+      emitByte(0x85 | (reg & 7) << 3);
+      emitInt32(disp);
+    }
+  } else if(rm->type == OPD_GLOBAL) { // [rel name]
+    long target = encoderState.nameAddresses[rm->value];
+    if(target < 0) genericError("Code generation bug: undefined global.");
+
+    emitByte(0x05 | (reg & 7) << 3);
+    long offset = codegenState.outWritten + codegenState.outSize;
+    if(incrementalState.enabled) addRelocation(offset, rm->value, immSize);
+
+    // in an object file, the linker places the global variables
+    if(cli.object) {
+      addObjectRelocation(offset, rm->value, -4 - immSize);
+      emitInt32(0);
+    } else emitInt32(target - (currentAddress() + 4 + immSize));
+  }
+  else genericError("Code generation bug: invalid operands.");
+}
+
+void encodeRegisters(int opcode, int reg, int rm, char wide) {
+  encodeRex(wide, reg, rm);
+  encodeOpcode(opcode);
+  emitByte(0xC0 | (reg & 7) << 3 | (rm & 7));
+}
+
+void encodeRex(char wide, int reg, int rm) {
+  int rex = 0x40 | wide << 3 | (reg >= 8) << 2 | (rm >= 8);
+  if(rex != 0x40) emitByte(rex);
+}
+
+void encodeOpcode(int opcode) {
+  if(opcode > 0xFF) emitByte(opcode >> 8);
+  emitByte(opcode & 0xFF);
+}
+
+void encodePushPop(int opcode, int reg) {
+  encodeRex(0, 0, reg);
+  emitByte(opcode + (reg & 7));
+}
+
+void encodeJump(int condition, Operand* label) {
+  if(label->type != OPD_LABEL)
+    genericError("Code generation bug: invalid operands.");
+
+  long target = labelAddress(label->value);
+  if(target >= 0 && target - (currentAddress() + 2) >= -128) {
+    emitByte(condition < 0 ? 0xEB : 0x70 + condition);
+    emitByte(target - (currentAddress() + 1));
+    return;
+  }
+
+  encodeOpcode(condition < 0 ? 0xE9 : 0x0F80 + condition);
+  if(target >= 0) emitInt32(target - (currentAddress() + 4));
+  else {
+    addFixup(&encoderState.jumps, &encoderState.nJumps,
+      &encoderState.maxJumps, codegenState.outWritten + codegenState.outSize,
+      label->value);
+    emitInt32(0);
+  }
+}
+
+void encodeCall(Operand* name) {
+  if(name->type != OPD_NAME)
+    genericError("Code generation bug: invalid operands.");
+
+  emitByte(0xE8);
+  if(incrementalState.enabled) addRelocation(codegenState.outWritten
+    + codegenState.outSize, name->value, 0);
+  long target = encoderState.nameAddresses[name->value];
+  if(target >= 0) emitInt32(target - (currentAddress() + 4));
+  else {
+    addFixup(&encoderState.calls, &encoderState.nCalls,
+      &encoderState.maxCalls, codegenState.outWritten + codegenState.outSize,
+      name->value);
+    emitInt32(0);
+  }
+}
+
+void defineLabel(Operand* label) {
+  switch(label->type) {
+    case OPD_NAME:
+    case OPD_ENTRY:
+      if(label->type == OPD_NAME)
+        encoderState.nameAddresses[label->value] = currentAddress();
+      else encoderState.entry = currentAddress();
+
+      // a new function, with its own epilogue (like the local labels of
+      // nasm, that belong to the last name)
+      encoderState.epilogueAddress = -1;
       break;
-    case INS_EPILOGUE:
-      strcpy(instructionStr, ".epilogue:\n"
-        "pop r15\npop r14\npop r13\npop r12\npop rbx\n"
-        "mov rsp, rbp\npop rbp\nret\n");
+    case OPD_LABEL:
+      if(label->value == LABEL_EPILOGUE) {
+        encoderState.epilogueAddress = currentAddress();
+        break;
+      }
+
+      if(label->value >= encoderState.maxLabels) {
+        int oldMax = encoderState.maxLabels;
+        growTable((void**) &encoderState.labelAddresses, sizeof(long),
+          label->value + 1, &encoderState.maxLabels);
+        for(int i = oldMax; i < encoderState.maxLabels; i++)
+          encoderState.labelAddresses[i] = -1;
+      }
+      encoderState.labelAddresses[label->value] = currentAddress();
       break;
-    case INS_NOP: strcpy(instructionStr, "nop\n"); break;
-    case INS_SYSCALL: strcpy(instructionStr, "syscall\n"); break;
-    case INS_RET: strcpy(instructionStr, "ret\n"); break;
+    default:
+      genericError("Code generation bug: invalid operands.");
   }
+}
 
-  appendNodeCode(node, instructionStr);
+void reserveGlobal(int nameId, int size) {
+  // aligned to its size
+  encoderState.bssSize = (encoderState.bssSize + size - 1) / size * size;
+  encoderState.nameAddresses[nameId] = encoderState.bssAddress
+    + encoderState.bssSize;
+  encoderState.nameFlags[nameId] |= NAME_VARIABLE;
+  encoderState.bssSize += size;
 }
 
-void appendNodeCode(Node* node, char* text) {
-  if(strlen(node->cgData->code) + strlen(text) + 10
-     > node->cgData->maxCode) {
-    node->cgData->maxCode *= 2;
-    node->cgData->maxCode += strlen(text);
-    node->cgData->code = (char*) realloc(node->cgData->code,
-      sizeof(char) * node->cgData->maxCode);
+void resolveJumps() {
+  for(int i = 0; i < encoderState.nJumps; i++) {
+    Fixup* jump = &encoderState.jumps[i];
+    long target = labelAddress(jump->target);
+    if(target < 0)
+      genericError("Code generation error: jump to an undefined label.");
+
+    patchCode(jump->offset,
+      target - (encoderState.codeAddress + jump->offset + 4));
   }
+  encoderState.nJumps = 0;
+}
+
+long labelAddress(long label) {
+  if(label == LABEL_EPILOGUE) return encoderState.epilogueAddress;
+  if(label < 0 || label >= encoderState.maxLabels) return -1;
+  return encoderState.labelAddresses[label];
+}
+
+int registerCode(Operand* op) {
+  switch(op->type) {
+    case OPD_REG: return gprCodes[op->value];
+    case OPD_ARG: return argRegCodes[op->value];
+    case OPD_FP: return REG_BP;
+    case OPD_SP: return REG_SP;
+    default: return -1;
+  }
+}
+
+char isWide(Operand* op) {
+  return op->type == OPD_FP || op->type == OPD_SP || op->size == 8;
+}
+
+char isImmediate(Operand* op) {
+  return op->type == OPD_IMM || op->type == OPD_LITERAL;
+}
+
+long immediateValue(Operand* op) {
+  if(op->type == OPD_IMM) return op->value;
+
+  Token* token = &compAst.tokens[op->value];
+  char* text = tokenText(codegenState.source, token);
+  if(token->type != TTLitString)
+    genericError("Code generation error: unsupported literal.");
+
+  // the characters between the quotes, the first one in the lowest byte (the
+  // ones past the 4th do not fit, and nasm drops them with a warning)
+  int size = token->nameSize - 2 < 4 ? token->nameSize - 2 : 4;
+  long value = 0;
+  for(int i = size; i >= 1; i--)
+    value = value << 8 | (unsigned char) text[i];
+  return value;
+}
+
+long currentAddress() {
+  return encoderState.codeAddress + codegenState.outWritten
+    + codegenState.outSize;
+}
+
+void emitByte(int byte) {
+  codegenState.out[codegenState.outSize++] = byte;
+}
+
+void emitInt32(long value) {
+  for(int i = 0; i < 4; i++) emitByte(value >> (8 * i));
+}
+
+void patchCode(long offset, long value) {
+  char bytes[4];
+  for(int i = 0; i < 4; i++) bytes[i] = value >> (8 * i);
+
+  if(offset >= codegenState.outWritten) {
+    memcpy(codegenState.out + (offset - codegenState.outWritten), bytes, 4);
+  } else {
+    writeOutputAt(codegenState.outFd, bytes, 4, codeOffset() + offset);
+  }
+}
+
+void addFixup(Fixup** fixups, int* nFixups, int* maxFixups, long offset,
+              long target) {
+  growTable((void**) fixups, sizeof(Fixup), *nFixups + 1, maxFixups);
+  (*fixups)[(*nFixups)++] = (Fixup) { .offset = offset, .target = target };
+}
+
+void growTable(void** table, size_t elemSize, int needed, int* maxSize) {
+  if(needed <= *maxSize) return;
+
+  int newSize = *maxSize > 0 ? *maxSize : INITIAL_ENCODER_TABLE;
+  while(newSize < needed) newSize *= 2;
 
-  strcat(node->cgData->code, text);
+  *table = realloc(*table, elemSize * newSize);
+  if(!*table) genericError("Out of memory.");
+  *maxSize = newSize;
 }
@@ -0,0 +1,172 @@
+/*
+ *
+ *
+ * Arena allocator. Blocks are reserved with mmap, doubling in size as the
+ * arena grows, so a compilation uses a handful of blocks.
+ *
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "arena.h"
+#include "compiler.h"
+
+// Size of the first block of an arena
+#define INITIAL_BLOCK_SIZE (1024 * 1024)
+
+// Blocks do not grow beyond this size (unless a single allocation needs it)
+#define MAX_BLOCK_SIZE (64 * 1024 * 1024)
+
+// Size of the pages of memory (blocks are multiples of it)
+#define PAGE_SIZE 4096
+
+// Size of the huge pages (blocks are aligned to it when using them)
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Alignment of every allocation (enough for the pointers and integers the
+// compiler stores)
+#define ARENA_ALIGNMENT 8
+
+// Rounds a size up to a multiple of a power of 2
+#define ROUND_UP(size, multiple) \
+  (((size) + (multiple) - 1) & ~((size_t) (multiple) - 1))
+
+__thread Arena compArena = { .current = NULL, .blockSize = INITIAL_BLOCK_SIZE,
+  .hugePages = 0 };
+
+/*
+ * Reserves a new block for an arena and makes it the current block.
+ *
+ * arena: the arena that needs a new block.
+ * minSize: the block must have room for at least this many bytes.
+ *
+ */
+void newArenaBlock(Arena* arena, size_t minSize);
+
+/*
+ * Returns the memory of a block to the system.
+ *
+ * block: the block to be released.
+ *
+ */
+void releaseArenaBlock(ArenaBlock* block);
+
+void arenaInit(Arena* arena, char hugePages) {
+  arena->current = NULL;
+  arena->blockSize = INITIAL_BLOCK_SIZE;
+  arena->hugePages = hugePages;
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+  ArenaBlock* block = arena->current;
+  size = ROUND_UP(size, ARENA_ALIGNMENT);
+
+  if(!block || block->size - block->used < size) {
+    newArenaBlock(arena, size);
+    block = arena->current;
+  }
+
+  block->last = block->used;
+  block->used += size;
+  return block->data + block->last;
+}
+
+void* arenaRealloc(Arena* arena, void* ptr, size_t oldSize, size_t newSize) {
+  if(!ptr) return arenaAlloc(arena, newSize);
+
+  ArenaBlock* block = arena->current;
+  newSize = ROUND_UP(newSize, ARENA_ALIGNMENT);
+
+  // the last allocation of the block can grow (or shrink) in place
+  if(block && (char*) ptr == block->data + block->last &&
+     block->size - block->last >= newSize) {
+    block->used = block->last + newSize;
+    return ptr;
+  }
+
+  void* newPtr = arenaAlloc(arena, newSize);
+  memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+  return newPtr;
+}
+
+char* arenaStrdup(Arena* arena, char* str) {
+  size_t size = strlen(str) + 1;
+  char* copy = (char*) arenaAlloc(arena, size);
+  memcpy(copy, str, size);
+  return copy;
+}
+
+void arenaReset(Arena* arena) {
+  ArenaBlock* block = arena->current;
+  if(!block) return;
+
+  // only the current block (normally the largest one) is kept
+  ArenaBlock* previous = block->previous;
+  while(previous) {
+    ArenaBlock* next = previous->previous;
+    releaseArenaBlock(previous);
+    previous = next;
+  }
+
+  block->previous = NULL;
+  block->used = 0;
+  block->last = 0;
+}
+
+void arenaRelease(Arena* arena) {
+  ArenaBlock* block = arena->current;
+  while(block) {
+    ArenaBlock* previous = block->previous;
+    releaseArenaBlock(block);
+    block = previous;
+  }
+
+  arenaInit(arena, arena->hugePages);
+}
+
+void newArenaBlock(Arena* arena, size_t minSize) {
+  size_t size = arena->blockSize;
+  if(size < minSize + sizeof(ArenaBlock)) size = minSize + sizeof(ArenaBlock);
+  size_t alignment = arena->hugePages ? HUGE_PAGE_SIZE : PAGE_SIZE;
+  size = ROUND_UP(size, alignment);
+
+  // reserves extra room to align the block to the page size
+  size_t mapSize = size + alignment - PAGE_SIZE;
+  char* memory = (char*) mmap(NULL, mapSize, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if(memory == MAP_FAILED) {
+    fprintf(stderr, "Out of memory.\n");
+    failCompilation(PHASE_NONE, "Out of memory.", 0, 0);
+  }
+
+  // gives back the memory before and after the aligned block
+  char* aligned = (char*) ROUND_UP((size_t) memory, alignment);
+  if(aligned > memory) munmap(memory, aligned - memory);
+  if(aligned + size < memory + mapSize)
+    munmap(aligned + size, memory + mapSize - (aligned + size));
+  memory = aligned;
+
+#ifdef MADV_HUGEPAGE
+  if(arena->hugePages) madvise(memory, size, MADV_HUGEPAGE);
+#endif
+
+  // the block header is at the beginning of its own memory
+  ArenaBlock* block = (ArenaBlock*) memory;
+  block->previous = arena->current;
+  block->data = memory + ROUND_UP(sizeof(ArenaBlock), ARENA_ALIGNMENT);
+  block->size = size - (block->data - memory);
+  block->used = 0;
+  block->last = 0;
+  arena->current = block;
+
+  if(arena->blockSize < MAX_BLOCK_SIZE) arena->blockSize *= 2;
+}
+
+void releaseArenaBlock(ArenaBlock* block) {
+  munmap(block, block->size + (block->data - (char*) block));
+}
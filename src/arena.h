@@ -0,0 +1,99 @@
+/*
+ *
+ *
+ * Arena (bump) allocator. All the memory used by the phases of a
+ * compilation (AST nodes, symbol tables, generated code, etc.) is taken
+ * from an arena, and is released at once when the compilation ends, instead
+ * of being freed object by object.
+ *
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// A contiguous region of memory from which allocations are taken in order
+typedef struct stArenaBlock {
+  struct stArenaBlock* previous;  // block filled before this one
+  size_t size;  // usable bytes in data
+  size_t used;  // bytes already allocated
+  size_t last;  // offset of the last allocation (may be grown in place)
+  char* data;
+} ArenaBlock;
+
+typedef struct stArena {
+  ArenaBlock* current;  // block where allocations are taken from
+  size_t blockSize;  // minimum size of the next block
+  char hugePages;  // whether to ask for huge pages to back the blocks
+} Arena;
+
+// Arena holding the memory of the compilation in progress (each thread has
+// its own)
+extern __thread Arena compArena;
+
+/*
+ * Initializes an empty arena. No memory is reserved until the first
+ * allocation.
+ *
+ * arena: the arena to be initialized.
+ * hugePages: 1 to back the arena with (transparent) huge pages, when
+ *   supported by the system, 0 otherwise.
+ *
+ */
+void arenaInit(Arena* arena, char hugePages);
+
+/*
+ * Allocates memory from an arena. The memory is aligned for any pointer or
+ * integer type and is not initialized. Exits the program if the system is
+ * out of memory.
+ *
+ * arena: the arena to allocate from.
+ * size: number of bytes to allocate.
+ * returns: a pointer to the allocated memory.
+ *
+ */
+void* arenaAlloc(Arena* arena, size_t size);
+
+/*
+ * Resizes memory allocated from an arena. If it was the last allocation,
+ * it grows in place, otherwise its contents are copied to a new allocation
+ * (the old one is only released with the arena).
+ *
+ * arena: the arena the memory was allocated from.
+ * ptr: the memory to be resized (or NULL to allocate new memory).
+ * oldSize: the current size of the memory.
+ * newSize: the new size.
+ * returns: a pointer to the resized memory.
+ *
+ */
+void* arenaRealloc(Arena* arena, void* ptr, size_t oldSize, size_t newSize);
+
+/*
+ * Copies a string into an arena.
+ *
+ * arena: the arena to allocate from.
+ * str: the string to be copied (NUL terminated).
+ * returns: the copy.
+ *
+ */
+char* arenaStrdup(Arena* arena, char* str);
+
+/*
+ * Releases every allocation of an arena at once. The largest block is kept
+ * for the next allocations, so repeated compilations reuse the same memory.
+ *
+ * arena: the arena to be reset.
+ *
+ */
+void arenaReset(Arena* arena);
+
+/*
+ * Releases all the memory of an arena, leaving it empty.
+ *
+ * arena: the arena to be released.
+ *
+ */
+void arenaRelease(Arena* arena);
+
+#endif
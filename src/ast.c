@@ -7,111 +7,273 @@
  *
  */
 
+#include <stdlib.h>
 #include <string.h>
 #include "cli.h"
 #include "ast.h"
+#include "arena.h"
 
-void graphvizAstRec(Node* node);
+// Initial size of the node, edge and token arrays of an AST being built
+// (doubled when needed)
+#define INITIAL_AST_SIZE 1024
 
-Node* astFirstLeaf(Node* ast) {
-  Node* firstChild = ast;
+// Maximum number of children of a node (limited by the size of the field)
+#define MAX_CHILDREN 0xFFFFFF
 
-  while(1) {
-    if(firstChild->nChildren > 0) firstChild = firstChild->children[0];
-    else break;
+__thread Ast compAst;
+
+void graphvizAstRec(SourceFile* source, Node* node);
+
+/*
+ * Grows one of the arrays of the AST being built, if it is full.
+ *
+ * array: pointer to the array.
+ * elemSize: size of each element.
+ * needed: number of elements that must fit.
+ * maxSize: pointer to the allocated number of elements (updated).
+ *
+ */
+void astGrow(void** array, size_t elemSize, int needed, int* maxSize);
+
+void astInit(Token* tokens, int nTokens) {
+  compAst = (Ast) {
+    .nodes = (Node*) malloc(sizeof(Node) * INITIAL_AST_SIZE),
+    .nNodes = 0,
+    .maxNodes = INITIAL_AST_SIZE,
+    .edges = (int*) malloc(sizeof(int) * INITIAL_AST_SIZE),
+    .nEdges = 0,
+    .maxEdges = INITIAL_AST_SIZE,
+    .tokens = tokens,
+    .nTokens = nTokens,
+    .maxTokens = 0,
+    .childIndex = NULL,
+    .scopes = NULL,
+    .symTables = NULL,
+    .bindings = NULL,
+    .cgData = NULL
+  };
+}
+
+void astGrow(void** array, size_t elemSize, int needed, int* maxSize) {
+  if(needed <= *maxSize) return;
+
+  int newSize = *maxSize > 0 ? *maxSize : INITIAL_AST_SIZE;
+  while(newSize < needed) newSize *= 2;
+
+  *array = realloc(*array, elemSize * newSize);
+  if(!*array) genericError("Out of memory.");
+  *maxSize = newSize;
+}
+
+void astReserve(int nNodes) {
+  astGrow((void**) &compAst.nodes, sizeof(Node), compAst.nNodes + nNodes,
+    &compAst.maxNodes);
+}
+
+Node* astAddNode(NodeType type) {
+  if(compAst.nNodes >= compAst.maxNodes)
+    genericError("Internal error: no room reserved for AST node.");
+
+  Node* node = &compAst.nodes[compAst.nNodes++];
+  node->type = type;
+  node->nChildren = 0;
+  node->parent = -1;
+  node->children = 0;
+  node->token = -1;
+  return node;
+}
+
+int astAddToken(Token* token) {
+  astGrow((void**) &compAst.tokens, sizeof(Token), compAst.nTokens + 1,
+    &compAst.maxTokens);
+  compAst.tokens[compAst.nTokens] = *token;
+  return compAst.nTokens++;
+}
+
+void astAllocChildren(Node* node, int nChildren) {
+  if(nChildren > MAX_CHILDREN) genericError("Program too large.");
+
+  astGrow((void**) &compAst.edges, sizeof(int), compAst.nEdges + nChildren,
+    &compAst.maxEdges);
+  node->children = compAst.nEdges;
+  node->nChildren = nChildren;
+
+  for(int i = 0; i < nChildren; i++) compAst.edges[compAst.nEdges++] = -1;
+}
+
+void astSetChild(Node* node, int i, Node* child) {
+  compAst.edges[node->children + i] = AST_ID(child);
+  child->parent = AST_ID(node);
+}
+
+Node* astFinish(Node* root) {
+  Ast old = compAst;
+  int* newIndex = (int*) malloc(sizeof(int) * old.nNodes);
+  int* order = (int*) malloc(sizeof(int) * old.nNodes);
+  int* stack = (int*) malloc(sizeof(int) * old.nNodes);
+  int* nextChild = (int*) malloc(sizeof(int) * old.nNodes);
+
+  // depth-first walk from the root, recording the nodes in postorder
+  int nNodes = 0;
+  int nTokens = 0;
+  int top = 0;
+  stack[0] = AST_ID(root);
+  nextChild[0] = 0;
+
+  while(top >= 0) {
+    Node* node = &old.nodes[stack[top]];
+
+    if(nextChild[top] < node->nChildren) {
+      int child = old.edges[node->children + nextChild[top]++];
+      if(child < 0) genericError("Internal error: empty child node.");
+      top++;
+      stack[top] = child;
+      nextChild[top] = 0;
+    } else {
+      newIndex[stack[top]] = nNodes;
+      order[nNodes++] = stack[top];
+      if(node->token >= 0) nTokens++;
+      top--;
+    }
   }
-  return firstChild;
+
+  compAst = (Ast) {
+    .nodes = (Node*) arenaAlloc(&compArena, sizeof(Node) * nNodes),
+    .nNodes = nNodes,
+    .maxNodes = nNodes,
+    .edges = (int*) arenaAlloc(&compArena, sizeof(int) * nNodes),
+    .nEdges = 0,
+    .maxEdges = nNodes,
+    .tokens = (Token*) arenaAlloc(&compArena, sizeof(Token) * nTokens),
+    .nTokens = 0,
+    .maxTokens = nTokens,
+    .childIndex = (int*) arenaAlloc(&compArena, sizeof(int) * nNodes),
+    .scopes = NULL,
+    .symTables = NULL,
+    .bindings = NULL,
+    .cgData = NULL
+  };
+
+  // children come before their parents, so their new indices are known
+  for(int i = 0; i < nNodes; i++) {
+    Node* from = &old.nodes[order[i]];
+    Node* to = &compAst.nodes[i];
+    to->type = from->type;
+    to->nChildren = from->nChildren;
+    to->parent = -1;
+    to->children = compAst.nEdges;
+    to->token = -1;
+
+    for(int j = 0; j < from->nChildren; j++) {
+      int child = newIndex[old.edges[from->children + j]];
+      compAst.edges[compAst.nEdges++] = child;
+      compAst.nodes[child].parent = i;
+      compAst.childIndex[child] = j;
+    }
+
+    if(from->token >= 0) {
+      compAst.tokens[compAst.nTokens] = old.tokens[from->token];
+      to->token = compAst.nTokens++;
+    }
+  }
+
+  free(newIndex);
+  free(order);
+  free(stack);
+  free(nextChild);
+  free(old.nodes);
+  free(old.edges);
+  if(old.maxTokens > 0) free(old.tokens);
+
+  return &compAst.nodes[nNodes - 1];
+}
+
+void astRelease() {
+  // the arrays of a finished AST (which has childIndex) are in the arena
+  if(!compAst.childIndex) {
+    free(compAst.nodes);
+    free(compAst.edges);
+    if(compAst.maxTokens > 0) free(compAst.tokens);
+  }
+  memset(&compAst, 0, sizeof(Ast));
 }
 
-Node* astLastLeaf(Node* ast) {
-  Node* lastChild = ast;
+Node* astFirstLeaf(Node* ast) {
+  Node* firstChild = ast;
 
   while(1) {
-    if(lastChild->nChildren > 0) {
-      lastChild = lastChild->children[lastChild->nChildren - 1];
-    } else break;
+    if(firstChild->nChildren > 0) firstChild = AST_CHILD(firstChild, 0);
+    else break;
   }
-  return lastChild;
+  return firstChild;
 }
 
 int whichChild(Node* node) {
-  if(!node->parent) return 0;
+  Node* parent = AST_PARENT(node);
+  if(!parent) return 0;
+  if(compAst.childIndex) return compAst.childIndex[AST_ID(node)];
 
-  for(int i = 0; i < node->parent->nChildren; i++) {
-    if(node->id == node->parent->children[i]->id) return i;
+  int id = AST_ID(node);
+  int* children = &compAst.edges[parent->children];
+  for(int i = 0; i < parent->nChildren; i++) {
+    if(children[i] == id) return i;
   }
 
   genericError("AST node with corrupted ID.");
 }
 
 void postorderTraverse(Node* node, void (*visit)(Node*)) {
-  for(int i = 0; i < node->nChildren; i++) {
-    if(!node->children[i])
-      genericError("Internal bug: AST node with NULL child.");
-    postorderTraverse(node->children[i], visit);
-  }
-
-  visit(node);
+  // the subtree starts at its first leaf and ends at its root
+  for(Node* visited = astFirstLeaf(node); visited <= node; visited++)
+    visit(visited);
 }
 
-void graphvizAst(Node* ast) {
+void graphvizAst(SourceFile* source, Node* ast) {
   if(cli.outputType != OUT_GRAPHVIZ) return;
 
 //  printf("digraph G {\n");
-  printf("digraph G%d {\n", ast->id);
-  graphvizAstRec(ast);
+  printf("digraph G%d {\n", AST_ID(ast));
+  graphvizAstRec(source, ast);
   printf("}");
   printf("\n");
 }
 
-void graphvizAstRec(Node* node) {
+void graphvizAstRec(SourceFile* source, Node* node) {
   char* format = "%s";
   int len = strlen(format) + MAX_NODE_NAME;
   char nodeName[len];
-  strReplaceNodeAbbrev(nodeName, format, node);
+  strReplaceNodeAbbrev(source, nodeName, format, node);
 
-  if(node->type == NTTerminal && node->token->type == TTLitString)
-    printf("%d [label=%s];\n", node->id, nodeName);
+  if(node->type == NTTerminal && AST_TOKEN(node)->type == TTLitString)
+    printf("%d [label=%s];\n", AST_ID(node), nodeName);
   else
-    printf("%d [label=\"%s\"];\n", node->id, nodeName);
+    printf("%d [label=\"%s\"];\n", AST_ID(node), nodeName);
 
   for(int i = 0; i < node->nChildren; i++) {
-    printf("%d -> %d;\n", node->id, node->children[i]->id);
-    graphvizAstRec(node->children[i]);
+    printf("%d -> %d;\n", AST_ID(node), AST_ID(AST_CHILD(node, i)));
+    graphvizAstRec(source, AST_CHILD(node, i));
   }
 }
 
-void checkTree(Node* node, int nodeCount) {
-  if(!node) return;
-
-  int id = node->id;
-  int type = node->type;
-  int nChildren = node->nChildren;
-  Node* parent = node->parent;
+void checkTree() {
+  for(int id = 0; id < compAst.nNodes; id++) {
+    Node* node = &compAst.nodes[id];
 
-  if(node->type != NTProgram && !node->parent) {
-printf("type: %d, id: %d\n", node->type, node->id);
-    genericError("Internal error: non-root AST node without parent.");
-  }
+    if(node->type != NTProgram && node->parent < 0)
+      genericError("Internal error: non-root AST node without parent.");
 
-  if(id < 0 || id > nodeCount)
-    genericError("Internal memory error.");
+    // in postorder, parents come after their children
+    if(node->parent >= compAst.nNodes || (node->parent >= 0
+       && node->parent <= id))
+      genericError("Internal memory error.");
 
-//  if(cli.outputType == OUT_DEBUG) {
-//    printf("ID: %d, type: %d, nch: %d\n", node->id,
-//      node->type, node->nChildren);
-//  }
+    if(node->children + node->nChildren > compAst.nEdges)
+      genericError("Internal memory error.");
 
-  for(int i = 0; i < node->nChildren; i++) {
-    Node* chnode = node->children[i];
-//    if(cli.outputType == OUT_DEBUG) {
-//      printf("ch[%d]: ID: %d, type: %d, nch: %d\n", i, chnode->id,
-//        chnode->type, chnode->nChildren);
-//    }
-  }
-  for(int i = 0; i < node->nChildren; i++) {
-    if(!node->children[i]) genericError("Internal error: empty child node.");
-    checkTree(node->children[i], nodeCount);
+    for(int i = 0; i < node->nChildren; i++) {
+      int child = compAst.edges[node->children + i];
+      if(child < 0 || child >= id || compAst.nodes[child].parent != id)
+        genericError("Internal error: empty child node.");
+    }
   }
 }
-
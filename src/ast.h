@@ -1,22 +1,141 @@
 
+
 #ifndef AST_H
 #define AST_H
 
 #include "util.h"
 #include "datast.h"
 
+// Index of a node in the AST
+#define AST_ID(node) ((int) ((node) - compAst.nodes))
+
+// Child number i of a node
+#define AST_CHILD(node, i) \
+  (&compAst.nodes[compAst.edges[(node)->children + (i)]])
+
+// Parent of a node (NULL for the root)
+#define AST_PARENT(node) \
+  ((node)->parent < 0 ? NULL : &compAst.nodes[(node)->parent])
+
+// Token of a terminal node (NULL for other nodes)
+#define AST_TOKEN(node) \
+  ((node)->token < 0 ? NULL : &compAst.tokens[(node)->token])
+
+// Symbol table of a node (side table filled by the scoper)
+#define AST_SYMTABLE(node) (compAst.symTables[AST_ID(node)])
+
+// Innermost scope-bearing node of a node, maybe itself (side table filled
+// by the scoper)
+#define AST_SCOPE(node) (&compAst.nodes[compAst.scopes[AST_ID(node)]])
+
+// Symbol an identifier node stands for, or NULL if unbound (side table
+// filled by the scoper)
+#define AST_SYMBOL(node) \
+  (compAst.bindings[AST_ID(node)].scope < 0 ? NULL \
+   : &compAst.symTables[compAst.bindings[AST_ID(node)].scope] \
+       ->symbols[compAst.bindings[AST_ID(node)].symbol])
+
+// Code generation data of a node (side table filled by the code generator)
+#define AST_CGDATA(node) (compAst.cgData[AST_ID(node)])
+
+// The AST being built or processed
+extern __thread Ast compAst;
+
+/*
+ * Starts building a new, empty AST.
+ *
+ * tokens: array with the tokens that terminal nodes will refer to, or NULL
+ *   if the tokens will be added one by one with astAddToken.
+ * nTokens: number of tokens in the array.
+ *
+ */
+void astInit(Token* tokens, int nTokens);
+
+/*
+ * Makes room for a number of new nodes. Adding nodes never moves the
+ * existing ones as long as there is room for them, so pointers to nodes
+ * remain valid until the next call to this function.
+ *
+ * nNodes: the number of nodes that must fit without moving the array.
+ *
+ */
+void astReserve(int nNodes);
+
+/*
+ * Adds a new node, without children nor token, to the AST. There must be
+ * room for it (see astReserve).
+ *
+ * type: the type of the new node.
+ * returns: a pointer to the new node.
+ *
+ */
+Node* astAddNode(NodeType type);
+
+/*
+ * Adds a copy of a token to the tokens of the AST (only when the AST was
+ * initialized without an array of tokens).
+ *
+ * token: the token to be copied.
+ * returns: the index of the copy.
+ *
+ */
+int astAddToken(Token* token);
+
+/*
+ * Reserves a run of consecutive entries in the edge array for the children
+ * of a node.
+ *
+ * node: the node that will have the children.
+ * nChildren: the number of children.
+ *
+ */
+void astAllocChildren(Node* node, int nChildren);
+
+/*
+ * Sets a child of a node (and the parent of the child).
+ *
+ * node: the parent node, whose children have already been allocated.
+ * i: the position of the child.
+ * child: the child node.
+ *
+ */
+void astSetChild(Node* node, int i, Node* child);
+
+/*
+ * Rearranges the nodes reachable from the root in postorder, discarding the
+ * rest (e.g. punctuation tokens that did not become part of the tree). The
+ * new arrays are exact-sized and allocated in the compilation arena. The
+ * side tables are left empty (NULL) for the phases that need them.
+ *
+ * root: the root of the AST.
+ * returns: the root in the rearranged AST (the last node).
+ *
+ */
+Node* astFinish(Node* root);
+
+/*
+ * Frees the arrays of an AST that was being built when its compilation
+ * stopped (those of a finished AST are in the arena), and forgets the AST.
+ *
+ */
+void astRelease();
+
 Node* astFirstLeaf(Node* ast);
-Node* astLastLeaf(Node* ast);
 
 // Prints the AST in GraphViz format
-void graphvizAst(Node* ast);
+void graphvizAst(SourceFile* source, Node* ast);
 
-// Checks if the AST looks healthy (memory-wise)
-void checkTree(Node* node, int nodeCount);
+// Checks if the AST looks healthy (links between nodes). Walks the node
+// array linearly, so the AST must be in postorder (see astFinish).
+void checkTree();
 
+// Visits the nodes of a subtree in postorder. As the AST is stored in
+// postorder, this is a linear walk over a slice of the node array.
 void postorderTraverse(Node* node, void (*visit)(Node*));
 
+// Returns the position of a node among the children of its parent (0 for
+// the root). Once the AST is finished (see astFinish) it is read from a side
+// table.
 int whichChild(Node* node);
 
 #endif
-
@@ -0,0 +1,180 @@
+/*
+ *
+ *
+ * Batch compilation of many sources on a pool of threads.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "batch.h"
+#include "source.h"
+#include "threadpool.h"
+
+// Extension of the sources, removed to name their executables
+#define SOURCE_EXTENSION ".ul"
+
+// Appended to the name of a source without SOURCE_EXTENSION to name its
+// executable
+#define EXEC_EXTENSION ".out"
+
+// Replaces SOURCE_EXTENSION (or is appended) to name the object file of a
+// source
+#define OBJECT_EXTENSION ".o"
+
+/*
+ * Compares two items of a batch by the size of their sources, the biggest
+ * first (for qsort).
+ *
+ * a: pointer to the first item pointer.
+ * b: pointer to the second item pointer.
+ * returns: <0, 0 or >0, as strcmp.
+ *
+ */
+int compareItemSizes(const void* a, const void* b);
+
+/*
+ * Compiles one of the sources of a batch (a task of the thread pool).
+ *
+ * batch: the Batch.
+ * index: the position of the item in the order of the batch.
+ *
+ */
+void compileBatchItem(void* batch, int index);
+
+
+Batch* loadBatch(char* listName, struct stCli* options) {
+  SourceFile* list = loadSource(listName);
+  if(!list) return NULL;
+
+  Batch* batch = (Batch*) malloc(sizeof(Batch));
+  batch->options = *options;
+  batch->text = (char*) malloc(list->size + 1);
+  memcpy(batch->text, list->data, list->size);
+  batch->text[list->size] = '\0';
+
+  int maxItems = 1;
+  for(long i = 0; i < list->size; i++) {
+    if(batch->text[i] == '\n') maxItems++;
+  }
+  closeSource(list);
+
+  batch->items = (BatchItem*) malloc(sizeof(BatchItem) * maxItems);
+  batch->nItems = 0;
+
+  // each line: the source, and maybe the executable, separated by spaces
+  char* separators = " \t\r";
+  for(char* line = batch->text; line; ) {
+    char* next = strchr(line, '\n');
+    if(next) *next++ = '\0';
+
+    char* sourceName = line + strspn(line, separators);
+    char* end = sourceName + strcspn(sourceName, separators);
+    char* outputName = end + strspn(end, separators);
+    outputName[strcspn(outputName, separators)] = '\0';
+    *end = '\0';
+    line = next;
+
+    if(!*sourceName) continue;
+
+    BatchItem* item = &batch->items[batch->nItems++];
+    struct stat s;
+    *item = (BatchItem) {
+      .sourceName = sourceName,
+      .outputName = *outputName ? strdup(outputName)
+        : defaultOutputName(sourceName, options->object),
+      .size = stat(sourceName, &s) == 0 ? (long) s.st_size : -1,
+      .failed = 0
+    };
+  }
+
+  batch->order = (BatchItem**) malloc(sizeof(BatchItem*) * maxItems);
+  for(int i = 0; i < batch->nItems; i++) batch->order[i] = &batch->items[i];
+  qsort(batch->order, batch->nItems, sizeof(BatchItem*), compareItemSizes);
+
+  return batch;
+}
+
+char* defaultOutputName(char* sourceName, char object) {
+  int size = strlen(sourceName);
+  int extSize = strlen(SOURCE_EXTENSION);
+  char* name = (char*) malloc(size + strlen(EXEC_EXTENSION)
+    + strlen(OBJECT_EXTENSION) + 1);
+  strcpy(name, sourceName);
+
+  if(size > extSize && strcmp(name + size - extSize, SOURCE_EXTENSION) == 0)
+    name[size - extSize] = '\0';
+  else if(!object) strcat(name, EXEC_EXTENSION);
+  if(object) strcat(name, OBJECT_EXTENSION);
+  return name;
+}
+
+int compareItemSizes(const void* a, const void* b) {
+  long sizeA = (*(BatchItem**) a)->size;
+  long sizeB = (*(BatchItem**) b)->size;
+  return sizeA < sizeB ? 1 : (sizeA > sizeB ? -1 : 0);
+}
+
+int compileBatch(Batch* batch, int nThreads) {
+  if(nThreads < 1) nThreads = availableCores();
+
+  // the state of the compilations of each thread is freed when it ends
+  runTasksWithCleanup(nThreads, batch->nItems, compileBatchItem, batch,
+    releaseCompilerMemory);
+
+  int nFailed = 0;
+  for(int i = 0; i < batch->nItems; i++) nFailed += batch->items[i].failed;
+  return nFailed;
+}
+
+void compileBatchItem(void* batch, int index) {
+  Batch* b = (Batch*) batch;
+  BatchItem* item = b->order[index];
+
+  SourceFile* source = loadSource(item->sourceName);
+  if(!source) {
+    item->failed = 1;
+    item->error = (CompileError) { .phase = PHASE_NONE, .lnum = 0,
+      .chnum = 0 };
+    strcpy(item->error.message, "Invalid file name.");
+    return;
+  }
+
+  // errors are reported at the end, in order; big sources are not lexed in
+  // parallel, as the other threads are busy with their own sources
+  CompilerContext ctx = {
+    .options = b->options,
+    .source = source,
+    .outputName = item->outputName,
+    .lastPhase = PHASE_NONE,
+    .memoryOutput = 0
+  };
+  ctx.options.outputType = OUT_SILENT;
+  ctx.options.jobs = 1;
+
+  item->failed = compile(&ctx);
+  item->error = ctx.error;
+  closeSource(source);
+}
+
+void reportBatch(Batch* batch) {
+  if(batch->options.outputType > OUT_DEFAULT) return;
+
+  for(int i = 0; i < batch->nItems; i++) {
+    BatchItem* item = &batch->items[i];
+    if(item->failed)
+      printCompileError(&item->error, item->sourceName, NULL);
+  }
+}
+
+void closeBatch(Batch* batch) {
+  for(int i = 0; i < batch->nItems; i++) free(batch->items[i].outputName);
+  free(batch->items);
+  free(batch->order);
+  free(batch->text);
+  free(batch);
+}
@@ -0,0 +1,86 @@
+/*
+ *
+ *
+ * Batch compilation: many independent sources compiled by one process, on
+ * a pool of threads. Each thread compiles one source at a time, with its
+ * own state for all the phases (see compiler.h).
+ *
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "compiler.h"
+
+// A source of a batch, and how its compilation ended
+typedef struct stBatchItem {
+  char* sourceName;
+  char* outputName;
+  long size;  // size of the source file (-1 if it cannot be read)
+  int failed;  // 1 if the compilation stopped with an error
+  CompileError error;
+} BatchItem;
+
+// Sources to be compiled in a batch
+typedef struct stBatch {
+  BatchItem* items;  // in the order of the list
+  int nItems;
+  BatchItem** order;  // the items, the biggest sources first
+  struct stCli options;  // options of every compilation
+  char* text;  // text of the list, where the names of the items are
+} Batch;
+
+/*
+ * Reads a list of sources to be compiled. Each non-empty line has the name
+ * of a source, optionally followed (after spaces) by the name of its
+ * executable. By default, the executable is named after the source, without
+ * the .ul extension (or with .out appended if it has no .ul extension), and
+ * with -c the object file replaces .ul with .o.
+ *
+ * listName: the name of the file with the list.
+ * options: the options of every compilation.
+ * returns: the batch, NULL if the list cannot be read.
+ *
+ */
+Batch* loadBatch(char* listName, struct stCli* options);
+
+/*
+ * Names the output of a source, when it is not given: its executable, or
+ * its object file with -c (see loadBatch).
+ *
+ * sourceName: the name of the source.
+ * object: 1 to name the object file, 0 to name the executable.
+ * returns: the name of the output (to be freed by the caller).
+ *
+ */
+char* defaultOutputName(char* sourceName, char object);
+
+/*
+ * Compiles all the sources of a batch. The biggest ones are started first,
+ * so that the threads finish at about the same time.
+ *
+ * batch: the batch.
+ * nThreads: number of threads to use (0: one per core).
+ * returns: the number of sources that failed to compile.
+ *
+ */
+int compileBatch(Batch* batch, int nThreads);
+
+/*
+ * Prints the errors of the sources of a compiled batch, in the order of the
+ * list (unless the options ask for no output).
+ *
+ * batch: the batch.
+ *
+ */
+void reportBatch(Batch* batch);
+
+/*
+ * Frees a batch.
+ *
+ * batch: the batch.
+ *
+ */
+void closeBatch(Batch* batch);
+
+#endif
@@ -0,0 +1,513 @@
+/*
+ *
+ *
+ * Content-addressed cache of compiler outputs.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#include "cache.h"
+
+// Name of the cache directory, in $XDG_CACHE_HOME or $HOME/.cache
+#define CACHE_NAME "ulpc"
+
+// Maximum size of the path of the cache directory
+#define CACHE_DIR_SIZE 4000
+
+// Maximum size of the path of a file of the cache (its directory, and a key
+// or another name)
+#define CACHE_PATH_SIZE (CACHE_DIR_SIZE + 2 * CACHE_KEY_SIZE)
+
+// File with the statistics of the cache, also locked to change the cache
+#define STATS_FILE "stats"
+
+// Name of the files being copied into the cache (mkstemp replaces the Xs)
+#define TEMP_ENTRY "tmp-XXXXXX"
+
+// Percentage of its maximum size the cache is left at by an eviction (so
+// that the next ones are not right after it)
+#define EVICTION_TARGET 90
+
+// Statistics of the cache, kept in STATS_FILE
+typedef struct stCacheStats {
+  long hits;
+  long misses;
+  long evictions;  // entries removed to keep the cache under its size
+  long size;  // bytes stored since the last eviction scan, plus what it found
+} CacheStats;
+
+// An entry found in the cache directory
+typedef struct stCacheEntry {
+  char name[CACHE_KEY_SIZE];
+  long size;
+  struct timespec used;  // last time it was stored or fetched
+} CacheEntry;
+
+// Serializes the threads of this process on the statistics file (the lock
+// of the file is only between processes)
+pthread_mutex_t cacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Finds the cache directory, creating it if needed.
+ *
+ * dir: where to leave its path (CACHE_DIR_SIZE characters).
+ * returns: 1 if there is a cache directory, 0 otherwise.
+ *
+ */
+int cacheDir(char* dir);
+
+/*
+ * Locks the statistics file, and reads the statistics.
+ *
+ * dir: the cache directory.
+ * stats: where to leave the statistics.
+ * returns: the statistics file (to be given to unlockStats), -1 if it cannot
+ *   be opened.
+ *
+ */
+int lockStats(char* dir, CacheStats* stats);
+
+/*
+ * Writes the statistics, and unlocks the statistics file.
+ *
+ * fd: the statistics file (-1 if it could not be opened).
+ * stats: the statistics.
+ *
+ */
+void unlockStats(int fd, CacheStats* stats);
+
+/*
+ * Counts bytes added to (or removed from) the cache, and evicts the least
+ * recently used entries if it grows too big.
+ *
+ * dir: the cache directory.
+ * size: the number of bytes.
+ *
+ */
+void addCacheSize(char* dir, long size);
+
+/*
+ * Writes bytes to a file.
+ *
+ * fd: the file.
+ * data: the bytes.
+ * size: the number of bytes.
+ * returns: 1 if they were written, 0 otherwise.
+ *
+ */
+int writeData(int fd, char* data, long size);
+
+/*
+ * Copies an entry of the cache into a new file, with the same permissions.
+ * The blocks are shared (a reflink) if the file system can do it, but never
+ * the file itself, so writing to the copy leaves the entry as it was.
+ *
+ * from: the entry.
+ * to: the new file (replaced if it exists).
+ * returns: 1 if the entry was copied, 0 otherwise.
+ *
+ */
+int copyFromCache(char* from, char* to);
+
+/*
+ * Copies a file into a new file, with the same permissions. The new file is
+ * written under a temporary name in the cache directory and then renamed, so
+ * it is never seen half written.
+ *
+ * from: the file.
+ * to: the new file (in the cache directory).
+ * dir: the cache directory.
+ * returns: 1 if the file was copied, 0 otherwise.
+ *
+ */
+int copyIntoCache(char* from, char* to, char* dir);
+
+/*
+ * Copies the contents of a file to another.
+ *
+ * fromFd: the file copied.
+ * toFd: the file written.
+ * returns: 1 if it was copied, 0 otherwise.
+ *
+ */
+int copyData(int fromFd, int toFd);
+
+/*
+ * Lists the entries of the cache.
+ *
+ * dir: the cache directory.
+ * nEntries: where to leave the number of entries.
+ * size: where to leave their total size, in bytes.
+ * returns: the entries (to be freed by the caller).
+ *
+ */
+CacheEntry* scanCache(char* dir, int* nEntries, long* size);
+
+/*
+ * Removes the least recently used entries of the cache, until it is under
+ * EVICTION_TARGET percent of its maximum size.
+ *
+ * dir: the cache directory.
+ * stats: the statistics, updated with the evictions and the size left.
+ *
+ */
+void evictEntries(char* dir, CacheStats* stats);
+
+/*
+ * Compares two entries of the cache by their last use, the oldest first
+ * (for qsort).
+ *
+ * a: pointer to the first entry.
+ * b: pointer to the second entry.
+ * returns: <0, 0 or >0, as strcmp.
+ *
+ */
+int compareEntryUses(const void* a, const void* b);
+
+/*
+ * Returns the maximum size of the cache, in bytes.
+ *
+ */
+long maxCacheSize();
+
+
+void cacheKey(SourceFile* source, struct stCli* options, char* key) {
+  // only the options that change the output are part of the key
+  char header[64];
+  int headerSize = snprintf(header, sizeof(header),
+    "ulpc %s nasm=%d object=%d", VERSION, options->nasm, options->object) + 1;
+
+  Sha256 sha;
+  unsigned char digest[SHA256_SIZE];
+  sha256Init(&sha);
+  sha256Update(&sha, header, headerSize);
+  sha256Update(&sha, source->data, source->size);
+  sha256Final(&sha, digest);
+
+  for(int i = 0; i < SHA256_SIZE; i++) sprintf(key + 2 * i, "%02x", digest[i]);
+}
+
+int fetchCachedOutput(char* key, char* outputName) {
+  char dir[CACHE_DIR_SIZE], entry[CACHE_PATH_SIZE];
+  if(!cacheDir(dir)) return 0;
+  snprintf(entry, sizeof(entry), "%s/%s", dir, key);
+
+  // the time of the entry is its last use (for the evictions)
+  int hit = copyFromCache(entry, outputName);
+  if(hit) utimensat(AT_FDCWD, entry, NULL, 0);
+
+  CacheStats stats;
+  int fd = lockStats(dir, &stats);
+  if(hit) stats.hits++;
+  else stats.misses++;
+  unlockStats(fd, &stats);
+  return hit;
+}
+
+void storeCachedOutput(char* key, char* outputName) {
+  char dir[CACHE_DIR_SIZE], entry[CACHE_PATH_SIZE];
+  struct stat s;
+  if(!cacheDir(dir) || stat(outputName, &s) != 0) return;
+  snprintf(entry, sizeof(entry), "%s/%s", dir, key);
+
+  // the cache keeps a copy of its own, which later writes to the output
+  // (or to the outputs fetched from it) do not change
+  struct stat old;
+  long oldSize = stat(entry, &old) == 0 ? (long) old.st_size : 0;
+  if(copyIntoCache(outputName, entry, dir))
+    addCacheSize(dir, s.st_size - oldSize);
+}
+
+char* readCacheFile(char* key, long* size) {
+  char dir[CACHE_DIR_SIZE], entry[CACHE_PATH_SIZE];
+  if(!cacheDir(dir)) return NULL;
+  snprintf(entry, sizeof(entry), "%s/%s", dir, key);
+
+  int fd = open(entry, O_RDONLY);
+  if(fd < 0) return NULL;
+  struct stat s;
+  char* data = fstat(fd, &s) == 0 ? (char*) malloc(s.st_size + 1) : NULL;
+
+  long done = 0;
+  while(data && done < s.st_size) {
+    ssize_t n = read(fd, data + done, s.st_size - done);
+    if(n > 0) done += n;
+    else if(n == 0 || errno != EINTR) break;
+  }
+  close(fd);
+  if(!data || done < s.st_size) {
+    free(data);
+    return NULL;
+  }
+
+  utimensat(AT_FDCWD, entry, NULL, 0);
+  *size = s.st_size;
+  return data;
+}
+
+void writeCacheFile(char* key, char* data, long size) {
+  char dir[CACHE_DIR_SIZE], entry[CACHE_PATH_SIZE], temp[CACHE_PATH_SIZE];
+  if(!cacheDir(dir)) return;
+  snprintf(entry, sizeof(entry), "%s/%s", dir, key);
+  snprintf(temp, sizeof(temp), "%s/" TEMP_ENTRY, dir);
+
+  // written aside and renamed, so it is never seen half written
+  int fd = mkstemp(temp);
+  if(fd < 0) return;
+  int written = writeData(fd, data, size);
+  if(close(fd) != 0) written = 0;
+
+  struct stat s;
+  long oldSize = stat(entry, &s) == 0 ? (long) s.st_size : 0;
+  if(!written || rename(temp, entry) != 0) {
+    unlink(temp);
+    return;
+  }
+  addCacheSize(dir, size - oldSize);
+}
+
+void addCacheSize(char* dir, long size) {
+  CacheStats stats;
+  int fd = lockStats(dir, &stats);
+  stats.size += size;
+  if(fd >= 0 && stats.size > maxCacheSize()) evictEntries(dir, &stats);
+  unlockStats(fd, &stats);
+}
+
+int printCacheStats() {
+  char dir[CACHE_DIR_SIZE];
+  if(!cacheDir(dir)) {
+    fprintf(stderr, "ERROR: No cache directory.\n");
+    return 1;
+  }
+
+  CacheStats stats;
+  int fd = lockStats(dir, &stats);
+  int nEntries;
+  long size;
+  free(scanCache(dir, &nEntries, &size));
+  unlockStats(fd, &stats);
+
+  long lookups = stats.hits + stats.misses;
+  printf("Cache: %s\n", dir);
+  printf("Hits: %ld\nMisses: %ld\n", stats.hits, stats.misses);
+  printf("Hit rate: %.1f%%\n", lookups ? 100.0 * stats.hits / lookups : 0.0);
+  printf("Evictions: %ld\n", stats.evictions);
+  printf("Entries: %d (%ld KiB of %ld KiB)\n", nEntries, size / 1024,
+    maxCacheSize() / 1024);
+  return 0;
+}
+
+int cacheDir(char* dir) {
+  char* path = getenv(CACHE_DIR_ENV);
+  if(path && *path) {
+    if(strlen(path) >= CACHE_DIR_SIZE) return 0;
+    strcpy(dir, path);
+  } else {
+    char* parent = getenv("XDG_CACHE_HOME");
+    char* home = getenv("HOME");
+    if(parent && *parent) {
+      if(strlen(parent) >= CACHE_DIR_SIZE - sizeof(CACHE_NAME)) return 0;
+      strcpy(dir, parent);
+    } else if(home && *home) {
+      if(strlen(home) >= CACHE_DIR_SIZE - sizeof(CACHE_NAME)
+        - sizeof("/.cache")) return 0;
+      sprintf(dir, "%s/.cache", home);
+    } else return 0;
+
+    mkdir(dir, S_IRWXU);
+    strcat(dir, "/" CACHE_NAME);
+  }
+
+  struct stat s;
+  if(mkdir(dir, S_IRWXU) != 0 && errno != EEXIST) return 0;
+  return stat(dir, &s) == 0 && S_ISDIR(s.st_mode);
+}
+
+int lockStats(char* dir, CacheStats* stats) {
+  char path[CACHE_PATH_SIZE];
+  snprintf(path, sizeof(path), "%s/" STATS_FILE, dir);
+  *stats = (CacheStats) { .hits = 0, .misses = 0, .evictions = 0, .size = 0 };
+
+  pthread_mutex_lock(&cacheMutex);
+  int fd = open(path, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+  struct flock lock = { .l_type = F_WRLCK, .l_whence = SEEK_SET };
+  if(fd < 0) {
+    pthread_mutex_unlock(&cacheMutex);
+    return -1;
+  }
+  while(fcntl(fd, F_SETLKW, &lock) != 0 && errno == EINTR);
+
+  char text[128];
+  ssize_t size = pread(fd, text, sizeof(text) - 1, 0);
+  text[size > 0 ? size : 0] = '\0';
+  sscanf(text, "%ld %ld %ld %ld", &stats->hits, &stats->misses,
+    &stats->evictions, &stats->size);
+  return fd;
+}
+
+void unlockStats(int fd, CacheStats* stats) {
+  if(fd < 0) return;
+
+  char text[128];
+  int size = sprintf(text, "%ld %ld %ld %ld\n", stats->hits, stats->misses,
+    stats->evictions, stats->size);
+  if(pwrite(fd, text, size, 0) == size) ftruncate(fd, size);
+
+  // closing the file releases its lock
+  close(fd);
+  pthread_mutex_unlock(&cacheMutex);
+}
+
+int copyFromCache(char* from, char* to) {
+  int fromFd = open(from, O_RDONLY);
+  if(fromFd < 0) return 0;
+
+  // a new file, so that an executable that is running can be replaced (but
+  // a missing entry leaves the old one)
+  struct stat s;
+  int toFd = -1;
+  if(fstat(fromFd, &s) == 0) {
+    unlink(to);
+    toFd = open(to, O_WRONLY | O_CREAT | O_EXCL, s.st_mode & 0777);
+  }
+
+  int copied = 0;
+#ifdef FICLONE
+  copied = toFd >= 0 && ioctl(toFd, FICLONE, fromFd) == 0;
+#endif
+  if(!copied) copied = toFd >= 0 && copyData(fromFd, toFd);
+  if(toFd >= 0 && close(toFd) != 0) copied = 0;
+  close(fromFd);
+  if(!copied && toFd >= 0) unlink(to);
+  return copied;
+}
+
+int copyIntoCache(char* from, char* to, char* dir) {
+  char temp[CACHE_PATH_SIZE];
+  snprintf(temp, sizeof(temp), "%s/" TEMP_ENTRY, dir);
+
+  int fromFd = open(from, O_RDONLY);
+  if(fromFd < 0) return 0;
+  int toFd = mkstemp(temp);
+  struct stat s;
+
+  int copied = toFd >= 0 && fstat(fromFd, &s) == 0
+    && fchmod(toFd, s.st_mode & 0777) == 0 && copyData(fromFd, toFd);
+  if(toFd >= 0 && close(toFd) != 0) copied = 0;
+  close(fromFd);
+
+  if(copied && rename(temp, to) == 0) return 1;
+  if(toFd >= 0) unlink(temp);
+  return 0;
+}
+
+int copyData(int fromFd, int toFd) {
+  char buffer[65536];
+  ssize_t size;
+
+  while((size = read(fromFd, buffer, sizeof(buffer))) != 0) {
+    if(size < 0) {
+      if(errno == EINTR) continue;
+      return 0;
+    }
+    if(!writeData(toFd, buffer, size)) return 0;
+  }
+  return 1;
+}
+
+int writeData(int fd, char* data, long size) {
+  for(long done = 0; done < size; ) {
+    ssize_t n = write(fd, data + done, size - done);
+    if(n < 0 && errno != EINTR) return 0;
+    if(n > 0) done += n;
+  }
+  return 1;
+}
+
+CacheEntry* scanCache(char* dir, int* nEntries, long* size) {
+  int maxEntries = 64;
+  CacheEntry* entries = (CacheEntry*) malloc(sizeof(CacheEntry) * maxEntries);
+  *nEntries = 0;
+  *size = 0;
+
+  DIR* d = opendir(dir);
+  if(!d) return entries;
+
+  // the entries are the files named after a key (not the statistics, nor
+  // the files being copied)
+  struct dirent* file;
+  while((file = readdir(d))) {
+    char path[CACHE_PATH_SIZE];
+    struct stat s;
+    if(strlen(file->d_name) != CACHE_KEY_SIZE - 1
+       || strspn(file->d_name, "0123456789abcdef") != CACHE_KEY_SIZE - 1)
+      continue;
+    snprintf(path, sizeof(path), "%s/%s", dir, file->d_name);
+    if(stat(path, &s) != 0 || !S_ISREG(s.st_mode)) continue;
+
+    if(*nEntries == maxEntries) {
+      maxEntries *= 2;
+      entries = (CacheEntry*) realloc(entries,
+        sizeof(CacheEntry) * maxEntries);
+    }
+    CacheEntry* entry = &entries[(*nEntries)++];
+    strcpy(entry->name, file->d_name);
+    entry->size = s.st_size;
+    entry->used = s.st_mtim;
+    *size += s.st_size;
+  }
+
+  closedir(d);
+  return entries;
+}
+
+void evictEntries(char* dir, CacheStats* stats) {
+  int nEntries;
+  long size;
+  CacheEntry* entries = scanCache(dir, &nEntries, &size);
+  qsort(entries, nEntries, sizeof(CacheEntry), compareEntryUses);
+
+  long target = maxCacheSize() / 100 * EVICTION_TARGET;
+  for(int i = 0; i < nEntries && size > target; i++) {
+    char path[CACHE_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s/%s", dir, entries[i].name);
+
+    // an entry that cannot be removed still counts (one already removed by
+    // another compiler does not)
+    if(unlink(path) == 0) {
+      stats->evictions++;
+      size -= entries[i].size;
+    }
+    else if(errno == ENOENT) size -= entries[i].size;
+  }
+
+  stats->size = size;
+  free(entries);
+}
+
+int compareEntryUses(const void* a, const void* b) {
+  struct timespec usedA = ((CacheEntry*) a)->used;
+  struct timespec usedB = ((CacheEntry*) b)->used;
+  if(usedA.tv_sec != usedB.tv_sec) return usedA.tv_sec < usedB.tv_sec ? -1 : 1;
+  return usedA.tv_nsec < usedB.tv_nsec ? -1 : (usedA.tv_nsec > usedB.tv_nsec);
+}
+
+long maxCacheSize() {
+  char* size = getenv(CACHE_SIZE_ENV);
+  long megabytes = size ? atol(size) : 0;
+  if(megabytes <= 0) megabytes = CACHE_DEFAULT_SIZE;
+  return megabytes * 1024 * 1024;
+}
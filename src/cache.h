@@ -0,0 +1,105 @@
+/*
+ *
+ *
+ * Content-addressed cache of compiler outputs. An executable is stored under
+ * the SHA-256 of what it was compiled from (the source bytes, the version of
+ * the compiler and the options that change the output), so compiling the
+ * same thing again just copies the stored executable, skipping all the
+ * phases. The cache keeps copies of its own, so the outputs can be changed
+ * without changing it.
+ *
+ * The entries are files of a cache directory, created with a rename (so
+ * that they are never seen half written) and evicted least recently used
+ * first when the directory grows over its maximum size. The statistics and
+ * the evictions are serialized by a lock on the statistics file, so many
+ * compilers (and threads) can share the cache.
+ *
+ * Other files can be kept in the cache as well (see readCacheFile), such as
+ * the code of the functions of a source (see incremental.h).
+ *
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "cli.h"
+#include "datast.h"
+#include "sha256.h"
+
+// Environment variable with the directory of the cache (by default,
+// ulpc in $XDG_CACHE_HOME or in $HOME/.cache)
+#define CACHE_DIR_ENV "ULPC_CACHE_DIR"
+
+// Environment variable with the maximum size of the cache, in MiB
+#define CACHE_SIZE_ENV "ULPC_CACHE_SIZE"
+
+// Maximum size of the cache, in MiB, if CACHE_SIZE_ENV is not set
+#define CACHE_DEFAULT_SIZE 256
+
+// Size of a key: a digest in hexadecimal, with a NUL
+#define CACHE_KEY_SIZE (2 * SHA256_SIZE + 1)
+
+/*
+ * Computes the key of the output of a compilation.
+ *
+ * source: the source.
+ * options: the options of the compilation.
+ * key: where to leave the key (CACHE_KEY_SIZE characters).
+ *
+ */
+void cacheKey(SourceFile* source, struct stCli* options, char* key);
+
+/*
+ * Looks for an output in the cache, and if it is there, copies it to the
+ * output file. Either way, it counts as a hit or a miss.
+ *
+ * key: the key of the output.
+ * outputName: the name of the output file.
+ * returns: 1 if the output was found (and written), 0 otherwise.
+ *
+ */
+int fetchCachedOutput(char* key, char* outputName);
+
+/*
+ * Stores an output in the cache (if the cache can be written), and evicts
+ * the least recently used outputs if it grows too big.
+ *
+ * key: the key of the output.
+ * outputName: the name of the output file.
+ *
+ */
+void storeCachedOutput(char* key, char* outputName);
+
+/*
+ * Reads a file kept in the cache by the compiler (other than an output),
+ * which becomes the most recently used entry.
+ *
+ * key: the key of the file.
+ * size: where to leave the size of the file.
+ * returns: the contents of the file (to be freed by the caller), or NULL if
+ *   it is not in the cache.
+ *
+ */
+char* readCacheFile(char* key, long* size);
+
+/*
+ * Writes a file to the cache, replacing the one with the same key, and
+ * evicts the least recently used entries if the cache grows too big.
+ *
+ * key: the key of the file.
+ * data: the contents of the file.
+ * size: the size of the file.
+ *
+ */
+void writeCacheFile(char* key, char* data, long size);
+
+/*
+ * Prints the statistics of the cache: hits, misses, evictions, and the
+ * number and size of the entries.
+ *
+ * returns: 0 if they were printed, 1 if there is no cache.
+ *
+ */
+int printCacheStats();
+
+#endif
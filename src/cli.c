@@ -3,7 +3,7 @@
 #include <string.h>
 #include "cli.h"
 
-struct stCli cli;
+__thread struct stCli cli;
 
 void processCLArg(char* arg, int index);
 void setDefaultOptions();
@@ -23,16 +23,32 @@ void setDefaultOptions() {
   cli = (struct stCli) {
     .outputType = OUT_DEFAULT,
     .sourceIdx = -1,
-    .outputIdx = -1
+    .outputIdx = -1,
+    .batchIdx = -1,
+    .jobs = 0,
+    .hugePages = 0,
+    .nasm = 0,
+    .server = 0,
+    .client = 0,
+    .cache = 0,
+    .cacheStats = 0,
+    .incremental = 0,
+    .object = 0,
+    .link = 0
   };
 }
 
 void processCLArg(char* arg, int index) {
   int len = strlen(arg);
   if(len <= 0) return;
-  if(index == cli.outputIdx) return;
+  if(index == cli.outputIdx || index == cli.batchIdx) return;
 
   if(arg[0] == '-') { // command line option
+    if(len > 2 && arg[1] == 'j') { // number of threads, e.g. -j4
+      cli.jobs = atoi(arg + 2);
+      return;
+    }
+
     switch(len) {
       case 2:
         if(arg[1] == 's') cli.outputType = OUT_SILENT;
@@ -40,16 +56,31 @@ void processCLArg(char* arg, int index) {
         else if(arg[1] == 'V') displayVersion();
         else if(arg[1] == 'v') cli.outputType = OUT_VERBOSE;
         else if(arg[1] == 'o') cli.outputIdx = index + 1;
+        else if(arg[1] == 'c') cli.object = 1;
         break;
       case 6:
         if(strncmp("--help", arg, len) == 0)
         displayHelp();
+        else if(strncmp("--nasm", arg, len) == 0)
+          cli.nasm = 1;
+        else if(strncmp("--link", arg, len) == 0)
+          cli.link = 1;
+        break;
+      case 7:
+        if(strncmp("--batch", arg, len) == 0)
+          cli.batchIdx = index + 1;
+        else if(strncmp("--cache", arg, len) == 0)
+          cli.cache = 1;
         break;
       case 8:
         if(strncmp("--silent", arg, len) == 0)
           cli.outputType = OUT_SILENT;
         else if(strncmp("--cdebug", arg, len) == 0)
           cli.outputType = OUT_DEBUG;
+        else if(strncmp("--server", arg, len) == 0)
+          cli.server = 1;
+        else if(strncmp("--client", arg, len) == 0)
+          cli.client = 1;
         break;
       case 9:
         if(strncmp("--version", arg, len) == 0) {
@@ -62,6 +93,16 @@ void processCLArg(char* arg, int index) {
         if(strncmp("--graphviz", arg, len) == 0)
           cli.outputType = OUT_GRAPHVIZ;
         break;
+      case 11:
+        if(strncmp("--hugepages", arg, len) == 0)
+          cli.hugePages = 1;
+        break;
+      case 13:
+        if(strncmp("--cache-stats", arg, len) == 0)
+          cli.cacheStats = 1;
+        else if(strncmp("--incremental", arg, len) == 0)
+          cli.incremental = 1;
+        break;
     }
 
     return;
@@ -73,11 +114,36 @@ void displayHelp() {
   printf("ulpc -- The ulp compiler.\n"
     "Version: " VERSION "\n"
     "Usage: ulpc [options] file\n"
+    "       ulpc [options] --batch list\n"
+    "       ulpc [options] --link objects...\n"
     "Options:\n"
+    "  --batch <list>\t\tCompiles the sources in <list>, one per line (each\n"
+    "  \t\t\toptionally followed by its output file), on -j<n>\n"
+    "  \t\t\tthreads.\n"
+    "  --cache\t\tReuses the executable of the same source and options\n"
+    "  \t\t\tfrom the cache, at $ULPC_CACHE_DIR (default:\n"
+    "  \t\t\t~/.cache/ulpc), of at most $ULPC_CACHE_SIZE MiB.\n"
+    "  --cache-stats\t\tDisplays the hits and misses of the cache.\n"
+    "  -c\t\t\tOutputs an object file (default: the file with .o\n"
+    "  \t\t\tinstead of .ul) to be linked with --link.\n"
     "  --cdebug\t\tDebug mode. Displays lots of compiler debug information.\n"
+    "  --client\t\tHas the compile server compile the file, if it is\n"
+    "  \t\t\trunning (otherwise it is compiled as usual).\n"
     "  --graphviz\t\tOnly parses and outputs the AST in graphviz format.\n"
     "  --help, -h\t\tDisplays this help message.\n"
+    "  --hugepages\t\tUses huge pages for the compiler memory, if possible.\n"
+    "  --incremental\t\tReuses the code of the functions that did not change\n"
+    "  \t\t\tsince the file was last compiled (kept in the cache).\n"
+    "  --link\t\tLinks the object files given into an executable (with\n"
+    "  \t\t\tld if --nasm is given).\n"
+    "  -j<n>\t\t\tLexes big files (or compiles batches) using <n> threads\n"
+    "  \t\t\t(default: all cores).\n"
+    "  --nasm\t\tAssembles and links with nasm and ld (instead of writing\n"
+    "  \t\t\tthe executable directly).\n"
     "  -o <file>\t\tSets <file> as the output file.\n"
+    "  --server\t\tRuns as a compile server for --client, on -j<n> threads,\n"
+    "  \t\t\tat $ULPC_SOCKET (default: $XDG_RUNTIME_DIR/ulpc.sock, or\n"
+    "  \t\t\t$TMPDIR/ulpc-<uid>/ulpc.sock).\n"
     "  --silent, -s\t\tNo output (to stdout).\n"
     "  --verbose, -v\t\tDetailed output.\n"
     "  --version, -V\t\tDisplays the compiler version.\n"
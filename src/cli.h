@@ -27,9 +27,21 @@ struct stCli {
   short outputType;
   int sourceIdx;
   int outputIdx;
+  int batchIdx;  // list of sources to be compiled in a batch (-1: none)
+  int jobs;  // threads used to lex big files or batches (0: one per core)
+  char hugePages;  // back the compilation memory with huge pages
+  char nasm;  // assemble and link with nasm and ld (instead of built-in)
+  char server;  // run as a compile server (see server.h)
+  char client;  // have the compile server compile, if there is one
+  char cache;  // reuse the executables in the output cache (see cache.h)
+  char cacheStats;  // print the statistics of the output cache
+  char incremental;  // reuse the code of unchanged functions (incremental.h)
+  char object;  // output an object file to be linked with others (-c)
+  char link;  // link object files into an executable (see linker.h)
 };
 
-extern struct stCli cli;
+// Options of the compilation in progress in this thread
+extern __thread struct stCli cli;
 
 void parseCLArgs(int argc, char ** argv);
 
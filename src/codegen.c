@@ -6,21 +6,24 @@
 #include "ast.h"
 #include "cli.h"
 #include "scoper.h"
+#include "arena.h"
+#include "intern.h"
+#include "incremental.h"
 
-// initial length for the code string of a node, not considering user
-// defined identifiers
-#define INITIAL_CODE_SIZE 30
+__thread CodegenState codegenState;
 
-CodegenState codegenState;
+const Operand noOperand = { .type = OPD_NONE, .size = 0, .value = 0 };
 
 char getReg();
-char* getRegName(char regNum);
+Operand regOperand(char regNum);
+Operand labelOperand(int label);
 void freeReg(char regNum);
 void freeNodeReg(Node* node);
 void emitCode(Node* node);
 void emitForCode(Node* node);
 void emitWhileCode(Node* node);
 void emitExprCode(Node* node);
+int isOperand(Node* node);
 void emitAssignCode(Node* node);
 void emitIfCode(Node* node);
 void emitFunctionCode(Node* node);
@@ -28,43 +31,99 @@ void emitCallCode(Node* node);
 void emitDeclarationCode(Node* node);
 void emitStatementCode(Node* node);
 void emitProgramCode(Node* node);
+void emitHeaderCode(Node* node);
+char hasTopLevelCode(Node* node);
+int functionNameId(Node* node);
+void writeCode(Node* node);
 void createCgData(Node* node);
 void allocateReg(Node* node);
 void printRegs();
-void printNodeCode(Node* node);
 void pullChildCode(Node* node, int childNumber);
-char* getLabel();
+void appendCode(Node* node, Instruction* first, Instruction* last);
+BasicBlock* buildBlocks(Instruction* code);
+int getLabel();
 Node* getBreakable(Node* node);
 
-void codegenStart(FILE* file, char* filename, Node* ast) {
+void codegenStart(SourceFile* source, Node* ast, int outFd, char native) {
   codegenState = (CodegenState) {
-    .file = file,
-    .filename = filename,
-    .code = NULL,
-    .nLabels = 0
+    .source = source,
+    .arena = &compArena,
+    .nBlocks = 0,
+    .native = native,
+    .outFd = outFd,
+    .out = NULL,
+    .outSize = 0,
+    .outWritten = 0,
+    .nLabels = 0,
+    .entryPoint = 1
   };
 
   if(!ast) return; // empty program
 
+  // an object file only has an entry point if it has code outside functions
+  codegenState.entryPoint = !cli.object || hasTopLevelCode(ast);
+
+  // code generation data is kept in a side table of the AST
+  compAst.cgData = (CgData**) arenaAlloc(&compArena,
+    sizeof(CgData*) * compAst.nNodes);
+  memset(compAst.cgData, 0, sizeof(CgData*) * compAst.nNodes);
+  codegenState.out = (char*) arenaAlloc(&compArena,
+    sizeof(char) * OUTPUT_BUFFER_SIZE);
+  arenaInit(&codegenState.functionArena, 0);
+
   initializeRegisters();
-  postorderTraverse(ast, &emitCode);
+  if(native) initializeEncoder();
+  emitHeaderCode(ast);
+  writeCode(ast);
+
+  // each function is written as soon as its code is generated, so only the
+  // code of one function (and of the statements outside functions, which
+  // go at the end) is kept in memory
+  for(int i = 0; i < ast->nChildren; i++) {
+    Node* partNode = AST_CHILD(ast, i);
+
+    if(partNode->nChildren == 1
+       && AST_CHILD(partNode, 0)->type == NTExternFunction) continue;
+
+    if(partNode->nChildren == 1
+       && AST_CHILD(partNode, 0)->type == NTFunction) {
+      if(incrementalState.enabled) {
+        if(writeCachedFunction(ast, i)) continue;
+        startFunctionCode();
+      }
 
-  if(ast->cgData && ast->cgData->code) {
-    codegenState.code = ast->cgData->code;
-    printNodeCode(ast);
+      codegenState.arena = &codegenState.functionArena;
+      postorderTraverse(partNode, &emitCode);
+      writeCode(partNode);
+      if(incrementalState.enabled) endFunctionCode(ast, i);
+
+      AST_CGDATA(partNode) = NULL;
+      arenaReset(&codegenState.functionArena);
+      codegenState.arena = &compArena;
+    }
+    else postorderTraverse(partNode, &emitCode);
   }
-  else genericError("Code generator bug: no code generated");
+
+  emitCode(ast);
+  if(codegenState.entryPoint && (!AST_CGDATA(ast) || !AST_CGDATA(ast)->code))
+    genericError("Code generator bug: no code generated");
+
+  writeCode(ast);
+  flushCode();
+  if(native) finishMachineCode();
+  releaseCodegen();
+}
+
+void releaseCodegen() {
+  arenaRelease(&codegenState.functionArena);
+  releaseEncoder();
 }
 
 void emitCode(Node* node) {
-  if(node->type == NTExpression) {
+  if(node->type == NTExpression || node->type == NTLiteral
+     || (node->type == NTIdentifier && isOperand(node))) {
     emitExprCode(node);
   }
-  else if(node->type == NTCallParam) { // argument in function call
-    createCgData(node);
-    node->cgData->reg = node->children[0]->cgData->reg;
-    pullChildCode(node, 0);
-  }
   else if(node->type == NTCallSt || node->type == NTCallExpr) {
     emitCallCode(node);
   }
@@ -83,11 +142,12 @@ void emitCode(Node* node) {
     if(node->nChildren > 0) {
       pullChildCode(node, 0);
       appendInstruction(node, INS_SETRET,
-        getRegName(node->children[0]->cgData->reg), NULL);
-      freeNodeReg(node->children[0]);
+        regOperand(AST_CGDATA(AST_CHILD(node, 0))->reg), noOperand);
+      freeNodeReg(AST_CHILD(node, 0));
     }
 
-    appendInstruction(node, INS_JMP, ".epilogue", NULL);
+    appendInstruction(node, INS_JMP, labelOperand(LABEL_EPILOGUE),
+      noOperand);
   }
   else if(node->type == NTStatement) {
     emitStatementCode(node);
@@ -95,16 +155,19 @@ void emitCode(Node* node) {
   else if(node->type == NTLoopSt) {
     createCgData(node);
 
-    if(!node->cgData->nextLabel) {
-      node->cgData->nextLabel = getLabel();
+    if(AST_CGDATA(node)->nextLabel < 0) {
+      AST_CGDATA(node)->nextLabel = getLabel();
     }
 
-    appendInstruction(node, INS_LABEL, node->cgData->nextLabel, NULL);
+    appendInstruction(node, INS_LABEL,
+      labelOperand(AST_CGDATA(node)->nextLabel), noOperand);
     pullChildCode(node, 0);
-    appendInstruction(node, INS_JMP, node->cgData->nextLabel, NULL);
+    appendInstruction(node, INS_JMP,
+      labelOperand(AST_CGDATA(node)->nextLabel), noOperand);
 
-    if(node->cgData->breakLabel) {
-      appendInstruction(node, INS_LABEL, node->cgData->breakLabel, NULL);
+    if(AST_CGDATA(node)->breakLabel >= 0) {
+      appendInstruction(node, INS_LABEL,
+        labelOperand(AST_CGDATA(node)->breakLabel), noOperand);
     }
   }
   else if(node->type == NTWhileSt) {
@@ -120,12 +183,13 @@ void emitCode(Node* node) {
 
     // TODO: must check scope for break and next.
     if(!scopeNode) genericError("Code generation bug: breakable node missing.");
-    if(!scopeNode->cgData) createCgData(scopeNode);
-    if(!scopeNode->cgData->breakLabel) { // must create the break label
-      scopeNode->cgData->breakLabel = getLabel();
+    if(!AST_CGDATA(scopeNode)) createCgData(scopeNode);
+    if(AST_CGDATA(scopeNode)->breakLabel < 0) { // must create the label
+      AST_CGDATA(scopeNode)->breakLabel = getLabel();
     }
 
-    appendInstruction(node, INS_JMP, scopeNode->cgData->breakLabel, NULL);
+    appendInstruction(node, INS_JMP,
+      labelOperand(AST_CGDATA(scopeNode)->breakLabel), noOperand);
   }
   else if(node->type == NTNextSt) {
     createCgData(node);
@@ -133,16 +197,17 @@ void emitCode(Node* node) {
     Node* scopeNode = getBreakable(node);
 
     if(!scopeNode) genericError("Code generation bug: breakable node missing.");
-    if(!scopeNode->cgData) createCgData(scopeNode);
-    if(!scopeNode->cgData->nextLabel) { // must create the break label
-      scopeNode->cgData->nextLabel = getLabel();
+    if(!AST_CGDATA(scopeNode)) createCgData(scopeNode);
+    if(AST_CGDATA(scopeNode)->nextLabel < 0) { // must create the label
+      AST_CGDATA(scopeNode)->nextLabel = getLabel();
     }
 
-    appendInstruction(node, INS_JMP, scopeNode->cgData->nextLabel, NULL);
+    appendInstruction(node, INS_JMP,
+      labelOperand(AST_CGDATA(scopeNode)->nextLabel), noOperand);
   }
   else if(node->type == NTNoop) {
     createCgData(node);
-    appendInstruction(node, INS_NOP, NULL, NULL);
+    appendInstruction(node, INS_NOP, noOperand, noOperand);
   }
   else if(node->type == NTFunction) {
     emitFunctionCode(node);
@@ -164,53 +229,53 @@ void emitForCode(Node* node) {
   if(node->nChildren != 4)
     genericError("Code generator bug: 'for' node missing children.");
 
-  if(node->children[0]->type != NTDeclaration)
+  if(AST_CHILD(node, 0)->type != NTDeclaration)
     genericError("Code generator bug: declaration missing.");
 
   // TODO: for now only accepts binary operator conditions
-  if(node->children[1]->nChildren != 3)
-    genericError("Code generator bug: bad 'for' condition.");
-  if(node->children[1]->children[1]->type != NTBinaryOp)
+  if(AST_CHILD(node, 1)->type != NTExpression
+     || AST_CHILD(node, 1)->nChildren != 3)
     genericError("Code generator bug: bad 'for' condition.");
-  if(node->children[1]->children[1]->nChildren < 1)
-    genericError("Code generator bug: operator missing terminal node.");
-  if(!node->children[1]->children[1]->children[0]->token)
+  if(AST_CHILD(AST_CHILD(node, 1), 1)->token < 0)
     genericError("Code generator bug: terminal node missing token.");
 
-  Node* bodyNode = node->children[3];
+  Node* bodyNode = AST_CHILD(node, 3);
 
   // For statements in the global scope must allocate space on the stack
   // for their loop variable
   char hasEpilogue = 0;
 
-  if(isMlsNode(bodyNode) && node->parent->type != NTFunction
-     && bodyNode->symTable) {
+  if(isMlsNode(bodyNode) && AST_PARENT(node)->type != NTFunction
+     && AST_SYMTABLE(bodyNode)) {
     hasEpilogue = 1;
     // Save stack pointer as base pointer
-    appendInstruction(node, INS_PUSH, "rbp", NULL);
-    appendInstruction(node, INS_MOV, "rbp", "rsp");
+    appendInstruction(node, INS_PUSH, makeOperand(OPD_FP, 0), noOperand);
+    appendInstruction(node, INS_MOV, makeOperand(OPD_FP, 0),
+      makeOperand(OPD_SP, 0));
 
     // allocate space in the stack for the variables
     // TODO: size 4 fixed here
     // TODO: remove mention to RSP from here
-    char stackSpace[10];
-    sprintf(stackSpace, "%d", bodyNode->symTable->nLocalVars * 4);
-    appendInstruction(node, INS_SUB, "rsp", stackSpace);
+    appendInstruction(node, INS_SUB, makeOperand(OPD_SP, 0),
+      makeOperand(OPD_IMM, AST_SYMTABLE(bodyNode)->nLocalVars * 4));
   }
 
   pullChildCode(node, 0); // declaration
 
-  if(!node->cgData->nextLabel) node->cgData->nextLabel = getLabel();
-  if(!node->cgData->breakLabel) node->cgData->breakLabel = getLabel();
+  if(AST_CGDATA(node)->nextLabel < 0)
+    AST_CGDATA(node)->nextLabel = getLabel();
+  if(AST_CGDATA(node)->breakLabel < 0)
+    AST_CGDATA(node)->breakLabel = getLabel();
 
-  char* condLabel = getLabel();
-  appendInstruction(node, INS_JMP, condLabel, NULL);
-  appendInstruction(node, INS_LABEL, node->cgData->nextLabel, NULL);
+  int condLabel = getLabel();
+  appendInstruction(node, INS_JMP, labelOperand(condLabel), noOperand);
+  appendInstruction(node, INS_LABEL,
+    labelOperand(AST_CGDATA(node)->nextLabel), noOperand);
   pullChildCode(node, 2); // iteration statement
-  appendInstruction(node, INS_LABEL, condLabel, NULL);
+  appendInstruction(node, INS_LABEL, labelOperand(condLabel), noOperand);
 
   // TODO: refactor this snippet, it appears in many places
-  TokenType opType = node->children[1]->children[1]->children[0]->token->type;
+  TokenType opType = AST_TOKEN(AST_CHILD(AST_CHILD(node, 1), 1))->type;
   InstructionType iType = INS_NOP;
 
   switch(opType) {
@@ -221,13 +286,16 @@ void emitForCode(Node* node) {
     case TTLEq: iType = INS_JG; break;
   }
   pullChildCode(node, 1); // for condition
-  appendInstruction(node, iType, node->cgData->breakLabel, NULL);
+  appendInstruction(node, iType, labelOperand(AST_CGDATA(node)->breakLabel),
+    noOperand);
   pullChildCode(node, 3); // body
-  appendInstruction(node, INS_JMP, node->cgData->nextLabel, NULL);
-  appendInstruction(node, INS_LABEL, node->cgData->breakLabel, NULL);
+  appendInstruction(node, INS_JMP,
+    labelOperand(AST_CGDATA(node)->nextLabel), noOperand);
+  appendInstruction(node, INS_LABEL,
+    labelOperand(AST_CGDATA(node)->breakLabel), noOperand);
 
   if(hasEpilogue) {
-    appendInstruction(node, INS_POP, "rbp", NULL);
+    appendInstruction(node, INS_POP, makeOperand(OPD_FP, 0), noOperand);
   }
 }
 
@@ -238,22 +306,22 @@ void emitWhileCode(Node* node) {
     genericError("Code generator bug: 'while' node missing children.");
 
   // TODO: for now only accepts binary operator conditions
-  if(node->children[0]->nChildren != 3)
+  if(AST_CHILD(node, 0)->type != NTExpression
+     || AST_CHILD(node, 0)->nChildren != 3)
     genericError("Code generator bug: bad 'while' condition.");
-  if(node->children[0]->children[1]->type != NTBinaryOp)
-    genericError("Code generator bug: bad 'while' condition.");
-  if(node->children[0]->children[1]->nChildren < 1)
-    genericError("Code generator bug: operator missing terminal node.");
-  if(!node->children[0]->children[1]->children[0]->token)
+  if(AST_CHILD(AST_CHILD(node, 0), 1)->token < 0)
     genericError("Code generator bug: terminal node missing token.");
 
-  if(!node->cgData->nextLabel) node->cgData->nextLabel = getLabel();
-  if(!node->cgData->breakLabel) node->cgData->breakLabel = getLabel();
+  if(AST_CGDATA(node)->nextLabel < 0)
+    AST_CGDATA(node)->nextLabel = getLabel();
+  if(AST_CGDATA(node)->breakLabel < 0)
+    AST_CGDATA(node)->breakLabel = getLabel();
 
-  appendInstruction(node, INS_LABEL, node->cgData->nextLabel, NULL);
+  appendInstruction(node, INS_LABEL,
+    labelOperand(AST_CGDATA(node)->nextLabel), noOperand);
   pullChildCode(node, 0); // condition
 
-  TokenType opType = node->children[0]->children[1]->children[0]->token->type;
+  TokenType opType = AST_TOKEN(AST_CHILD(AST_CHILD(node, 0), 1))->type;
   InstructionType iType = INS_NOP;
 
   switch(opType) {
@@ -263,10 +331,13 @@ void emitWhileCode(Node* node) {
     case TTLess: iType = INS_JGE; break;
     case TTLEq: iType = INS_JG; break;
   }
-  appendInstruction(node, iType, node->cgData->breakLabel, NULL);
+  appendInstruction(node, iType, labelOperand(AST_CGDATA(node)->breakLabel),
+    noOperand);
   pullChildCode(node, 1); // body
-  appendInstruction(node, INS_JMP, node->cgData->nextLabel, NULL);
-  appendInstruction(node, INS_LABEL, node->cgData->breakLabel, NULL);
+  appendInstruction(node, INS_JMP,
+    labelOperand(AST_CGDATA(node)->nextLabel), noOperand);
+  appendInstruction(node, INS_LABEL,
+    labelOperand(AST_CGDATA(node)->breakLabel), noOperand);
 }
 
 void emitCallCode(Node* node) {
@@ -275,7 +346,7 @@ void emitCallCode(Node* node) {
   if(node->nChildren < 1)
     genericError("Code generation bug: AST call node without function name.");
 
-  if(!node->children[0]->children[0]->token)
+  if(AST_CHILD(AST_CHILD(node, 0), 0)->token < 0)
     genericError("Code generation bug: AST node missing token.");
 
   // pulls code for each argument expression
@@ -289,54 +360,53 @@ void emitCallCode(Node* node) {
   if(node->nChildren > 1) {
     for(int i = 0; i < node->nChildren - 1; i++) {
       appendInstruction(node, INS_MOV,
-        getArgRegName(i),
-        getRegName(node->children[i + 1]->cgData->reg));
-      freeNodeReg(node->children[i + 1]);
+        getArgReg(i),
+        regOperand(AST_CGDATA(AST_CHILD(node, i + 1))->reg));
+      freeNodeReg(AST_CHILD(node, i + 1));
     }
   }
 
   // call instruction
-  char* funcName = node->children[0]->children[0]->token->name;
-  appendInstruction(node, INS_CALL, funcName, NULL);
+  int funcName = AST_TOKEN(AST_CHILD(AST_CHILD(node, 0), 0))->id;
+  appendInstruction(node, INS_CALL, makeOperand(OPD_NAME, funcName),
+    noOperand);
 
   // copy return value to a register
   if(node->type == NTCallExpr) {
     allocateReg(node);
-    appendInstruction(node, INS_GETRET, getRegName(node->cgData->reg), NULL);
+    appendInstruction(node, INS_GETRET, regOperand(AST_CGDATA(node)->reg),
+      noOperand);
   }
 }
 
 void emitDeclarationCode(Node* node) {
   if(node->nChildren == 3) { // declaration with assignment
-    if(!node->children[2]->cgData)
+    if(!AST_CGDATA(AST_CHILD(node, 2)))
       genericError("Code generation bug: AST node without code info.");
 
-    if(node->children[1]->nChildren < 1)
+    if(AST_CHILD(node, 1)->nChildren < 1)
       genericError("Code generation bug: AST identifier node without child.");
 
-    if(!node->children[1]->children[0]->token)
+    if(AST_CHILD(AST_CHILD(node, 1), 0)->token < 0)
       genericError("Code generation bug: AST node missing token.");
 
-    if(node->children[2]->type != NTExpression)
-      genericError("Code generation bug: expression expected.");
-
-    Token* varToken = node->children[1]->children[0]->token;
-    Symbol* varSym = lookupSymbol(node, varToken);
+    Symbol* varSym = AST_SYMBOL(AST_CHILD(node, 1));
     if(!varSym) genericError("Code generation bug: symbol not found.");
 
     createCgData(node);
     pullChildCode(node, 2);
     appendInstruction(node, INS_MOV,
-      getSymbolRef(varSym, node),
-      getRegName(node->children[2]->cgData->reg));
-    freeNodeReg(node->children[2]);
+      getSymbolRef(varSym),
+      regOperand(AST_CGDATA(AST_CHILD(node, 2))->reg));
+    freeNodeReg(AST_CHILD(node, 2));
   }
 }
 
 void emitStatementCode(Node* node) {
   createCgData(node);
 
-  if(node->parent && node->parent->type == NTForSt && whichChild(node) == 3) {
+  if(node->parent >= 0 && AST_PARENT(node)->type == NTForSt
+     && whichChild(node) == 3) {
     // pulls code from children statements
     for(int i = 0; i < node->nChildren; i++) {
       pullChildCode(node, i);
@@ -348,25 +418,25 @@ void emitStatementCode(Node* node) {
     char statementBlock = 1;
 
     for(int i = 0; i < node->nChildren; i++) {
-      if(node->children[i]->type != NTStatement) statementBlock = 0;
+      if(AST_CHILD(node, i)->type != NTStatement) statementBlock = 0;
     }
 
     char hasEpilogue = 0;
 
     if(statementBlock) {
-      if(isMlsNode(node) && node->parent->type != NTFunction
-         && node->symTable) {
+      if(isMlsNode(node) && AST_PARENT(node)->type != NTFunction
+         && AST_SYMTABLE(node)) {
         hasEpilogue = 1;
         // Save stack pointer as base pointer
-        appendInstruction(node, INS_PUSH, "rbp", NULL);
-        appendInstruction(node, INS_MOV, "rbp", "rsp");
+        appendInstruction(node, INS_PUSH, makeOperand(OPD_FP, 0), noOperand);
+        appendInstruction(node, INS_MOV, makeOperand(OPD_FP, 0),
+          makeOperand(OPD_SP, 0));
 
         // allocate space in the stack for the variables
         // TODO: size 4 fixed here
         // TODO: remove mention to RSP from here
-        char stackSpace[10];
-        sprintf(stackSpace, "%d", node->symTable->nLocalVars * 4);
-        appendInstruction(node, INS_SUB, "rsp", stackSpace);
+        appendInstruction(node, INS_SUB, makeOperand(OPD_SP, 0),
+          makeOperand(OPD_IMM, AST_SYMTABLE(node)->nLocalVars * 4));
       }
 
       // pulls code from children statements
@@ -375,114 +445,139 @@ void emitStatementCode(Node* node) {
       }
 
       if(hasEpilogue) {
-        appendInstruction(node, INS_POP, "rbp", NULL);
+        appendInstruction(node, INS_POP, makeOperand(OPD_FP, 0), noOperand);
       }
     }
   }
 }
 
-void emitProgramCode(Node* node) {
+void emitHeaderCode(Node* node) {
   createCgData(node);
 
   // .bss section
-  if(node->symTable) {
-    appendInstruction(node, INS_SECTION, "bss", NULL);
+  if(AST_SYMTABLE(node)) {
+    appendInstruction(node, INS_SECTION, makeOperand(OPD_SECTION, SECTION_BSS),
+      noOperand);
 
-    for(int i = 0; i < node->symTable->nSymbols; i++) {
-      if(node->symTable->symbols[i]->type == STGlobal) {
-        declareGlobalVar(node, node->symTable->symbols[i]->token->name, 4);
-      }
+    for(int i = 0; i < AST_SYMTABLE(node)->nSymbols; i++) {
+      if(AST_SYMTABLE(node)->symbols[i].type == STGlobal)
+        declareGlobalVar(node, AST_SYMTABLE(node)->symbols[i].id, 4);
     }
   }
 
   // .text section header
-  appendInstruction(node, INS_SECTION, "text", NULL);
-  appendInstruction(node, INS_GLOBAL, "_start", NULL);
+  appendInstruction(node, INS_SECTION, makeOperand(OPD_SECTION, SECTION_TEXT),
+    noOperand);
+  if(codegenState.entryPoint)
+    appendInstruction(node, INS_GLOBAL, makeOperand(OPD_ENTRY, 0), noOperand);
 
-  // first pulls code from functions
+  // functions seen by other modules, and those defined in them
   for(int i = 0; i < node->nChildren; i++) {
-    if(node->children[i]->type == NTProgramPart
-       && node->children[i]->nChildren == 1
-       && node->children[i]->children[0]->type == NTFunction
-       && node->children[i]->cgData
-       && node->children[i]->cgData->code) {
-      pullChildCode(node, i);
+    if(AST_CHILD(node, i)->nChildren != 1) continue;
+    Node* partNode = AST_CHILD(AST_CHILD(node, i), 0);
+
+    if(partNode->type == NTFunction && partNode->nChildren == 4) {
+      appendInstruction(node, INS_GLOBAL,
+        makeOperand(OPD_NAME, functionNameId(partNode)), noOperand);
+    } else if(partNode->type == NTExternFunction) {
+      appendInstruction(node, INS_EXTERN,
+        makeOperand(OPD_NAME, functionNameId(partNode)), noOperand);
     }
   }
+}
 
-  appendInstruction(node, INS_LABEL, "_start", NULL);
+char hasTopLevelCode(Node* node) {
+  for(int i = 0; i < node->nChildren; i++) {
+    if(AST_CHILD(node, i)->nChildren != 1) continue;
+    Node* partNode = AST_CHILD(AST_CHILD(node, i), 0);
+
+    // global variables are initialized by the code of the entry point
+    if(partNode->type == NTStatement
+       || (partNode->type == NTDeclaration && partNode->nChildren == 3))
+      return 1;
+  }
+  return 0;
+}
+
+int functionNameId(Node* node) {
+  return AST_TOKEN(AST_CHILD(AST_CHILD(node, 0), 0))->id;
+}
+
+void emitProgramCode(Node* node) {
+  createCgData(node);
+  if(!codegenState.entryPoint) return; // a module with only functions
+
+  // the code of the functions was already written: the entry point runs
+  // the other children
+  appendInstruction(node, INS_LABEL, makeOperand(OPD_ENTRY, 0), noOperand);
 
-  // then pulls code from other children
   for(int i = 0; i < node->nChildren; i++) {
-    if(node->children[i]->type == NTProgramPart
-       && node->children[i]->nChildren == 1
-       && node->children[i]->children[0]->type != NTFunction
-       && node->children[i]->cgData
-       && node->children[i]->cgData->code) {
+    if(AST_CHILD(node, i)->type == NTProgramPart
+       && AST_CHILD(node, i)->nChildren == 1
+       && AST_CHILD(AST_CHILD(node, i), 0)->type != NTFunction
+       && AST_CGDATA(AST_CHILD(node, i))
+       && AST_CGDATA(AST_CHILD(node, i))->code) {
       pullChildCode(node, i);
     }
   }
 
   // exit syscall
-  appendInstruction(node, INS_EXIT, "0", NULL);
+  appendInstruction(node, INS_EXIT, makeOperand(OPD_IMM, 0), noOperand);
 }
 
 void emitFunctionCode(Node* node) {
   createCgData(node);
 
-  // create label with function name
-  if(node->nChildren != 3)
+  // create label with function name (an exported one has a fourth child)
+  if(node->nChildren != 3 && node->nChildren != 4)
     genericError("Code generator bug: bad function AST node (missing "
       "children).");
 
-  if(node->children[0]->type != NTIdentifier)
+  if(AST_CHILD(node, 0)->type != NTIdentifier)
     genericError("Code generator bug: bad function AST node (identifier "
       "expected).");
 
-  if(node->children[1]->type != NTArgList)
+  if(AST_CHILD(node, 1)->type != NTArgList)
     genericError("Code generator bug: bad function AST node (parameter "
       "declaration expected).");
 
-  if(node->children[2]->type != NTStatement)
+  if(AST_CHILD(node, 2)->type != NTStatement)
     genericError("Code generator bug: bad function AST node (statement "
       "expected).");
 
-  if(node->children[0]->nChildren != 1)
+  if(AST_CHILD(node, 0)->nChildren != 1)
     genericError("Code generator bug: bad function AST node (ID node "
       "without child node).");
 
-  if(!node->children[0]->children[0]->token)
+  if(AST_CHILD(AST_CHILD(node, 0), 0)->token < 0)
     genericError("Code generator bug: bad function AST node (terminal node "
       "without token).");
 
-  char* fName = node->children[0]->children[0]->token->name;
-  appendInstruction(node, INS_LABEL, fName, NULL);
+  int fName = AST_TOKEN(AST_CHILD(AST_CHILD(node, 0), 0))->id;
+  appendInstruction(node, INS_LABEL, makeOperand(OPD_NAME, fName), noOperand);
 
   // allocate stack space for arguments and local variables if needed
-  char stackSpace[10];
-  Node* mlsNode = getMlsNode(node->children[2]);
+  Node* mlsNode = getMlsNode(AST_CHILD(node, 2));
 
-  if(mlsNode && mlsNode->symTable) {
-    sprintf(stackSpace, "%d", mlsNode->symTable->nStackVars * 4);
-    appendInstruction(node, INS_PROLOGUE_STACK, stackSpace, NULL);
+  if(mlsNode && AST_SYMTABLE(mlsNode)) {
+    appendInstruction(node, INS_PROLOGUE_STACK,
+      makeOperand(OPD_IMM, AST_SYMTABLE(mlsNode)->nStackVars * 4), noOperand);
 
     // move arguments to stack
-    for(int i = 0; i < mlsNode->symTable->nSymbols; i++) {
-      Symbol* argSym = mlsNode->symTable->symbols[i];
+    for(int i = 0; i < AST_SYMTABLE(mlsNode)->nSymbols; i++) {
+      Symbol* argSym = &AST_SYMTABLE(mlsNode)->symbols[i];
       if(argSym->type == STArg) {
-        char* regName = getArgRegName(argSym->pos);
         appendInstruction(node, INS_MOV,
-          getSymbolRef(argSym, node),
-          regName);
-        free(regName);
+          getSymbolRef(argSym),
+          getArgReg(argSym->pos));
       }
     }
   }
-  else appendInstruction(node, INS_PROLOGUE, NULL, NULL);
+  else appendInstruction(node, INS_PROLOGUE, noOperand, noOperand);
 
   // pull code from function body
   pullChildCode(node, 2);
-  appendInstruction(node, INS_EPILOGUE, NULL, NULL);
+  appendInstruction(node, INS_EPILOGUE, noOperand, noOperand);
 }
 
 void emitIfCode(Node* node) {
@@ -490,28 +585,24 @@ void emitIfCode(Node* node) {
   if(node->nChildren < 2)
     genericError("Compiler bug: AST 'if' node missing children.");
 
-  Node* condNode = node->children[0];
-  Node* thenNode = node->children[1];
-  Node* elsedNode = node->children[2];
+  Node* condNode = AST_CHILD(node, 0);
+  Node* thenNode = AST_CHILD(node, 1);
+  Node* elsedNode = AST_CHILD(node, 2);
 
   createCgData(node);
   pullChildCode(node, 0); // comparison
 
-  if(condNode->type != NTExpression)
-    genericError("Compiler bug: expression not found for 'if' condition.");
-
-  if(condNode->nChildren == 3) { // binary expression
-    if(condNode->children[1]->nChildren < 1
-       || condNode->children[1]->children[0]->type != NTTerminal
-       || !condNode->children[1]->children[0]->token)
+  if(condNode->type == NTExpression && condNode->nChildren == 3) { // binary
+    if(AST_CHILD(condNode, 1)->type != NTTerminal
+       || AST_CHILD(condNode, 1)->token < 0)
       genericError("Compiler bug: operator missing.");
 
     char hasElse = (node->nChildren == 3);
-    char* elseLabel = getLabel();
-    char* endLabel = getLabel();
+    int elseLabel = getLabel();
+    int endLabel = getLabel();
 
-    TokenType opType = condNode->children[1]->children[0]->token->type;
-    char* jmpTo = endLabel;
+    TokenType opType = AST_TOKEN(AST_CHILD(condNode, 1))->type;
+    int jmpTo = endLabel;
     if(hasElse) jmpTo = elseLabel;
     InstructionType iType = INS_NOP;
 
@@ -522,160 +613,157 @@ void emitIfCode(Node* node) {
       case TTLess: iType = INS_JGE; break;
       case TTLEq: iType = INS_JG; break;
     }
-    appendInstruction(node, iType, jmpTo, NULL);
+    appendInstruction(node, iType, labelOperand(jmpTo), noOperand);
     pullChildCode(node, 1); // THEN code
 
     if(hasElse) {
-      appendInstruction(node, INS_JMP, endLabel, NULL);
-      appendInstruction(node, INS_LABEL, elseLabel, NULL);
+      appendInstruction(node, INS_JMP, labelOperand(endLabel), noOperand);
+      appendInstruction(node, INS_LABEL, labelOperand(elseLabel), noOperand);
       pullChildCode(node, 2); // ELSE code
     }
 
-    appendInstruction(node, INS_LABEL, endLabel, NULL);
+    appendInstruction(node, INS_LABEL, labelOperand(endLabel), noOperand);
 
-    free(elseLabel);
-    free(endLabel);
   }
 }
 
 void emitAssignCode(Node* node) {
   if(node->nChildren == 3) {
-    if(!node->children[2]->cgData)
+    if(!AST_CGDATA(AST_CHILD(node, 2)))
       genericError("Code generation bug: AST node without code info.");
 
-    if(node->children[0]->nChildren < 1)
+    if(AST_CHILD(node, 0)->nChildren < 1)
       genericError("Code generation bug: AST identifier node without child.");
 
-    if(!node->children[0]->children[0]->token)
+    if(AST_CHILD(AST_CHILD(node, 0), 0)->token < 0)
       genericError("Code generation bug: AST node missing token.");
 
-    if(node->children[2]->type != NTExpression)
-      genericError("Code generation bug: expression expected.");
-
-    Token* varToken = node->children[0]->children[0]->token;
-    Symbol* varSym = lookupSymbol(node, varToken);
+    Symbol* varSym = AST_SYMBOL(AST_CHILD(node, 0));
     if(!varSym) genericError("Code generation bug: symbol not found.");
 
     createCgData(node);
     pullChildCode(node, 2);
 
-    if(node->children[1]->token->type == TTAssign) {
+    if(AST_TOKEN(AST_CHILD(node, 1))->type == TTAssign) {
       appendInstruction(node, INS_MOV,
-        getSymbolRef(varSym, node),
-        getRegName(node->children[2]->cgData->reg));
+        getSymbolRef(varSym),
+        regOperand(AST_CGDATA(AST_CHILD(node, 2))->reg));
     }
-    else if(node->children[1]->token->type == TTAdd ||
-            node->children[1]->token->type == TTSub) {
+    else if(AST_TOKEN(AST_CHILD(node, 1))->type == TTAdd ||
+            AST_TOKEN(AST_CHILD(node, 1))->type == TTSub) {
       InstructionType iType =
-        (node->children[1]->token->type == TTAdd) ? INS_ADD : INS_SUB;
+        (AST_TOKEN(AST_CHILD(node, 1))->type == TTAdd) ? INS_ADD : INS_SUB;
 
       allocateReg(node);
       appendInstruction(node, INS_MOV,
-        getRegName(node->cgData->reg),
-        getSymbolRef(varSym, node));
+        regOperand(AST_CGDATA(node)->reg),
+        getSymbolRef(varSym));
       appendInstruction(node, iType,
-        getRegName(node->cgData->reg),
-        getRegName(node->children[2]->cgData->reg));
+        regOperand(AST_CGDATA(node)->reg),
+        regOperand(AST_CGDATA(AST_CHILD(node, 2))->reg));
       appendInstruction(node, INS_MOV,
-        getSymbolRef(varSym, node),
-        getRegName(node->cgData->reg));
+        getSymbolRef(varSym),
+        regOperand(AST_CGDATA(node)->reg));
       freeNodeReg(node);
     }
 
-    freeNodeReg(node->children[2]);
+    freeNodeReg(AST_CHILD(node, 2));
   }
   else if(node->nChildren == 2) { // x++  or  x--
-    if(node->children[1]->type != NTTerminal)
+    if(AST_CHILD(node, 1)->type != NTTerminal)
       genericError("Code generation bug: terminal symbol expected.");
 
     InstructionType iType = INS_INC;
-    if(node->children[1]->token->type == TTDecr) iType = INS_DEC;
+    if(AST_TOKEN(AST_CHILD(node, 1))->type == TTDecr) iType = INS_DEC;
 
-    if(node->children[0]->nChildren < 1)
+    if(AST_CHILD(node, 0)->nChildren < 1)
       genericError("Code generation bug: AST identifier node without child.");
 
-    if(!node->children[0]->children[0]->token)
+    if(AST_CHILD(AST_CHILD(node, 0), 0)->token < 0)
       genericError("Code generation bug: AST node missing token.");
 
-    Token* varToken = node->children[0]->children[0]->token;
-    Symbol* varSym = lookupSymbol(node, varToken);
+    Symbol* varSym = AST_SYMBOL(AST_CHILD(node, 0));
     if(!varSym) genericError("Code generation bug: symbol not found.");
 
     createCgData(node);
-    appendInstruction(node, iType, getSymbolSizeRef(varSym, node), NULL);
+    appendInstruction(node, iType, getSymbolSizeRef(varSym), noOperand);
   }
 }
 
 void emitExprCode(Node* node) {
-  if(node->nChildren == 1) {
-    Node* litOrIdNode = node->children[0];
-    Token* token = litOrIdNode->children[0]->token;
+  if(node->type != NTExpression) { // literal or variable
+    Token* token = AST_TOKEN(AST_CHILD(node, 0));
 
-    if(node->children[0]->type == NTLiteral) {
+    if(node->type == NTLiteral) {
       // TODO for now this only works for int and bool
       createCgData(node);
       allocateReg(node);
 
-      char* litValue = token->name;
-      if(token->type == TTTrue) litValue = "1";
-      else if(token->type == TTFalse) litValue = "0";
+      if(token->type == TTTrue) {
+        appendInstruction(node, INS_MOV, regOperand(AST_CGDATA(node)->reg),
+          makeOperand(OPD_IMM, 1));
+      } else if(token->type == TTFalse) {
+        appendInstruction(node, INS_MOV, regOperand(AST_CGDATA(node)->reg),
+          makeOperand(OPD_IMM, 0));
+      } else if(token->type == TTLitInt) {
+        char* text = tokenText(codegenState.source, token);
+        long value = 0;
+        for(int i = 0; i < token->nameSize; i++)
+          value = value * 10 + (text[i] - '0');
 
-      appendInstruction(node, INS_MOV,
-        getRegName(node->cgData->reg), litValue);
-    } else if(node->children[0]->type == NTIdentifier) {
+        appendInstruction(node, INS_MOV,
+          regOperand(AST_CGDATA(node)->reg), makeOperand(OPD_IMM, value));
+      } else { // other literals are copied from the source
+        appendInstruction(node, INS_MOV, regOperand(AST_CGDATA(node)->reg),
+          makeOperand(OPD_LITERAL, AST_CHILD(node, 0)->token));
+      }
+    } else {
       createCgData(node);
-      Symbol* varSym = lookupSymbol(node, token);
+      Symbol* varSym = AST_SYMBOL(node);
       if(!varSym) genericError("Code generation bug: symbol not found.");
 
       // load the variable in a register
       allocateReg(node);
       appendInstruction(node, INS_MOV,
-        getRegName(node->cgData->reg),
-        getSymbolRef(varSym, node));
-    } else if(node->children[0]->type == NTCallExpr) {
-      createCgData(node);
-      pullChildCode(node, 0);
-      node->cgData->reg = node->children[0]->cgData->reg;
+        regOperand(AST_CGDATA(node)->reg),
+        getSymbolRef(varSym));
     }
   }
   else if(node->nChildren == 2) {
-    if(node->children[0]->type == NTBinaryOp) {
-      Token* opToken = node->children[0]->children[0]->token;
+    Token* opToken = AST_TOKEN(AST_CHILD(node, 0));
 
-      if(!opToken)
-        genericError("Code generation bug: missing minus token.");
+    if(!opToken)
+      genericError("Code generation bug: missing operator token.");
 
-      if(opToken->type == TTMinus) { // - EXPR
-        createCgData(node);
+    if(opToken->type == TTMinus) { // - EXPR
+      createCgData(node);
 
-        if(!node->children[1]->cgData)
-          genericError("Code generation bug: AST node without code info.");
+      if(!AST_CGDATA(AST_CHILD(node, 1)))
+        genericError("Code generation bug: AST node without code info.");
 
-        pullChildCode(node, 1);
-        node->cgData->reg = node->children[1]->cgData->reg;
-        appendInstruction(node, INS_NEG,
-          getRegName(node->children[1]->cgData->reg), NULL);
-      }
-    } else if(node->children[0]->type == NTTerminal &&
-              node->children[0]->token->type == TTNot) { // not EXPR
+      pullChildCode(node, 1);
+      AST_CGDATA(node)->reg = AST_CGDATA(AST_CHILD(node, 1))->reg;
+      appendInstruction(node, INS_NEG,
+        regOperand(AST_CGDATA(AST_CHILD(node, 1))->reg), noOperand);
+    } else if(opToken->type == TTNot) { // not EXPR
       createCgData(node);
 
-      if(!node->children[1]->cgData)
+      if(!AST_CGDATA(AST_CHILD(node, 1)))
         genericError("Code generation bug: AST node without code info.");
 
       pullChildCode(node, 1);
-      node->cgData->reg = node->children[1]->cgData->reg;
+      AST_CGDATA(node)->reg = AST_CGDATA(AST_CHILD(node, 1))->reg;
       appendInstruction(node, INS_NOT,
-        getRegName(node->children[1]->cgData->reg), NULL);
-      freeNodeReg(node->children[1]);
+        regOperand(AST_CGDATA(AST_CHILD(node, 1))->reg), noOperand);
+      freeNodeReg(AST_CHILD(node, 1));
     }
   }
   else if(node->nChildren == 3) {
-    if(node->children[1]->type == NTBinaryOp) { // binary operation
-      Token* opToken = node->children[1]->children[0]->token;
+    if(AST_CHILD(node, 1)->token >= 0) { // binary operation
+      Token* opToken = AST_TOKEN(AST_CHILD(node, 1));
       createCgData(node);
 
-      if(!node->children[0]->cgData || !node->children[2]->cgData) {
+      if(!AST_CGDATA(AST_CHILD(node, 0)) || !AST_CGDATA(AST_CHILD(node, 2))) {
         genericError("Code generation bug: AST node without code info.");
       }
 
@@ -684,16 +772,17 @@ void emitExprCode(Node* node) {
 
       if(opToken->type == TTDiv || opToken->type == TTMod) { // division/mod
         appendInstruction(node, INS_DIVISION,
-          getRegName(node->children[0]->cgData->reg),
-          getRegName(node->children[2]->cgData->reg));
+          regOperand(AST_CGDATA(AST_CHILD(node, 0))->reg),
+          regOperand(AST_CGDATA(AST_CHILD(node, 2))->reg));
 
-        node->cgData->reg = node->children[0]->cgData->reg;
+        AST_CGDATA(node)->reg = AST_CGDATA(AST_CHILD(node, 0))->reg;
 
         InstructionType iType = (opToken->type == TTDiv) ?
           INS_GETQUOTIENT : INS_GETREMAINDER;
 
-        appendInstruction(node, iType, getRegName(node->cgData->reg), NULL);
-        freeNodeReg(node->children[2]);
+        appendInstruction(node, iType,
+          regOperand(AST_CGDATA(node)->reg), noOperand);
+        freeNodeReg(AST_CHILD(node, 2));
       } else { // other binary operations
         InstructionType iType;
 
@@ -715,43 +804,128 @@ void emitExprCode(Node* node) {
             break;
         }
 
-        node->cgData->reg = node->children[0]->cgData->reg;
+        AST_CGDATA(node)->reg = AST_CGDATA(AST_CHILD(node, 0))->reg;
         appendInstruction(node, iType,
-          getRegName(node->children[0]->cgData->reg),
-          getRegName(node->children[2]->cgData->reg));
-        freeNodeReg(node->children[2]);
+          regOperand(AST_CGDATA(AST_CHILD(node, 0))->reg),
+          regOperand(AST_CGDATA(AST_CHILD(node, 2))->reg));
+        freeNodeReg(AST_CHILD(node, 2));
       }
     }
   }
 }
 
-char* getLabel() {
-  char* label = (char*) malloc(sizeof(char) * 8);
-  sprintf(label, ".l%d", codegenState.nLabels);
-  codegenState.nLabels++;
-  return label;
+/*
+ * Tells whether an identifier stands for the value of a variable (e.g. in
+ * an expression or as an argument), rather than for a name that is being
+ * declared, assigned or called.
+ *
+ */
+int isOperand(Node* node) {
+  Node* parent = AST_PARENT(node);
+
+  switch(parent->type) {
+    case NTFunction:
+    case NTArg:
+      return 0;
+    case NTDeclaration:
+      return AST_CHILD(parent, 1) != node;
+    case NTAssignment:
+    case NTCallSt:
+    case NTCallExpr:
+      return AST_CHILD(parent, 0) != node;
+    default:
+      return 1;
+  }
+}
+
+int getLabel() {
+  return codegenState.nLabels++;
 }
 
 void pullChildCode(Node* node, int childNumber) {
-  if(node->children[childNumber]->cgData &&
-     node->children[childNumber]->cgData->code) {
-    appendNodeCode(node, node->children[childNumber]->cgData->code);
-    free(node->children[childNumber]->cgData->code);
+  CgData* child = AST_CGDATA(AST_CHILD(node, childNumber));
+
+  if(child && child->code) {
+    appendCode(node, child->code, child->lastCode);
+
+    // the instructions now belong to the parent
+    child->code = NULL;
+    child->lastCode = NULL;
   }
 }
 
-char* getRegName(char regNum) {
-  return codegenState.nameGPR[regNum];
+void appendCode(Node* node, Instruction* first, Instruction* last) {
+  CgData* cgData = AST_CGDATA(node);
+
+  if(cgData->lastCode) cgData->lastCode->next = first;
+  else cgData->code = first;
+  cgData->lastCode = last;
+}
+
+void appendInstruction(Node* node, InstructionType inst, Operand op1,
+                       Operand op2) {
+  Instruction* ins = (Instruction*) arenaAlloc(codegenState.arena,
+    sizeof(Instruction));
+  ins->next = NULL;
+  ins->type = inst;
+  ins->op1 = op1;
+  ins->op2 = op2;
+  appendCode(node, ins, ins);
+}
+
+void writeCode(Node* node) {
+  writeBlocks(buildBlocks(AST_CGDATA(node)->code));
+  AST_CGDATA(node)->code = NULL;
+  AST_CGDATA(node)->lastCode = NULL;
+}
+
+BasicBlock* buildBlocks(Instruction* code) {
+  BasicBlock* first = NULL;
+  BasicBlock* block = NULL;
+  char ended = 1;  // whether the previous instruction ended a block
+
+  for(Instruction* ins = code; ins; ins = ins->next) {
+    if(ended || ins->type == INS_LABEL) {
+      BasicBlock* newBlock = (BasicBlock*) arenaAlloc(codegenState.arena,
+        sizeof(BasicBlock));
+      *newBlock = (BasicBlock) { .next = NULL, .first = ins,
+        .nInstructions = 0 };
+
+      if(block) block->next = newBlock;
+      else first = newBlock;
+      block = newBlock;
+      codegenState.nBlocks++;
+    }
+    block->nInstructions++;
+
+    // control leaves the block after jumps and returns
+    ended = (ins->type >= INS_JMP && ins->type <= INS_JLE)
+      || ins->type == INS_RET || ins->type == INS_EPILOGUE
+      || ins->type == INS_EXIT;
+  }
+  return first;
+}
+
+Operand makeOperand(OperandType type, long value) {
+  return (Operand) { .type = type, .size = 0, .value = value };
+}
+
+Operand regOperand(char regNum) {
+  return makeOperand(OPD_REG, regNum);
+}
+
+Operand labelOperand(int label) {
+  return makeOperand(OPD_LABEL, label);
 }
 
 void allocateReg(Node* node) {
   char reg = getReg();
-  node->cgData->reg = reg;
+  AST_CGDATA(node)->reg = reg;
 }
 
 void freeNodeReg(Node* node) {
-  if(node->cgData) {
-    freeReg(node->cgData->reg);
+  if(AST_CGDATA(node)) {
+    freeReg(AST_CGDATA(node)->reg);
   } else genericError("Compiler bug: freeing register of an AST node "
            "without allocated register.");
 }
@@ -776,29 +950,21 @@ void freeReg(char regNum) {
 }
 
 void createCgData(Node* node) {
-  if(!node->cgData) {
-    node->cgData = (CgData*) malloc(sizeof(CgData));
-    node->cgData->maxCode = INITIAL_CODE_SIZE;
-    node->cgData->code = (char*) malloc(sizeof(char) * node->cgData->maxCode);
-    node->cgData->code[0] = '\0';
-    node->cgData->breakLabel = NULL;
-    node->cgData->nextLabel = NULL;
+  if(!AST_CGDATA(node)) {
+    AST_CGDATA(node) = (CgData*) arenaAlloc(codegenState.arena,
+      sizeof(CgData));
+    AST_CGDATA(node)->code = NULL;
+    AST_CGDATA(node)->lastCode = NULL;
+    AST_CGDATA(node)->breakLabel = -1;
+    AST_CGDATA(node)->nextLabel = -1;
   }
 }
 
 Node* getBreakable(Node* node) {
   if(node->type == NTLoopSt || node->type == NTWhileSt
      || node->type == NTForSt) return node;
-  if(!node->parent) return NULL;
-  return getBreakable(node->parent);
-}
-
-void printNodeCode(Node* node) {
-  if(cli.outputType > OUT_DEBUG) return;
-
-  if(node->cgData) {
-    printf("\n%s\n", node->cgData->code);
-  }
+  if(node->parent < 0) return NULL;
+  return getBreakable(AST_PARENT(node));
 }
 
 void printRegs() {
@@ -4,23 +4,20 @@
 
 #include <stdio.h>
 #include "datast.h"
+#include "arena.h"
+#include "incremental.h"
+#include "xgen.h"
 
 #define N_GPR 7
 
-typedef struct stCodegenState{
-  FILE* file;
-  char* filename;
-  char* busyRegisters;  // which registers are free
-  char nGPR;  // how many general purpose registers (GPR)
-  char** nameGPR;  // names of the GPRs
-  char* code;  // code generated for the current file
-  int nLabels;
-} CodegenState;
+// Size of the buffer of the code being written
+#define OUTPUT_BUFFER_SIZE (1 << 20)
 
 typedef enum enInstructionType {
   // pseudo-instructions
   INS_LABEL,
   INS_GLOBAL,
+  INS_EXTERN,
   INS_SYSCALL,
   INS_SECTION,
   INS_DIVISION,
@@ -33,6 +30,7 @@ typedef enum enInstructionType {
 //  INS_EPILOGUE_STACK,
   INS_SETRET,
   INS_GETRET,
+  INS_RESERVE,
 
   // regular instructions
   INS_MOV,
@@ -64,16 +62,129 @@ typedef enum enInstructionType {
   INS_POP
 } InstructionType;
 
-extern CodegenState codegenState;
+// Kinds of operands of the machine instructions
+typedef enum enOperandType {
+  OPD_NONE,
+  OPD_REG,  // general purpose register (value: its number)
+  OPD_ARG,  // register of an argument (value: position of the argument)
+  OPD_FP,  // frame (base) pointer
+  OPD_SP,  // stack pointer
+  OPD_STACK,  // local variable or argument (value: its stack slot)
+  OPD_GLOBAL,  // global variable (value: id of its name)
+  OPD_NAME,  // address of a function or global (value: id of its name)
+  OPD_ENTRY,  // entry point of the program
+  OPD_IMM,  // immediate (value: the number)
+  OPD_LITERAL,  // literal copied from the source (value: its token)
+  OPD_LABEL,  // local label (value: its number, or LABEL_EPILOGUE)
+  OPD_SECTION  // section of the executable (value: a SectionType)
+} OperandType;
+
+// Sections of the executable
+typedef enum enSectionType {
+  SECTION_BSS,
+  SECTION_TEXT
+} SectionType;
+
+// Label of the epilogue of the current function
+#define LABEL_EPILOGUE -1
+
+typedef struct stOperand {
+  char type;  // OperandType
+  char size;  // size in bytes of a memory operand, if it must be explicit
+  long value;
+} Operand;
+
+// A machine instruction. The instructions of a node (and, after the AST is
+// traversed, of the program) are a linked list.
+typedef struct stInstruction {
+  struct stInstruction* next;
+  InstructionType type;
+  Operand op1;
+  Operand op2;
+} Instruction;
+
+// A run of instructions that is entered only at its first one (which may be
+// a label) and left only after its last one (which may be a jump).
+typedef struct stBasicBlock {
+  struct stBasicBlock* next;
+  Instruction* first;
+  int nInstructions;
+} BasicBlock;
+
+// A 32-bit displacement to be filled in once the address it refers to is
+// known
+typedef struct stFixup {
+  long offset;  // where it is, from the start of the machine code
+  long target;  // id of the name of a function, or number of a label
+} Fixup;
+
+// Kinds of names of the machine code (bits of EncoderState.nameFlags)
+#define NAME_VARIABLE 1  // a global variable
+#define NAME_EXPORTED 2  // a function seen by other objects
+#define NAME_EXTERNAL 4  // a function of another object
+
+// State of the encoding of the instructions as machine code. In an object
+// file (-c), addresses are relative to the start of its section.
+typedef struct stEncoderState {
+  long codeAddress;  // where the machine code is loaded
+  long bssAddress;  // where the global variables are loaded
+  long bssSize;  // size of the global variables
+  long entry;  // address of the entry point (-1: none)
+  long* nameAddresses;  // of functions and globals, by name id (-1: unknown)
+  char* nameFlags;  // kind of each name (NAME_* bits), by name id
+  long* labelAddresses;  // by label number (-1: unknown)
+  int maxLabels;
+  long epilogueAddress;  // of the current function (-1: unknown)
+  Fixup* calls;  // calls to functions not defined yet
+  int nCalls;
+  int maxCalls;
+  Fixup* jumps;  // jumps forward in the code being written
+  int nJumps;
+  int maxJumps;
+  ObjectRelocation* relocations;  // left to the linker (symbol: name id)
+  int nRelocations;
+  int maxRelocations;
+} EncoderState;
+
+typedef struct stCodegenState{
+  SourceFile* source;
+  char* busyRegisters;  // which registers are free
+  char nGPR;  // how many general purpose registers (GPR)
+  char** nameGPR;  // names of the GPRs
+  Arena* arena;  // where the code of the current part of the program goes
+  Arena functionArena;  // code of a function, released once it is written
+  int nBlocks;  // basic blocks written
+  char native;  // whether machine code is written instead of assembly code
+  int outFd;  // where the code is written
+  char* out;  // code not written yet
+  int outSize;
+  long outWritten;  // bytes of code already written
+  int nLabels;
+  char entryPoint;  // whether the program has one (_start)
+} CodegenState;
+
+extern __thread CodegenState codegenState;
+extern __thread EncoderState encoderState;
+
+// An absent operand
+extern const Operand noOperand;
 
-void codegenStart(FILE* file, char* filename, Node* ast);
-void appendInstruction(Node* node, InstructionType inst, char* op1, char* op2);
-void appendNodeCode(Node* node, char* text);
-void declareGlobalVar(Node* node, char* varName, char size);
-char* getSymbolRef(Symbol* sym, Node* node);
-char* getSymbolSizeRef(Symbol* sym, Node* node);
-char* getArgRegName(short argPos);
+void codegenStart(SourceFile* source, Node* ast, int outFd, char native);
+void releaseCodegen();
+void appendInstruction(Node* node, InstructionType inst, Operand op1,
+                       Operand op2);
+void declareGlobalVar(Node* node, int nameId, char size);
+Operand getSymbolRef(Symbol* sym);
+Operand getSymbolSizeRef(Symbol* sym);
+Operand getArgReg(short argPos);
+Operand makeOperand(OperandType type, long value);
+void writeBlocks(BasicBlock* blocks);
+void writeFunctionCode(CachedFunction* function, int nameId, int* names);
+void flushCode();
 void initializeRegisters();
+void initializeEncoder();
+void finishMachineCode();
+void releaseEncoder();
 
 #endif
 
@@ -0,0 +1,264 @@
+/*
+ *
+ *
+ * Compilation driver: runs the phases of the compiler over a source and
+ * cleans up after them, whether they succeed or not.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+#include "arena.h"
+#include "cache.h"
+#include "incremental.h"
+#include "ast.h"
+#include "intern.h"
+#include "lexer.h"
+#include "parser.h"
+#include "scoper.h"
+#include "codegen.h"
+#include "linker.h"
+#include "xgen.h"
+#include "util.h"
+
+__thread CompilerContext* compiler;
+
+// Names of the phases in the error messages (as printed by each phase)
+char* phaseNames[] = { "", "Lexical ", "Syntax ", "Scope ", "", "",
+  "Link " };
+
+/*
+ * Runs the phases of a compilation, from the source to the executable. It
+ * does not return if an error is found (see failCompilation).
+ *
+ * ctx: the compilation.
+ *
+ */
+void runPhases(CompilerContext* ctx);
+
+/*
+ * Frees what the phases of the compilation that just ended left behind: the
+ * output files of a failed compilation, memory taken outside the arena,
+ * etc. The arena is reset, keeping a block for the next compilation.
+ *
+ */
+void endCompilation();
+
+/*
+ * Copies the AST into the context, for the caller.
+ *
+ * ctx: the compilation.
+ *
+ */
+void copyAst(CompilerContext* ctx);
+
+
+int compile(CompilerContext* ctx) {
+  compiler = ctx;
+  cli = ctx->options;
+  ctx->phase = PHASE_NONE;
+  ctx->failed = 0;
+  ctx->error = (CompileError) { .phase = PHASE_NONE, .lnum = 0, .chnum = 0 };
+  ctx->error.message[0] = '\0';
+  ctx->tokens = NULL;
+  ctx->nTokens = 0;
+  ctx->nodes = NULL;
+  ctx->nNodes = 0;
+  ctx->edges = NULL;
+  ctx->nEdges = 0;
+  ctx->output = NULL;
+  ctx->outputSize = 0;
+
+  // an executable in the cache saves the whole compilation (the debugging
+  // output of the phases is only given by compiling)
+  char key[CACHE_KEY_SIZE];
+  char* outputName = ctx->outputName ? ctx->outputName
+    : (cli.object ? OBJECT_FILE : EXEC_FILE);
+  int cached = cli.cache && !ctx->memoryOutput
+    && ctx->lastPhase == PHASE_NONE && cli.outputType != OUT_DEBUG
+    && cli.outputType != OUT_GRAPHVIZ;
+  if(cached) {
+    cacheKey(ctx->source, &cli, key);
+    if(fetchCachedOutput(key, outputName)) {
+      compiler = NULL;
+      return 0;
+    }
+  }
+
+  if(!compArena.current) arenaInit(&compArena, cli.hugePages);
+
+  // unchanged functions reuse their code from the last compilation (but not
+  // in object files, whose relocations are not kept)
+  int incremental = cli.incremental && !ctx->memoryOutput && !cli.nasm
+    && !cli.object && ctx->lastPhase == PHASE_NONE
+    && cli.outputType != OUT_DEBUG && cli.outputType != OUT_GRAPHVIZ;
+  if(incremental) startIncremental(ctx->source);
+
+  do {
+    ctx->restart = 0;
+    if(setjmp(ctx->errorJump) == 0) runPhases(ctx);
+    endCompilation();
+  } while(ctx->restart);
+
+  if(incremental) endIncremental(!ctx->failed);
+  compiler = NULL;
+
+  if(cached && !ctx->failed) storeCachedOutput(key, outputName);
+  return ctx->failed;
+}
+
+int linkObjects(CompilerContext* ctx, char** objectNames, int nObjects) {
+  compiler = ctx;
+  cli = ctx->options;
+  ctx->phase = PHASE_LINKER;
+  ctx->failed = 0;
+  ctx->error = (CompileError) { .phase = PHASE_NONE, .lnum = 0, .chnum = 0 };
+  ctx->error.message[0] = '\0';
+  ctx->restart = 0;
+
+  if(!compArena.current) arenaInit(&compArena, cli.hugePages);
+
+  if(setjmp(ctx->errorJump) == 0) {
+    if(cli.nasm) linkObjectFiles(objectNames, nObjects, ctx->outputName);
+    else linkerStart(objectNames, nObjects, ctx->outputName);
+  }
+
+  discardOutput();
+  releaseLinker();
+  arenaReset(&compArena);
+  compiler = NULL;
+  return ctx->failed;
+}
+
+void runPhases(CompilerContext* ctx) {
+  SourceFile* source = ctx->source;
+
+  if(ctx->lastPhase == PHASE_LEXER) {
+    ctx->phase = PHASE_LEXER;
+    lexerStartParallel(source, cli.jobs);
+    ctx->tokens = lexerState.tokens;
+    ctx->nTokens = lexerState.nTokens;
+    lexerState.tokens = NULL;
+    return;
+  }
+
+  // big sources are lexed in parallel when there are several cores,
+  // otherwise the parser pulls the tokens from the lexer as it needs them
+  if(lexerThreads(source, cli.jobs) > 1) {
+    ctx->phase = PHASE_LEXER;
+    lexerStartParallel(source, cli.jobs);
+    ctx->phase = PHASE_PARSER;
+    parserStart(source, lexerState.nTokens, lexerState.tokens);
+  } else {
+    ctx->phase = PHASE_PARSER;
+    parserStartStream(source);
+  }
+
+  // Just generate the parser output for Graphviz
+  if(cli.outputType == OUT_GRAPHVIZ) return;
+
+  if(ctx->lastPhase != PHASE_PARSER) {
+    ctx->phase = PHASE_SCOPER;
+    scopeCheckerStart(source, parserState.ast);
+  }
+
+  if(ctx->lastPhase == PHASE_PARSER || ctx->lastPhase == PHASE_SCOPER) {
+    copyAst(ctx);
+    return;
+  }
+
+  if(!parserState.ast) return; // empty program: no code
+
+  // the code is written as it is generated: machine code straight to the
+  // executable, or assembly code for nasm
+  ctx->phase = PHASE_CODEGEN;
+  int outFd;
+  if(ctx->memoryOutput) outFd = createMemoryOutput(!cli.nasm);
+  else if(cli.nasm) outFd = createAsmFile();
+  else outFd = createExecFile(ctx->outputName);
+
+  codegenStart(source, parserState.ast, outFd, !cli.nasm);
+
+  ctx->phase = PHASE_OUTPUT;
+  if(ctx->memoryOutput) ctx->output = takeMemoryOutput(&ctx->outputSize);
+  else if(cli.nasm) generateExec(source->filename, outFd, ctx->outputName);
+  else closeExecFile(outFd);
+}
+
+void copyAst(CompilerContext* ctx) {
+  if(!parserState.ast) return; // empty program: no AST
+
+  ctx->nodes = (Node*) malloc(sizeof(Node) * compAst.nNodes);
+  ctx->edges = (int*) malloc(sizeof(int) * compAst.nEdges);
+  ctx->tokens = (Token*) malloc(sizeof(Token) * compAst.nTokens);
+  if(!ctx->nodes || !ctx->edges || !ctx->tokens) {
+    free(ctx->nodes);
+    free(ctx->edges);
+    free(ctx->tokens);
+    ctx->nodes = NULL;
+    ctx->edges = NULL;
+    ctx->tokens = NULL;
+    genericError("Out of memory.");
+  }
+
+  memcpy(ctx->nodes, compAst.nodes, sizeof(Node) * compAst.nNodes);
+  memcpy(ctx->edges, compAst.edges, sizeof(int) * compAst.nEdges);
+  memcpy(ctx->tokens, compAst.tokens, sizeof(Token) * compAst.nTokens);
+  ctx->nNodes = compAst.nNodes;
+  ctx->nEdges = compAst.nEdges;
+  ctx->nTokens = compAst.nTokens;
+}
+
+void endCompilation() {
+  discardOutput();
+  releaseCodegen();
+  astRelease();
+  free(lexerState.tokens);
+  lexerState.tokens = NULL;
+
+  // the memory of all the phases is released at once
+  arenaReset(&compArena);
+}
+
+void restartCompilation() {
+  compiler->restart = 1;
+  longjmp(compiler->errorJump, 1);
+}
+
+void failCompilation(CompilerPhase phase, char* msg, int lnum, int chnum) {
+  if(!compiler) exit(1);
+
+  compiler->failed = 1;
+  compiler->error = (CompileError) {
+    .phase = phase == PHASE_NONE ? compiler->phase : phase,
+    .lnum = lnum,
+    .chnum = chnum
+  };
+  snprintf(compiler->error.message, MAX_ERROR_MESSAGE, "%s", msg);
+  longjmp(compiler->errorJump, 1);
+}
+
+void printCompileError(CompileError* error, char* sourceName,
+  SourceFile* source) {
+  // with the source, the error is printed as the phase itself prints it
+  fprintf(stderr, "%s%s" ERROR_COLOR_START "ERROR" COLOR_END ": %s\n",
+    source && *phaseNames[error->phase] ? "\n" : "",
+    phaseNames[error->phase], error->message);
+
+  if(error->lnum > 0) {
+    if(!source || error->phase == PHASE_LEXER)
+      fprintf(stderr, "%s: line: %d, column: %d.\n", sourceName,
+        error->lnum, error->chnum);
+    if(source) printCharInFile(source, error->lnum, error->chnum);
+  } else if(!source || *phaseNames[error->phase])
+    fprintf(stderr, "%s.\n", sourceName);
+}
+
+void releaseCompilerMemory() {
+  free(lexerState.tokens);
+  lexerState.tokens = NULL;
+  internerRelease();
+  arenaRelease(&compArena);
+}
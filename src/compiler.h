@@ -0,0 +1,145 @@
+/*
+ *
+ *
+ * Compilation driver. Runs all the phases of the compiler over a source,
+ * and returns errors to the caller instead of ending the program, so that
+ * a process can compile many sources, one after another or at the same time
+ * in several threads.
+ *
+ * The state of each phase (see lexerState, parserState, compAst, etc.) is
+ * kept by the thread running the compilation, so each thread can run a
+ * compilation of its own. The context of a compilation holds what is
+ * particular to it: the source, the options and the outcome.
+ *
+ */
+
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <setjmp.h>
+#include "cli.h"
+#include "datast.h"
+
+// Maximum size of the message of a compilation error (longer ones are cut)
+#define MAX_ERROR_MESSAGE 512
+
+// Phases of a compilation, to tell where an error was found
+typedef enum enCompilerPhase {
+  PHASE_NONE,  // no compilation, or the phase in progress when reporting
+  PHASE_LEXER,
+  PHASE_PARSER,
+  PHASE_SCOPER,
+  PHASE_CODEGEN,
+  PHASE_OUTPUT,  // writing the executable (or running nasm and ld)
+  PHASE_LINKER  // linking object files (see linkObjects)
+} CompilerPhase;
+
+// The error that stopped a compilation
+typedef struct stCompileError {
+  CompilerPhase phase;
+  char message[MAX_ERROR_MESSAGE];
+  int lnum;  // position of the error in the source (0 if it has none)
+  int chnum;
+} CompileError;
+
+// A compilation: what it works on and how it ended. What it produces in
+// memory is malloc'ed and left to the caller (NULL when not produced).
+typedef struct stCompilerContext {
+  struct stCli options;  // used as cli while compiling
+  SourceFile* source;
+  char* outputName;  // name of the executable (NULL for the default one)
+  CompilerPhase lastPhase;  // where to stop (PHASE_NONE: go to the output)
+  char memoryOutput;  // 1 to write the output to memory instead of a file
+  CompilerPhase phase;  // phase in progress
+  int failed;  // 1 if the compilation stopped with an error
+  CompileError error;  // the error, if failed
+  Token* tokens;  // of the source (lastPhase PHASE_LEXER), or of the AST
+  int nTokens;
+  // the AST (lastPhase PHASE_PARSER or PHASE_SCOPER), in postorder: the
+  // root is the last node, and the children of the nodes are in edges
+  Node* nodes;
+  int nNodes;
+  int* edges;
+  int nEdges;
+  char* output;  // executable or assembly code (memoryOutput)
+  long outputSize;
+  char restart;  // 1 if the phases must run again (see restartCompilation)
+  jmp_buf errorJump;  // where errors jump to
+} CompilerContext;
+
+// Compilation in progress in this thread (NULL if none)
+extern __thread CompilerContext* compiler;
+
+/*
+ * Compiles a source, in the calling thread. The memory of the phases is
+ * released before returning (except for the blocks kept by the thread for
+ * its next compilation, see releaseCompilerMemory).
+ *
+ * ctx: the compilation (its options, source, output name, lastPhase and
+ *   memoryOutput must be set).
+ * returns: 0 if the compilation succeeded, 1 if an error stopped it (and
+ *   then ctx->error tells which one).
+ *
+ */
+int compile(CompilerContext* ctx);
+
+/*
+ * Links object files (see compile with -c) into an executable, in the
+ * calling thread, as a compilation without a source. The options of the
+ * context tell how (with ld if nasm is set).
+ *
+ * ctx: the context (its options and output name must be set).
+ * objectNames: the names of the object files.
+ * nObjects: the number of object files.
+ * returns: 0 if the executable was written, 1 if an error stopped it (and
+ *   then ctx->error tells which one).
+ *
+ */
+int linkObjects(CompilerContext* ctx, char** objectNames, int nObjects);
+
+/*
+ * Stops the compilation in progress because of an error, which must have
+ * been reported already. The error is recorded in the context and the
+ * compilation returns to the caller of compile. Outside of compile (e.g. in
+ * the benchmarks) the program exits with code 1.
+ *
+ * phase: the phase where the error was found (PHASE_NONE for the one in
+ *   progress).
+ * msg: the error message.
+ * lnum: line number of the error (0 if it has no position).
+ * chnum: column of the error.
+ *
+ */
+void failCompilation(CompilerPhase phase, char* msg, int lnum, int chnum)
+  __attribute__((noreturn));
+
+/*
+ * Stops the compilation in progress and runs all its phases again, from
+ * the source. It is used when something reused from a previous compilation
+ * turns out not to fit, once part of the program has been handled assuming
+ * it would (see incremental.h).
+ *
+ */
+void restartCompilation();
+
+/*
+ * Prints the error that stopped a compilation, with the name of its source
+ * and its position (as the phase prints it, when the source is given).
+ *
+ * error: the error.
+ * sourceName: the name of the source.
+ * source: the source, to print the line of the error (NULL not to print
+ *   it).
+ *
+ */
+void printCompileError(CompileError* error, char* sourceName,
+  SourceFile* source);
+
+/*
+ * Releases all the memory kept by the calling thread for its compilations.
+ * It must be called before a thread that compiled sources ends.
+ *
+ */
+void releaseCompilerMemory();
+
+#endif
@@ -12,13 +12,23 @@
 // A node type name cannot exceed this length
 #define MAX_NODE_NAME 40
 
-// Represents a token.
+// Represents a source file loaded in memory.
+typedef struct stSourceFile {
+  char* filename;
+  char* data;  // contents of the file (not NUL terminated)
+  long size;  // number of bytes in data
+  char mapped;  // 1 if data is a memory mapping, 0 if it is malloc'ed
+} SourceFile;
+
+// Represents a token. The text of the token is not copied: it is a slice
+// of the source file buffer.
 typedef struct stToken {
-  char * name;
-  int nameSize;
-  short type;
+  int start;  // offset of the first character of the token in the source
+  int nameSize;  // number of characters in the token
   int lnum;
   int chnum;
+  short type;
+  int id;  // identifiers: id of the interned name (see intern.h), else -1
 } Token;
 
 // Represents the types of tokens allowed in the language.
@@ -80,7 +90,9 @@ typedef enum enTokenType {
   TTLoop,
   TTMatch,
   TTTrue,
-  TTFalse
+  TTFalse,
+  TTExtern,
+  TTExport
 } TokenType;
 
 typedef enum enNodeType {
@@ -88,6 +100,7 @@ typedef enum enNodeType {
   NTProgramPart,
   NTStatement,
   NTFunction,
+  NTExternFunction,
   NTDeclaration,
   NTBreakSt,
   NTNextSt,
@@ -102,14 +115,12 @@ typedef enum enNodeType {
   NTMatchClause,
   NTExpression,
   NTCallExpr,
-  NTCallParam,
   NTArgList,
   NTArg,
   NTNoop,
   NTTerm,
   NTType,
   NTLiteral,
-  NTBinaryOp,
   NTIdentifier,
   NTTerminal,
 } NodeType;
@@ -123,40 +134,79 @@ typedef enum enSymbolType {
 } SymbolType;
 
 typedef struct stSymbol {
-  Token* token;  // holds the name of the symbol
+  Token* token;  // where the symbol is declared
+  int id;  // id of its name (see intern.h)
   short type;  // type of symbol
-  short pos;  // if function argument or local variable, the position
+  short pos;  // if function argument or local variable, its slot in the
+             // stack frame
 } Symbol;
 
+// Symbol table of a scope. The symbols are kept in declaration order, and
+// are found through an open-addressing hash table (with linear probing) of
+// their positions, keyed by the ids of their names.
 typedef struct stSymbolTable {
-  Symbol** symbols;
+  Symbol* symbols;  // in declaration order
   int nSymbols;
-  int maxSize;
+  int maxSize;  // allocated size of symbols
+  int* slots;  // position of a symbol plus one (0 for an empty slot)
+  int nSlots;  // size of slots: a power of two, twice maxSize
   int nLocalVars;  // number of local variables
   int nArgs;  // number of arguments (for functions)
   int nStackVarsAcc;  // number of stack variables accumulated (+ ancestors)
   int nStackVars;  // number of variables to allocate in stack
 } SymbolTable;
 
+// The symbol an identifier stands for. Symbol tables may grow, moving their
+// symbols, so symbols are referred to by their position in a table.
+typedef struct stBinding {
+  int scope;  // the scope-bearing node whose table has it (-1 if unbound)
+  int symbol;  // its position in the table
+} Binding;
+
+// The code of a node is a list of machine instructions (see codegen.h), so
+// the code of a child is spliced into its parent in O(1) instead of being
+// copied at every level of the tree.
 typedef struct stCgData {
   char reg;
-  char* code;
-  int maxCode;
-  char* breakLabel;  // label to jump to if break is encountered
-  char* nextLabel;  // label to jump to if next is encountered
+  struct stInstruction* code;  // first instruction of the code (NULL if none)
+  struct stInstruction* lastCode;  // last instruction of the code
+  int breakLabel;  // label to jump to if break is encountered (-1 if none)
+  int nextLabel;  // label to jump to if next is encountered (-1 if none)
 } CgData;
 
-// Represents a node of the Abstract Syntax Tree (AST)
+// Represents a node of the Abstract Syntax Tree (AST). Nodes live in a
+// single array (see Ast) and refer to each other by 32-bit indices: the
+// children of a node are a run of consecutive entries in the shared edge
+// array, and terminal nodes keep the index of their token.
 typedef struct stNode {
-  NodeType type;
-  Token* token;
-  struct stNode** children;
-  int nChildren;
-  int id;
-  struct stNode* parent;
-  SymbolTable* symTable;
-  CgData* cgData;
+  unsigned int type : 8;  // NodeType
+  unsigned int nChildren : 24;
+  int parent;  // index of the parent node (-1 for the root)
+  int children;  // index in the edge array of the first child
+  int token;  // index of the token of terminal nodes (-1 otherwise)
 } Node;
 
+// The AST of a program. While parsing, nodes are stored in creation order;
+// once the program is parsed they are rearranged in postorder (the root is
+// the last node), so the nodes of any subtree are contiguous and end at
+// the subtree root. Data added by later phases is kept in side tables
+// indexed by node.
+typedef struct stAst {
+  Node* nodes;
+  int nNodes;
+  int maxNodes;  // allocated size of nodes
+  int* edges;  // children of all the nodes (node indices)
+  int nEdges;
+  int maxEdges;  // allocated size of edges
+  Token* tokens;  // tokens of the terminal nodes
+  int nTokens;
+  int maxTokens;  // allocated size of tokens (0 if not owned)
+  int* childIndex;  // position of each node among the children of its parent
+  int* scopes;  // innermost scope-bearing node of each node (by the scoper)
+  SymbolTable** symTables;  // scope of each node (filled by the scoper)
+  Binding* bindings;  // symbol of each identifier (filled by the scoper)
+  CgData** cgData;  // code of each node (filled by the code generator)
+} Ast;
+
 #endif
 
@@ -0,0 +1,438 @@
+/*
+ *
+ *
+ * Incremental compilation: reuse of the code of the functions that did not
+ * change since the last compilation.
+ *
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "incremental.h"
+#include "ast.h"
+#include "codegen.h"
+#include "compiler.h"
+#include "intern.h"
+#include "scoper.h"
+#include "util.h"
+
+// Initial size of the file of the functions being compiled
+#define INITIAL_FUNCTIONS_FILE (64 * 1024)
+
+// Initial size of the tables of names and relocations of a function
+#define INITIAL_FUNCTION_TABLE 64
+
+__thread IncrementalState incrementalState;
+
+/*
+ * Reads the functions of a file of the cache into the state.
+ *
+ * size: the size of the file.
+ * returns: 1 if the file is well formed, 0 otherwise.
+ *
+ */
+int readFunctions(long size);
+
+/*
+ * Finds a function in the functions read from the cache.
+ *
+ * digest: its fingerprint.
+ * returns: the function, or NULL if it is not there.
+ *
+ */
+CachedFunction* findCachedFunction(unsigned char* digest);
+
+/*
+ * Lists the distinct names of a function, in order of appearance (so that
+ * they are the same each time the function is compiled, unlike their ids).
+ *
+ * partNode: the program part with the function.
+ *
+ */
+void listFunctionNames(Node* partNode);
+
+/*
+ * Returns the registers busy in the code generator, one bit each.
+ *
+ */
+int busyRegisters();
+
+/*
+ * Adds a function to the file of the functions being compiled.
+ *
+ * digest: its fingerprint.
+ * registersIn: busy registers when its code starts.
+ * registersOut: busy registers when its code ends.
+ * relocations: its relocations.
+ * nRelocations: the number of relocations.
+ * code: its code.
+ * size: the size of its code.
+ * returns: the offset of its code in the file.
+ *
+ */
+long keepFunction(unsigned char* digest, int registersIn, int registersOut,
+  Relocation* relocations, int nRelocations, void* code, int size);
+
+/*
+ * Appends bytes to the file of the functions being compiled.
+ *
+ * data: the bytes.
+ * size: the number of bytes.
+ *
+ */
+void appendFunctionData(void* data, long size);
+
+
+void startIncremental(SourceFile* source) {
+  incrementalState = (IncrementalState) {
+    .enabled = 0,
+    .reuse = 1,
+    .source = source,
+    .start = -1
+  };
+
+  // the functions of a source are kept under its absolute path
+  char path[PATH_MAX];
+  if(!realpath(source->filename, path)) return;
+  char header[64];
+  int headerSize = snprintf(header, sizeof(header), "ulpc %s functions",
+    VERSION) + 1;
+
+  Sha256 sha;
+  unsigned char digest[SHA256_SIZE];
+  sha256Init(&sha);
+  sha256Update(&sha, header, headerSize);
+  sha256Update(&sha, path, strlen(path));
+  sha256Final(&sha, digest);
+  for(int i = 0; i < SHA256_SIZE; i++)
+    sprintf(incrementalState.key + 2 * i, "%02x", digest[i]);
+
+  incrementalState.enabled = 1;
+
+  long size = 0;
+  incrementalState.file = readCacheFile(incrementalState.key, &size);
+  incrementalState.fileSize = size;
+  if(incrementalState.file && !readFunctions(size)) {
+    free(incrementalState.cached);
+    free(incrementalState.slots);
+    incrementalState.cached = NULL;
+    incrementalState.slots = NULL;
+    incrementalState.nCached = 0;
+  }
+}
+
+int readFunctions(long size) {
+  char* data = incrementalState.file;
+  char* end = data + size;
+  int nFunctions;
+  if(size < (long) sizeof(int)) return 0;
+  memcpy(&nFunctions, data, sizeof(int));
+  data += sizeof(int);
+  if(nFunctions < 0 || nFunctions > size) return 0;
+
+  incrementalState.cached = (CachedFunction*) malloc(sizeof(CachedFunction)
+    * (nFunctions > 0 ? nFunctions : 1));
+  incrementalState.nSlots = 1;
+  while(incrementalState.nSlots < 2 * nFunctions) incrementalState.nSlots *= 2;
+  incrementalState.slots = (CachedFunction**) calloc(incrementalState.nSlots,
+    sizeof(CachedFunction*));
+  if(!incrementalState.cached || !incrementalState.slots) return 0;
+
+  // each function: its fields, its relocations and its code (padded to
+  // keep the relocations aligned)
+  int fieldsSize = FINGERPRINT_SIZE + 4 * sizeof(int);
+  for(int i = 0; i < nFunctions; i++) {
+    CachedFunction* function = &incrementalState.cached[i];
+    if(end - data < fieldsSize) return 0;
+    char* fields = data + FINGERPRINT_SIZE;
+    memcpy(function->digest, data, FINGERPRINT_SIZE);
+    memcpy(&function->registersIn, fields, sizeof(int));
+    memcpy(&function->registersOut, fields + sizeof(int), sizeof(int));
+    memcpy(&function->size, fields + 2 * sizeof(int), sizeof(int));
+    memcpy(&function->nRelocations, fields + 3 * sizeof(int), sizeof(int));
+    data += fieldsSize;
+
+    long relocationsSize = (long) function->nRelocations * sizeof(Relocation);
+    long codeSize = ((long) function->size + 3) & ~3L;
+    if(function->size < 0 || function->nRelocations < 0
+       || end - data < relocationsSize + codeSize) return 0;
+    function->relocations = (Relocation*) data;
+    function->code = (unsigned char*) data + relocationsSize;
+    data += relocationsSize + codeSize;
+
+    for(int r = 0; r < function->nRelocations; r++) {
+      Relocation* relocation = &function->relocations[r];
+      if(relocation->offset < 0 || relocation->offset > function->size - 4
+         || relocation->name < 0) return 0;
+    }
+
+    int mask = incrementalState.nSlots - 1;
+    int slot;
+    memcpy(&slot, function->digest, sizeof(int));
+    for(slot &= mask; incrementalState.slots[slot]; slot = (slot + 1) & mask);
+    incrementalState.slots[slot] = function;
+  }
+
+  incrementalState.nCached = nFunctions;
+  return 1;
+}
+
+void prepareIncremental(Node* ast) {
+  IncrementalState* state = &incrementalState;
+  int nParts = ast->nChildren;
+
+  state->digests = realloc(state->digests, FINGERPRINT_SIZE * nParts);
+  state->reused = (CachedFunction**) realloc(state->reused,
+    sizeof(CachedFunction*) * nParts);
+  state->nameOrdinals = (int*) realloc(state->nameOrdinals,
+    sizeof(int) * (interner.nNames + 1));
+  if(!state->digests || !state->reused || !state->nameOrdinals)
+    genericError("Out of memory.");
+
+  memset(state->reused, 0, sizeof(CachedFunction*) * nParts);
+  for(int i = 0; i < interner.nNames; i++) state->nameOrdinals[i] = -1;
+  state->nNames = 0;
+  state->outSize = 0;
+  state->nOut = 0;
+  state->start = -1;
+  state->nReused = 0;
+  state->nFunctions = 0;
+}
+
+int fingerprintFunction(Node* ast, int part) {
+  Node* partNode = AST_CHILD(ast, part);
+  Node* first = astFirstLeaf(partNode);
+  int nNodes = partNode - first + 1;
+  long start = -1, end = -1;
+
+  uint64_t hash[2] = { 0, 0 };
+  hashBytes(&nNodes, sizeof(int), hash);
+
+  // what each name stands for outside of the function (it is not checked
+  // yet, so only the global scope has symbols)
+  for(Node* node = first; node <= partNode; node++) {
+    if(node->token < 0) continue;
+
+    Token* token = AST_TOKEN(node);
+    if(start < 0 || token->start < start) start = token->start;
+    if(token->start + token->nameSize > end)
+      end = token->start + token->nameSize;
+
+    if(token->type == TTId) {
+      Symbol* symbol = lookupSymbol(ast, token);
+      char kind = symbol ? (char) symbol->type : -1;
+      hashBytes(&kind, 1, hash);
+    }
+  }
+
+  // and the text of the function
+  if(start >= 0)
+    hashBytes(incrementalState.source->data + start, end - start, hash);
+  memcpy(incrementalState.digests[part], hash, FINGERPRINT_SIZE);
+
+  incrementalState.nFunctions++;
+  if(!incrementalState.reuse) return 0;
+
+  CachedFunction* function = findCachedFunction(incrementalState.digests[part]);
+  incrementalState.reused[part] = function;
+  return function != NULL;
+}
+
+CachedFunction* findCachedFunction(unsigned char* digest) {
+  if(incrementalState.nCached == 0) return NULL;
+
+  int mask = incrementalState.nSlots - 1;
+  int slot;
+  memcpy(&slot, digest, sizeof(int));
+
+  for(slot &= mask; incrementalState.slots[slot]; slot = (slot + 1) & mask) {
+    CachedFunction* function = incrementalState.slots[slot];
+    if(memcmp(function->digest, digest, FINGERPRINT_SIZE) == 0)
+      return function;
+  }
+  return NULL;
+}
+
+int writeCachedFunction(Node* ast, int part) {
+  CachedFunction* function = incrementalState.reused[part];
+  if(!function) return 0;
+
+  // the code was generated with other registers free: nothing is reused,
+  // as the functions that come later were not checked either
+  if(function->registersIn != busyRegisters()) {
+    incrementalState.reuse = 0;
+    restartCompilation();
+  }
+
+  Node* partNode = AST_CHILD(ast, part);
+  Node* fNode = AST_CHILD(partNode, 0);
+  int nameId = AST_TOKEN(AST_CHILD(AST_CHILD(fNode, 0), 0))->id;
+  listFunctionNames(partNode);
+  writeFunctionCode(function, nameId, incrementalState.names);
+
+  for(int i = 0; i < codegenState.nGPR; i++)
+    codegenState.busyRegisters[i] = (function->registersOut >> i) & 1;
+
+  // it is kept for the next compilation, as it is
+  keepFunction(function->digest, function->registersIn,
+    function->registersOut, function->relocations, function->nRelocations,
+    function->code, function->size);
+  incrementalState.nReused++;
+  return 1;
+}
+
+void startFunctionCode() {
+  // the code of a function is kept in the buffer until it is cached, unless
+  // it does not fit
+  if(codegenState.outSize > OUTPUT_BUFFER_SIZE / 2) flushCode();
+
+  incrementalState.start = codegenState.outWritten + codegenState.outSize;
+  incrementalState.registersIn = busyRegisters();
+  incrementalState.nRelocations = 0;
+}
+
+void addRelocation(long offset, int nameId, int immSize) {
+  IncrementalState* state = &incrementalState;
+  if(state->start < 0) return;  // not in a function
+
+  if(state->nRelocations == state->maxRelocations) {
+    state->maxRelocations = state->maxRelocations > 0
+      ? 2 * state->maxRelocations : INITIAL_FUNCTION_TABLE;
+    state->relocations = (Relocation*) realloc(state->relocations,
+      sizeof(Relocation) * state->maxRelocations);
+    if(!state->relocations) genericError("Out of memory.");
+  }
+
+  // the name is found by its position when the code is reused
+  state->relocations[state->nRelocations++] = (Relocation) {
+    .offset = offset - state->start,
+    .name = nameId,
+    .immSize = immSize
+  };
+}
+
+void endFunctionCode(Node* ast, int part) {
+  IncrementalState* state = &incrementalState;
+  long start = state->start;
+  long size = codegenState.outWritten + codegenState.outSize - start;
+  state->start = -1;
+  if(start < codegenState.outWritten) return;  // already written out
+
+  listFunctionNames(AST_CHILD(ast, part));
+  for(int i = 0; i < state->nRelocations; i++) {
+    state->relocations[i].name =
+      state->nameOrdinals[state->relocations[i].name];
+    if(state->relocations[i].name < 0) return;
+  }
+
+  // the displacements are relocated each time the code is reused
+  long codeStart = keepFunction(state->digests[part], state->registersIn,
+    busyRegisters(), state->relocations, state->nRelocations,
+    codegenState.out + (start - codegenState.outWritten), size);
+  for(int i = 0; i < state->nRelocations; i++)
+    memset(state->out + codeStart + state->relocations[i].offset, 0, 4);
+}
+
+void listFunctionNames(Node* partNode) {
+  IncrementalState* state = &incrementalState;
+
+  for(int i = 0; i < state->nNames; i++)
+    state->nameOrdinals[state->names[i]] = -1;
+  state->nNames = 0;
+
+  for(Node* node = astFirstLeaf(partNode); node <= partNode; node++) {
+    if(node->token < 0) continue;
+
+    Token* token = AST_TOKEN(node);
+    if(token->type != TTId || state->nameOrdinals[token->id] >= 0) continue;
+
+    if(state->nNames == state->maxNames) {
+      state->maxNames = state->maxNames > 0 ? 2 * state->maxNames
+        : INITIAL_FUNCTION_TABLE;
+      state->names = (int*) realloc(state->names,
+        sizeof(int) * state->maxNames);
+      if(!state->names) genericError("Out of memory.");
+    }
+    state->nameOrdinals[token->id] = state->nNames;
+    state->names[state->nNames++] = token->id;
+  }
+}
+
+int busyRegisters() {
+  int registers = 0;
+  for(int i = 0; i < codegenState.nGPR; i++)
+    registers |= (codegenState.busyRegisters[i] != 0) << i;
+  return registers;
+}
+
+long keepFunction(unsigned char* digest, int registersIn, int registersOut,
+  Relocation* relocations, int nRelocations, void* code, int size) {
+  int fields[4] = { registersIn, registersOut, size, nRelocations };
+  char padding[3] = { 0, 0, 0 };
+
+  appendFunctionData(digest, FINGERPRINT_SIZE);
+  appendFunctionData(fields, sizeof(fields));
+  appendFunctionData(relocations, sizeof(Relocation) * nRelocations);
+  long codeStart = incrementalState.outSize;
+  appendFunctionData(code, size);
+  appendFunctionData(padding, (4 - size % 4) % 4);
+  incrementalState.nOut++;
+  return codeStart;
+}
+
+void appendFunctionData(void* data, long size) {
+  IncrementalState* state = &incrementalState;
+  if(size <= 0) return;
+
+  if(state->outSize + size > state->maxOut) {
+    long newSize = state->maxOut > 0 ? state->maxOut
+      : INITIAL_FUNCTIONS_FILE;
+    while(newSize < state->outSize + size) newSize *= 2;
+
+    state->out = (char*) realloc(state->out, newSize);
+    if(!state->out) genericError("Out of memory.");
+    state->maxOut = newSize;
+  }
+
+  memcpy(state->out + state->outSize, data, size);
+  state->outSize += size;
+}
+
+void endIncremental(int succeeded) {
+  IncrementalState* state = &incrementalState;
+
+  if(succeeded && state->enabled) {
+    if(cli.outputType == OUT_VERBOSE)
+      printf("Reused %d of %d functions.\n", state->nReused,
+        state->nFunctions);
+
+    // the number of functions goes first; the file is not written again
+    // if nothing changed
+    long size = sizeof(int) + state->outSize;
+    char* file = (char*) malloc(size);
+    if(file) {
+      memcpy(file, &state->nOut, sizeof(int));
+      if(state->outSize > 0)
+        memcpy(file + sizeof(int), state->out, state->outSize);
+      if(!state->file || state->fileSize != size
+         || memcmp(state->file, file, size) != 0)
+        writeCacheFile(state->key, file, size);
+      free(file);
+    }
+  }
+
+  free(state->file);
+  free(state->cached);
+  free(state->slots);
+  free(state->digests);
+  free(state->reused);
+  free(state->nameOrdinals);
+  free(state->names);
+  free(state->out);
+  free(state->relocations);
+  *state = (IncrementalState) { .enabled = 0, .start = -1 };
+}
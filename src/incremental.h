@@ -0,0 +1,156 @@
+/*
+ *
+ *
+ * Incremental compilation. The machine code of each function of a source is
+ * kept in the cache (see cache.h), and when the source is compiled again,
+ * the functions that did not change are neither scope checked nor
+ * generated: their code is copied into the executable, and their calls and
+ * references to globals are relocated.
+ *
+ * A function is recognized by its fingerprint: a digest of its text, of the
+ * shape of its subtree, and of what the names it uses stand for outside of
+ * it (a function, a global variable or nothing). Its code also depends on
+ * the registers left busy by the code before it, so the cached code is only
+ * reused when they are the same; otherwise the compilation starts over,
+ * without reusing any function (see restartCompilation).
+ *
+ */
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "datast.h"
+#include "cache.h"
+
+// Size of the fingerprint of a function (see hashBytes)
+#define FINGERPRINT_SIZE 16
+
+// A 32-bit displacement in the code of a function, to a function or a
+// global variable
+typedef struct stRelocation {
+  int offset;  // from the start of the code of the function
+  int name;  // position of the name among the distinct names of the function
+  int immSize;  // bytes of the instruction after the displacement
+} Relocation;
+
+// A function of a previous compilation, and its machine code
+typedef struct stCachedFunction {
+  unsigned char digest[FINGERPRINT_SIZE];  // its fingerprint
+  int registersIn;  // busy registers when its code starts (one bit each)
+  int registersOut;  // busy registers when its code ends
+  int size;  // of its code
+  int nRelocations;
+  Relocation* relocations;
+  unsigned char* code;  // with zeros at the displacements to relocate
+} CachedFunction;
+
+// State of the incremental compilation of a source
+typedef struct stIncrementalState {
+  char enabled;  // functions are fingerprinted and their code cached
+  char reuse;  // cached functions can be reused (not after a restart)
+  SourceFile* source;
+  char key[CACHE_KEY_SIZE];  // of the file of the functions in the cache
+  char* file;  // the file read from the cache
+  long fileSize;
+  CachedFunction* cached;  // functions of the file
+  int nCached;
+  CachedFunction** slots;  // the cached functions by digest (hash table)
+  int nSlots;
+  unsigned char (*digests)[FINGERPRINT_SIZE];  // fingerprints, by part
+  CachedFunction** reused;  // cached function of each part (NULL: none)
+  int* nameOrdinals;  // position of each name id in the current function
+  int* names;  // distinct name ids of the current function, in order
+  int nNames;
+  int maxNames;
+  char* out;  // the file of the functions being compiled
+  long outSize;
+  long maxOut;
+  int nOut;  // functions in it
+  long start;  // where the code of the function being generated starts
+  int registersIn;  // busy registers at that point
+  Relocation* relocations;  // of the function being generated
+  int nRelocations;
+  int maxRelocations;
+  int nReused;  // functions reused in this compilation
+  int nFunctions;
+} IncrementalState;
+
+extern __thread IncrementalState incrementalState;
+
+/*
+ * Starts the incremental compilation of a source, reading the code of its
+ * functions from the last time it was compiled.
+ *
+ * source: the source (it must have been read from a file, otherwise the
+ *   compilation is not incremental).
+ *
+ */
+void startIncremental(SourceFile* source);
+
+/*
+ * Prepares the incremental compilation of a parsed program, before it is
+ * scope checked (again, if the compilation starts over).
+ *
+ * ast: the root of the AST.
+ *
+ */
+void prepareIncremental(Node* ast);
+
+/*
+ * Fingerprints a program part with a function, before it is scope checked,
+ * and tells whether its cached code can be reused (in which case it must
+ * not be scope checked).
+ *
+ * ast: the root of the AST.
+ * part: the number of the program part.
+ * returns: 1 if the code of the function is in the cache, 0 otherwise.
+ *
+ */
+int fingerprintFunction(Node* ast, int part);
+
+/*
+ * Writes the cached code of a function of the program, if it is reused.
+ *
+ * ast: the root of the AST.
+ * part: the number of the program part with the function.
+ * returns: 1 if its code was written, 0 if it must be generated.
+ *
+ */
+int writeCachedFunction(Node* ast, int part);
+
+/*
+ * Starts keeping the code of a function being generated.
+ *
+ */
+void startFunctionCode();
+
+/*
+ * Records a displacement in the code being generated, to be relocated when
+ * it is reused.
+ *
+ * offset: where the displacement is, from the start of the machine code.
+ * nameId: the id of the name it refers to.
+ * immSize: bytes of the instruction after the displacement.
+ *
+ */
+void addRelocation(long offset, int nameId, int immSize);
+
+/*
+ * Keeps the code of a function just generated, for the next compilation.
+ *
+ * ast: the root of the AST.
+ * part: the number of the program part with the function.
+ *
+ */
+void endFunctionCode(Node* ast, int part);
+
+/*
+ * Ends the incremental compilation of a source, saving the code of its
+ * functions in the cache if the compilation succeeded.
+ *
+ * succeeded: 1 if the compilation succeeded.
+ *
+ */
+void endIncremental(int succeeded);
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ *
+ *
+ * Interning of identifier names.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+#include "util.h"
+
+// Initial number of names of the interner (a power of two)
+#define INITIAL_MAX_NAMES 1024
+
+// Initial size of the characters of the names
+#define INITIAL_MAX_CHARS (16 * INITIAL_MAX_NAMES)
+
+__thread Interner interner;
+
+/*
+ * Reallocates memory, stopping the compilation if the system is out of
+ * memory.
+ *
+ * ptr: the memory to be resized (NULL to allocate new memory).
+ * size: the new size, in bytes.
+ * returns: a pointer to the resized memory.
+ *
+ */
+void* internRealloc(void* ptr, size_t size);
+
+/*
+ * Doubles the number of names that fit in the interner, rebuilding the
+ * hash table.
+ *
+ */
+void growNames();
+
+
+void internerReset() {
+  interner.nChars = 0;
+  interner.nNames = 0;
+  if(interner.slots)
+    memset(interner.slots, 0, sizeof(int) * interner.nSlots);
+}
+
+void internerRelease() {
+  free(interner.chars);
+  free(interner.names);
+  free(interner.slots);
+  memset(&interner, 0, sizeof(Interner));
+}
+
+int internName(char* name, int size) {
+  if(!interner.slots) growNames();
+
+  unsigned int hash = hashName(name, size);
+  int mask = interner.nSlots - 1;
+  int slot = hash & mask;
+
+  // linear probing, up to the name or an empty slot
+  for(; interner.slots[slot]; slot = (slot + 1) & mask) {
+    InternedName* old = &interner.names[interner.slots[slot] - 1];
+    if(old->hash == hash && old->size == size
+       && memcmp(interner.chars + old->start, name, size) == 0)
+      return interner.slots[slot] - 1;
+  }
+
+  if(interner.nNames == interner.maxNames) {
+    growNames();
+    mask = interner.nSlots - 1;
+    for(slot = hash & mask; interner.slots[slot]; slot = (slot + 1) & mask);
+  }
+
+  if(interner.nChars + size + 1 > interner.maxChars) {
+    while(interner.nChars + size + 1 > interner.maxChars)
+      interner.maxChars = interner.maxChars ? interner.maxChars * 2
+        : INITIAL_MAX_CHARS;
+    interner.chars = (char*) internRealloc(interner.chars,
+      interner.maxChars);
+  }
+
+  int id = interner.nNames++;
+  interner.names[id] = (InternedName) {
+    .start = interner.nChars,
+    .size = size,
+    .hash = hash
+  };
+  memcpy(interner.chars + interner.nChars, name, size);
+  interner.chars[interner.nChars + size] = '\0';
+  interner.nChars += size + 1;
+  interner.slots[slot] = id + 1;
+
+  return id;
+}
+
+char* internedName(int id) {
+  return interner.chars + interner.names[id].start;
+}
+
+void growNames() {
+  interner.maxNames = interner.maxNames ? interner.maxNames * 2
+    : INITIAL_MAX_NAMES;
+  interner.names = (InternedName*) internRealloc(interner.names,
+    sizeof(InternedName) * interner.maxNames);
+
+  interner.nSlots = 2 * interner.maxNames;
+  interner.slots = (int*) internRealloc(interner.slots,
+    sizeof(int) * interner.nSlots);
+  memset(interner.slots, 0, sizeof(int) * interner.nSlots);
+
+  int mask = interner.nSlots - 1;
+  for(int id = 0; id < interner.nNames; id++) {
+    int slot = interner.names[id].hash & mask;
+    while(interner.slots[slot]) slot = (slot + 1) & mask;
+    interner.slots[slot] = id + 1;
+  }
+}
+
+void* internRealloc(void* ptr, size_t size) {
+  ptr = realloc(ptr, size);
+  if(!ptr) genericError("Out of memory.");
+  return ptr;
+}
@@ -0,0 +1,69 @@
+/*
+ *
+ *
+ * Interning of identifier names. Each distinct name of a source gets a
+ * dense integer id, so the phases after the lexer compare and hash ids
+ * instead of strings, and the characters of each name are stored once.
+ *
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+// A name stored in the interner
+typedef struct stInternedName {
+  int start;  // offset of its first character in the characters of the names
+  int size;  // number of characters (without the NUL that follows them)
+  unsigned int hash;  // hash of the name (see hashName)
+} InternedName;
+
+// Table of the distinct names. Names get their ids in order of first
+// appearance, and are found through an open-addressing hash table (with
+// linear probing) of their ids.
+typedef struct stInterner {
+  char* chars;  // characters of the names, each one followed by a NUL
+  int nChars;
+  int maxChars;  // allocated size of chars
+  InternedName* names;  // indexed by id
+  int nNames;
+  int maxNames;  // allocated size of names
+  int* slots;  // id of a name plus one (0 for an empty slot)
+  int nSlots;  // size of slots: a power of two, twice maxNames
+} Interner;
+
+// The names of the source being compiled
+extern __thread Interner interner;
+
+/*
+ * Forgets all the names, so that ids start from 0 again. The memory of the
+ * interner is kept for the next names.
+ *
+ */
+void internerReset();
+
+/*
+ * Frees the memory of the interner, forgetting all the names.
+ *
+ */
+void internerRelease();
+
+/*
+ * Finds the id of a name, adding the name if it is new.
+ *
+ * name: the characters of the name (they do not have to be NUL terminated).
+ * size: the number of characters.
+ * returns: the id of the name.
+ *
+ */
+int internName(char* name, int size);
+
+/*
+ * Gets the characters of an interned name.
+ *
+ * id: the id of the name.
+ * returns: the name, NUL terminated (it must not be modified).
+ *
+ */
+char* internedName(int id);
+
+#endif
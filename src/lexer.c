@@ -8,28 +8,104 @@
 #include <string.h>
 #include "util.h"
 #include "lexer.h"
+#include "intern.h"
+#include "threadpool.h"
+#include "compiler.h"
+
+__thread LexerState lexerState;
+
+// A chunk of whole lines of a source, lexed by one of the threads
+typedef struct stLexChunk {
+  SourceFile* source;
+  char* begin;  // first character of the chunk
+  char* end;  // one past the last character of the chunk
+  LexerState state;  // lexer state after processing the chunk
+  int firstToken;  // position of its first token in the whole source
+  int lineOffset;  // line breaks in the source before the chunk
+  Token* tokens;  // tokens of the whole source
+} LexChunk;
 
-LexerState lexerState;
+/*
+ * Reports the first lexical error of a source lexed in chunks, once the
+ * memory of all the chunks is freed.
+ *
+ * chunks: the chunks of the source.
+ * nChunks: the number of chunks.
+ * index: the index of the first chunk with an error.
+ * lineOffset: line breaks in the source before that chunk.
+ *
+ */
+void chunkError(LexChunk* chunks, int nChunks, int index, int lineOffset);
+
+/*
+ * Lexes part of a source file, leaving the tokens in lexerState. Line
+ * numbers start from 1 at the beginning of the part.
+ *
+ * source: the source file being processed.
+ * begin: first character to process (the beginning of a line).
+ * end: one past the last character to process.
+ * errorJump: where to jump on lexical errors (NULL to report them).
+ *
+ */
+void lexRange(SourceFile* source, char* begin, char* end, jmp_buf* errorJump);
+
+/*
+ * Initializes the state of the lexer to process part of a source file.
+ *
+ * source: the source file being processed.
+ * begin: first character to process (the beginning of a line).
+ * end: one past the last character to process.
+ * maxTokens: initial size of the array of tokens.
+ * errorJump: where to jump on lexical errors (NULL to report them).
+ *
+ */
+void initLexerState(SourceFile* source, char* begin, char* end,
+  int maxTokens, jmp_buf* errorJump);
+
+/*
+ * Processes whatever is under the cursor: a token, whitespace or a comment.
+ *
+ */
+void lexNext();
 
 /*
- * Reads the next character of the source file and manages the related
- * lexer state variables.
+ * Lexes one of the chunks of a source (a task of the thread pool).
  *
- * returns: the character read or EOF.
+ * chunks: the array of LexChunk.
+ * index: index of the chunk to process.
  *
  */
-char lexerGetChar();
+void lexChunk(void* chunks, int index);
+
+/*
+ * Copies the tokens of a chunk to their position in the array of tokens of
+ * the whole source, fixing their line numbers (a task of the thread pool).
+ *
+ * chunks: the array of LexChunk.
+ * index: index of the chunk to process.
+ *
+ */
+void copyChunkTokens(void* chunks, int index);
 
 /*
  * Adds a new token to the list of processed tokens.
  *
+ * start: pointer to the first character of the token in the source.
  * size: the amount of characters (bytes) in this token.
  * type: type of token (identifier, integer literal, AND operator, etc.)
  * lnum: line number where this token was found.
  * chnum: position/column number where the token was found in the line.
  *
  */
-void addToken(int size, TokenType type, int lnum, int chnum);
+void addToken(char* start, int size, TokenType type, int lnum, int chnum);
+
+/*
+ * Returns the column of the character under the cursor.
+ *
+ * returns: the column number (starting from 1).
+ *
+ */
+int lexerColumn();
 
 /*
  * Processes identifiers and keywords.
@@ -50,7 +126,7 @@ void eatNumber();
 void eatSlash();
 
 /*
- * Processes tokens constituted of a single character, like (, ), {, }, etc.
+ * Processes string literals.
  *
  *
  * Note: Need to improve string eating. Only valid ASCII or UTF-8
@@ -72,174 +148,308 @@ void eatSingleSymb();
  */
 void eatDoubleSymb();
 
-// Size of the buffer used to read characters
-#define BUFFER_SIZE 100000
+/*
+ * Processes whitespace, keeping track of line breaks.
+ *
+ */
+void eatWhitespace();
 
 // Used to decide how much memory to allocate for tokens, at first.
 #define INITIAL_MAX_TOKENS 250
 
+// Expected minimum number of source bytes per token, used to pre-size the
+// array of tokens from the size of the source file.
+#define BYTES_PER_TOKEN 4
+
+// Size of the array of tokens when they are requested one by one (each
+// call to the eat* functions adds a token at most)
+#define STREAM_MAX_TOKENS 4
+
+// Minimum size of the chunks lexed in parallel. Sources smaller than two
+// chunks are lexed by a single thread.
+#define MIN_CHUNK_SIZE (256 * 1024)
+
+// Number of chunks per thread, so that threads finishing early can take
+// more work
+#define CHUNKS_PER_THREAD 4
+
 // To show debug messages:
 #define DEBUG
 
 
-void lexerStart(FILE* sourcefile, char* sourcefilename) {
+void lexerStart(SourceFile* source) {
 
   // Prints the source file
-  printFile(sourcefile);
+  printFile(source);
+
+  internerReset();
+  lexRange(source, source->data, source->data + source->size, NULL);
+
+  // give back the memory reserved for tokens that did not appear
+  lexerState.tokens = (Token*) realloc(lexerState.tokens,
+    sizeof(Token) * (lexerState.nTokens + 1));
+  lexerState.maxTokens = lexerState.nTokens + 1;
+
+  //printTokens();
+}
+
+int lexerThreads(SourceFile* source, int nThreads) {
+  if(nThreads < 1) nThreads = availableCores();
+
+  long maxChunks = source->size / MIN_CHUNK_SIZE;
+  if(nThreads < 2 || maxChunks < 2) return 1;
+  return nThreads < maxChunks ? nThreads : (int) maxChunks;
+}
+
+void lexerStartParallel(SourceFile* source, int nThreads) {
+  nThreads = lexerThreads(source, nThreads);
+  if(nThreads < 2) {
+    lexerStart(source);
+    return;
+  }
+
+  long nChunks = (long) nThreads * CHUNKS_PER_THREAD;
+  if(nChunks > source->size / MIN_CHUNK_SIZE)
+    nChunks = source->size / MIN_CHUNK_SIZE;
+
+  printFile(source);
+
+  // split the source after line breaks, in chunks of similar sizes
+  LexChunk* chunks = (LexChunk*) malloc(sizeof(LexChunk) * nChunks);
+  char* end = source->data + source->size;
+  char* begin = source->data;
+
+  for(int i = 0; i < nChunks; i++) {
+    char* chunkEnd = end;
+
+    if(i < nChunks - 1) {
+      char* target = source->data + source->size / nChunks * (i + 1);
+      if(target < begin) target = begin;
+      chunkEnd = scanLine(target, end);
+      if(chunkEnd < end) chunkEnd++; // the line break stays in this chunk
+    }
 
-  // Buffer to read the chars, is reset at the end of each token
-  char charBuffer[BUFFER_SIZE];
+    chunks[i] = (LexChunk) { .source = source, .begin = begin, .end = chunkEnd };
+    begin = chunkEnd;
+  }
+
+  runTasks(nThreads, nChunks, lexChunk, chunks);
+
+  // the first error in the source is in the first chunk with errors
+  int nTokens = 0;
+  int lineOffset = 0;
+
+  for(int i = 0; i < nChunks; i++) {
+    LexerState* state = &chunks[i].state;
+
+    if(state->errorMsg) chunkError(chunks, nChunks, i, lineOffset);
+
+    chunks[i].firstToken = nTokens;
+    chunks[i].lineOffset = lineOffset;
+    nTokens += state->nTokens;
+    lineOffset += state->lnum - 1;
+  }
+
+  // concatenate the tokens of all the chunks
+  Token* tokens = (Token*) malloc(sizeof(Token) * (nTokens + 1));
+  for(int i = 0; i < nChunks; i++) chunks[i].tokens = tokens;
+  runTasks(nThreads, nChunks, copyChunkTokens, chunks);
+
+  // identifiers are interned in order, so their ids do not depend on the
+  // threads
+  internerReset();
+  for(int i = 0; i < nTokens; i++) {
+    if(tokens[i].type == TTId) {
+      tokens[i].id = internName(source->data + tokens[i].start,
+        tokens[i].nameSize);
+    }
+  }
+
+  // the lexer ends in the state of the last chunk (skipping empty ones),
+  // with lines counted from the beginning of the source
+  int last = nChunks - 1;
+  while(last > 0 && chunks[last].begin == chunks[last].end) last--;
+
+  lexerState = chunks[last].state;
+  lexerState.lnum = lineOffset + 1;
+  lexerState.maxTokens = nTokens + 1;
+  lexerState.nTokens = nTokens;
+  lexerState.tokens = tokens;
+
+  free(chunks);
+}
+
+void chunkError(LexChunk* chunks, int nChunks, int index, int lineOffset) {
+  char msg[MAX_ERROR_MESSAGE];
+  snprintf(msg, MAX_ERROR_MESSAGE, "%s", chunks[index].state.errorMsg);
+
+  lexerState = chunks[index].state;
+  lexerState.lnum += lineOffset;
+  lexerState.tokens = NULL;
+  lexerState.errorJump = NULL;
+  lexerState.errorMsg = NULL;
+
+  for(int i = 0; i < nChunks; i++) {
+    free(chunks[i].state.tokens);
+    free(chunks[i].state.errorMsg);
+  }
+  free(chunks);
+
+  lexError(msg);
+}
+
+void lexChunk(void* chunks, int index) {
+  LexChunk* chunk = &((LexChunk*) chunks)[index];
+  jmp_buf errorJump;
+
+  if(setjmp(errorJump) == 0)
+    lexRange(chunk->source, chunk->begin, chunk->end, &errorJump);
+
+  chunk->state = lexerState;
+}
+
+void copyChunkTokens(void* chunks, int index) {
+  LexChunk* chunk = &((LexChunk*) chunks)[index];
+  Token* token = chunk->tokens + chunk->firstToken;
+
+  for(int i = 0; i < chunk->state.nTokens; i++, token++) {
+    *token = chunk->state.tokens[i];
+    token->lnum += chunk->lineOffset;
+  }
+
+  free(chunk->state.tokens);
+}
+
+void lexRange(SourceFile* source, char* begin, char* end, jmp_buf* errorJump) {
+  initLexerState(source, begin, end,
+    INITIAL_MAX_TOKENS + (end - begin) / BYTES_PER_TOKEN, errorJump);
+
+  while(lexerState.cur < lexerState.end) lexNext();
+}
+
+void lexerStartStream(SourceFile* source) {
+
+  // Prints the source file
+  printFile(source);
+
+  internerReset();
+  initLexerState(source, source->data, source->data + source->size,
+    STREAM_MAX_TOKENS, NULL);
+}
+
+int lexerNext(Token* token) {
+  lexerState.nTokens = 0;
+
+  // whitespace and comments do not produce tokens, keep going
+  while(lexerState.nTokens == 0 && lexerState.cur < lexerState.end)
+    lexNext();
+
+  if(lexerState.nTokens == 0) return 0;
+
+  *token = lexerState.tokens[0];
+  return 1;
+}
+
+void initLexerState(SourceFile* source, char* begin, char* end,
+  int maxTokens, jmp_buf* errorJump) {
 
   // Holds global state variables of the lexer
   lexerState = (LexerState) {
-    .maxTokens = INITIAL_MAX_TOKENS,
-    .buffer = charBuffer,
-    .file = sourcefile,
-    .filename = sourcefilename,
-    .lastChar = '\0',
+    .maxTokens = maxTokens,
+    .source = source,
+    .cur = begin,
+    .end = end,
+    .lineStart = begin,
     .lnum = 1,
-    .chnum = 0,
     .nTokens = 0, // number of tokens processed so far
-    .tokens = NULL
+    .tokens = NULL,
+    .errorJump = errorJump,
+    .errorMsg = NULL,
+    // chunks lexed by other threads (which jump on errors) are interned
+    // once they are put together
+    .internNames = (errorJump == NULL)
   };
 
   // The list of tokens in the source file
-  lexerState.tokens = (Token**) malloc(INITIAL_MAX_TOKENS * sizeof(Token*));
-
-  // starts with the first character
-  if(!feof(sourcefile)) {
-    charBuffer[0] = lexerGetChar();
-  }
+  lexerState.tokens = (Token*) malloc(lexerState.maxTokens * sizeof(Token));
+}
 
-  while(!feof(sourcefile)) {
-    char ch = charBuffer[0];
-
-    // depending on the character read, call a method to process next token(s)
-    // All functions should finish with the next character in buffer[0],
-    // and lexerState.chnum as the position (column) of buffer[0]
-    if(ch == '/') eatSlash();
-    else if(ch == '"') eatDQuote();
-    else if(isSingleCharToken(ch)) eatSingleSymb();
-    else if(startsDoubleOp(ch)) eatDoubleSymb();
-    else if(isAlpha(ch) || ch == '_') eatIDKW();
-    else if(isNum(ch)) eatNumber();
-    else if(isWhitespace(ch)) charBuffer[0] = lexerGetChar();
-    else { // unexpected character
-      char* format = "Unexpected character: '%c'.";
-      int len = strlen(format) - 1;
-      char str[len];
-      sprintf(str, format, ch);
-      lexError(str);
-    }
+void lexNext() {
+  char ch = *lexerState.cur;
+
+  // depending on the character read, call a method to process next token(s)
+  // All functions should finish with the cursor on the first character
+  // after the processed token(s)
+  if(HAS_CLASS(ch, CC_SPACE)) eatWhitespace();
+  else if(HAS_CLASS(ch, CC_ALPHA) || ch == '_') eatIDKW();
+  else if(HAS_CLASS(ch, CC_SINGLE)) eatSingleSymb();
+  else if(HAS_CLASS(ch, CC_DOUBLE)) eatDoubleSymb();
+  else if(HAS_CLASS(ch, CC_DIGIT)) eatNumber();
+  else if(ch == '/') eatSlash();
+  else if(ch == '"') eatDQuote();
+  else { // unexpected character
+    char* format = "Unexpected character: '%c'.";
+    int len = strlen(format);
+    char str[len];
+    sprintf(str, format, ch);
+    lexError(str);
   }
-
-  //printTokens();
 }
 
 void eatIDKW()
 {
-  int bufpos = 1;
-  char* buffer = lexerState.buffer;
-  int lnum = lexerState.lnum;
-  int chnum = lexerState.chnum;
-  char ch = lexerGetChar();
-  TokenType type = TTId;
-
-  while(isNum(ch) || isAlpha(ch) || ch == '_') { // Still ID or keyword
-    buffer[bufpos] = ch;
-    ch = lexerGetChar();
-    bufpos++;
-  }
+  char* start = lexerState.cur;
+  char* end = lexerState.end;
+  char* cur = scanIdentifier(start + 1, end);
+  int chnum = lexerColumn();
 
-  switch(bufpos) {
-    case 2:
-      if(strncmp("if", buffer, bufpos) == 0) type = TTIf;
-      else if(strncmp("or", buffer, bufpos) == 0) type = TTOr;
-      else if(strncmp("fn", buffer, bufpos) == 0) type = TTFunc;
-      break;
-    case 3:
-      if(strncmp("and", buffer, bufpos) == 0) type = TTAnd;
-      else if(strncmp("for", buffer, bufpos) == 0) type = TTFor;
-      else if(strncmp("int", buffer, bufpos) == 0) type = TTInt;
-      else if(strncmp("not", buffer, bufpos) == 0) type = TTNot;
-      break;
-    case 4:
-      if(strncmp("bool", buffer, bufpos) == 0) type = TTBool;
-      else if(strncmp("else", buffer, bufpos) == 0) type = TTElse;
-      else if(strncmp("next", buffer, bufpos) == 0) type = TTNext;
-      else if(strncmp("loop", buffer, bufpos) == 0) type = TTLoop;
-      else if(strncmp("true", buffer, bufpos) == 0) type = TTTrue;
-      break;
-    case 5:
-      if(strncmp("break", buffer, bufpos) == 0) type = TTBreak;
-      else if(strncmp("float", buffer, bufpos) == 0) type = TTFloat;
-      else if(strncmp("while", buffer, bufpos) == 0) type = TTWhile;
-      else if(strncmp("match", buffer, bufpos) == 0) type = TTMatch;
-      else if(strncmp("false", buffer, bufpos) == 0) type = TTFalse;
-      break;
-    case 6:
-      if(strncmp("string", buffer, bufpos) == 0) type = TTString;
-      else if(strncmp("return", buffer, bufpos) == 0) type = TTReturn;
-      break;
-  }
+  int size = cur - start;
+  TokenType type = keywordType(start, size);
 
   // Add the ID/keyword token
-  addToken(bufpos, type, lnum, chnum);
-  buffer[0] = lexerState.lastChar;
+  addToken(start, size, type, lexerState.lnum, chnum);
+  lexerState.cur = cur;
   return;
 }
 
 void eatNumber()
 {
-  int bufpos = 1;
-  char* buffer = lexerState.buffer;
-  int lnum = lexerState.lnum;
-  int chnum = lexerState.chnum;
-  char ch = lexerGetChar();
+  char* start = lexerState.cur;
+  char* end = lexerState.end;
+  char* cur = start + 1;
+  int chnum = lexerColumn();
   TokenType type = TTLitInt;
 
-  while(isNum(ch)) {
-    buffer[bufpos] = ch;
-    ch = lexerGetChar();
-    bufpos++;
-  }
+  while(cur < end && HAS_CLASS(*cur, CC_DIGIT)) cur++;
 
-  if(ch == '.') { // float, read the rest of the number
-    buffer[bufpos] = ch;
-    ch = lexerGetChar();
-    bufpos++;
+  if(cur < end && *cur == '.') { // float, read the rest of the number
+    cur++;
 
-    if(isNum(ch)) {
+    if(cur < end && HAS_CLASS(*cur, CC_DIGIT)) {
       type = TTLitFloat;
-
-      while(isNum(ch)) {
-        buffer[bufpos] = ch;
-        ch = lexerGetChar();
-        bufpos++;
-      }
-
+      while(cur < end && HAS_CLASS(*cur, CC_DIGIT)) cur++;
     } else {
+      lexerState.cur = cur;
       lexError("Invalid number.");
     }
   }
 
-  addToken(bufpos, type, lnum, chnum);
-  buffer[0] = lexerState.lastChar;
+  addToken(start, cur - start, type, lexerState.lnum, chnum);
+  lexerState.cur = cur;
   return;
 }
 
 void eatDoubleSymb()
 {
-  int bufpos = 1;
-  char* buffer = lexerState.buffer;
-  int lnum = lexerState.lnum;
-  int chnum = lexerState.chnum;
+  char* start = lexerState.cur;
+  int chnum = lexerColumn();
 
-  char ch = lexerGetChar();
+  char ch = '\0';
+  if(start + 1 < lexerState.end) ch = start[1];
   TokenType type = TTUnknown;
   int numChars = 2;
 
-  if(buffer[0] == '+') {
+  if(start[0] == '+') {
     if(ch == '+') {
       type = TTIncr;
     } else if(ch == '=') {
@@ -248,7 +458,7 @@ void eatDoubleSymb()
       type = TTPlus;
       numChars = 1;
     }
-  } else if(buffer[0] == '-') {
+  } else if(start[0] == '-') {
     if(ch == '-') {
       type = TTDecr;
     } else if(ch == '=') {
@@ -257,7 +467,7 @@ void eatDoubleSymb()
       type = TTMinus;
       numChars = 1;
     }
-  } else if(buffer[0] == '=') {
+  } else if(start[0] == '=') {
     if(ch == '=') {
       type = TTEq;
     } else if(ch == '>') {
@@ -266,14 +476,14 @@ void eatDoubleSymb()
       type = TTAssign;
       numChars = 1;
     }
-  } else if(buffer[0] == '>') {
+  } else if(start[0] == '>') {
     if(ch == '=') {
       type = TTGEq;
     } else { // just a greater than
       type = TTGreater;
       numChars = 1;
     }
-  } else if(buffer[0] == '<') {
+  } else if(start[0] == '<') {
     if(ch == '=') {
       type = TTLEq;
     } else { // just a less than
@@ -282,26 +492,18 @@ void eatDoubleSymb()
     }
   }
 
-  if(numChars == 2) {
-    buffer[bufpos] = ch;
-    addToken(numChars, type, lnum, chnum);
-    buffer[0] = lexerGetChar();
-  } else {
-    addToken(numChars, type, lnum, chnum);
-    buffer[0] = ch;
-  }
-
+  addToken(start, numChars, type, lexerState.lnum, chnum);
+  lexerState.cur += numChars;
   return;
 }
 
 void eatSingleSymb()
 {
-  char* buffer = lexerState.buffer;
-  int lnum = lexerState.lnum;
-  int chnum = lexerState.chnum;
+  char* start = lexerState.cur;
+  int chnum = lexerColumn();
   int type = TTUnknown;
 
-  switch(buffer[0]) {
+  switch(start[0]) {
     case '(': type = TTLPar;
       break;
     case ')': type = TTRPar;
@@ -322,93 +524,80 @@ void eatSingleSymb()
       break;
   }
 
-  addToken(1, type, lnum, chnum);
-  buffer[0] = lexerGetChar();
+  addToken(start, 1, type, lexerState.lnum, chnum);
+  lexerState.cur++;
   return;
 }
 
 void eatDQuote()
 {
-  int bufpos = 1;
-  char* buffer = lexerState.buffer;
-  int lnum = lexerState.lnum;
-  int chnum = lexerState.chnum;
-  char ch = lexerGetChar();
-
-  while(ch != '\n' && ch != '"') { // read string till end
-    buffer[bufpos] = ch;
-    ch = lexerGetChar();
-    bufpos++;
-  }
+  char* start = lexerState.cur;
+  char* end = lexerState.end;
+  char* cur = start + 1;
+  int chnum = lexerColumn();
 
-  if(ch == '\n') lexError("Line break in the middle of string.");
+  cur = scanString(cur, end); // read till end
 
-  // Here ch == '"'
-  buffer[bufpos] = ch;
-  addToken(bufpos + 1, TTLitString, lnum, chnum);
-  buffer[0] = lexerGetChar();
+  lexerState.cur = cur;
+  if(cur >= end) lexError("Unterminated string.");
+  if(*cur == '\n') lexError("Line break in the middle of string.");
+
+  // Here *cur == '"'
+  cur++;
+  addToken(start, cur - start, TTLitString, lexerState.lnum, chnum);
+  lexerState.cur = cur;
   return;
 }
 
 void eatSlash()
 {
-  char* buffer = lexerState.buffer;
-  int lnum = lexerState.lnum;
-  int chnum = lexerState.chnum;
-  char ch = lexerGetChar();
-
-  if(ch == '/') { // it was a comment
-    lexerGetChar();
+  char* start = lexerState.cur;
+  char* end = lexerState.end;
+  int chnum = lexerColumn();
 
+  if(start + 1 < end && start[1] == '/') { // it was a comment
     // discard until newline
-    while(lexerState.lastChar != '\n') lexerGetChar();
-    buffer[0] = lexerGetChar();
+    char* newline = scanLine(start + 2, end);
+
+    if(newline < end) {
+      lexerState.cur = newline + 1;
+      lexerState.lineStart = newline + 1;
+      lexerState.lnum++;
+    } else lexerState.cur = end;
   } else { // not a comment, thus division
-    addToken(1, TTDiv, lnum, chnum); // adds division op.
-    buffer[0] = ch;
+    addToken(start, 1, TTDiv, lexerState.lnum, chnum); // adds division op.
+    lexerState.cur++;
   }
   return;
 }
 
-void addToken(int size, TokenType type, int lnum, int chnum) {
-  char* tokenName = (char*) malloc((size + 1) * sizeof(char));
-
-  Token* token = (Token*) malloc(sizeof(Token));
-  token->name = tokenName;
-  token->nameSize = size;
-  token->type = type;
-  token->lnum = lnum;
-  token->chnum = chnum;
-
-  strncpy(tokenName, lexerState.buffer, size);
-  token->name[size] = '\0';
+void eatWhitespace()
+{
+  lexerState.cur = scanWhitespace(lexerState.cur, lexerState.end,
+    &lexerState.lnum, &lexerState.lineStart);
+}
 
+void addToken(char* start, int size, TokenType type, int lnum, int chnum) {
   if(lexerState.nTokens >= lexerState.maxTokens) {
     // doubles the size of the array of tokens
-    lexerState.tokens = (Token**) realloc(
-      lexerState.tokens, sizeof(Token*) * lexerState.maxTokens * 2);
+    lexerState.tokens = (Token*) realloc(
+      lexerState.tokens, sizeof(Token) * lexerState.maxTokens * 2);
 
     lexerState.maxTokens *= 2;
   }
-  lexerState.tokens[lexerState.nTokens] = token;
+
+  Token* token = &lexerState.tokens[lexerState.nTokens];
+  token->start = start - lexerState.source->data;
+  token->nameSize = size;
+  token->lnum = lnum;
+  token->chnum = chnum;
+  token->type = type;
+  token->id = -1;
+  if(type == TTId && lexerState.internNames)
+    token->id = internName(start, size);
   lexerState.nTokens++;
 }
 
-char lexerGetChar() {
-  if(!feof(lexerState.file)) {
-    char ch = fgetc(lexerState.file);
-    lexerState.lastChar = ch;
-    lexerState.prevLnum = lexerState.lnum;
-    lexerState.prevChnum = lexerState.chnum;
-
-    if(ch == '\n') {
-      lexerState.lnum++;
-      lexerState.chnum = 0;
-    } else {
-      lexerState.chnum++;
-    }
-    return ch;
-  }
-  else return EOF;
+int lexerColumn() {
+  return lexerState.cur - lexerState.lineStart + 1;
 }
-
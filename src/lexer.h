@@ -8,47 +8,103 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <setjmp.h>
 #include "datast.h"
 
 // Represents the global state of the lexer.
 typedef struct stLexerState {
   int maxTokens; // current size of the array of tokens
-  char* buffer;
-  FILE* file;
-  char* filename;
-  char lastChar;
-  int lnum;      // this should always point to the line of the last char read
-  int chnum;     // this should always point to the position of the last char
-  int prevLnum;
-  int prevChnum;
+  SourceFile* source;
+  char* cur;  // cursor: the next character to be processed
+  char* end;  // one past the last character of the source
+  char* lineStart;  // first character of the line being processed
+  int lnum;  // line number of the character under the cursor
   int nTokens;  // number of tokens processed
-  Token** tokens; // pointers to the processed tokens
+  Token* tokens; // the processed tokens
+  jmp_buf* errorJump;  // if set, lexical errors jump here unreported
+  char* errorMsg;  // message of the error that caused the jump
+  char internNames;  // 1 to intern identifiers as they are found
 } LexerState;
 
-// Global state of the lexer.
-extern LexerState lexerState;
+// Global state of the lexer (each thread lexing a chunk has its own copy).
+extern __thread LexerState lexerState;
+
+// Character classes used by the lexer (bit flags of the charClass table)
+#define CC_ALPHA 1  // ASCII letters
+#define CC_DIGIT 2  // decimal digits
+#define CC_SPACE 4  // whitespace: ' ', '\t' and '\n'
+#define CC_SINGLE 8  // single character tokens: (, ), {, }, ;, *, %, :, ,
+#define CC_DOUBLE 16  // first character of 2-char operators: =, +, -, >, <
+#define CC_IDCHAR 32  // characters allowed in identifiers: letters, digits, _
+
+// Classes of each of the 256 possible bytes (combinations of CC_ flags).
+extern const unsigned char charClass[256];
+
+// Checks whether a character belongs to any of the given classes
+#define HAS_CLASS(ch, classes) (charClass[(unsigned char) (ch)] & (classes))
 
 /*
  * Starts the lexer.
  *
- * sourcefile: pointer to the source file to process (file should be already
- *   open for reading/text mode). The file will be left open.
- * sourcefilename: name of the source file, used for messages.
+ * source: the source file to process, already loaded in memory.
+ *
+ */
+void lexerStart(SourceFile* source);
+
+/*
+ * Starts the lexer, splitting big sources into chunks of whole lines that
+ * are lexed in parallel. No token spans a line break, so the resulting
+ * tokens (and lexical errors) are exactly the same as with lexerStart.
+ * Small sources are lexed by the calling thread only.
+ *
+ * source: the source file to process, already loaded in memory.
+ * nThreads: maximum number of threads to use (0 to use all cores).
+ *
+ */
+void lexerStartParallel(SourceFile* source, int nThreads);
+
+/*
+ * Prepares the lexer to produce the tokens of a source file one at a time,
+ * as lexerNext is called. The tokens are not kept by the lexer.
+ *
+ * source: the source file to process, already loaded in memory.
+ *
+ */
+void lexerStartStream(SourceFile* source);
+
+/*
+ * Processes the source until the next token is found (see
+ * lexerStartStream).
+ *
+ * token: where the next token is copied to.
+ * returns: 1 if a token was found, 0 at the end of the source.
  *
  */
-void lexerStart(FILE* sourcefile, char* filename);
+int lexerNext(Token* token);
 
 /*
- * Prints a text file.
+ * Returns the number of threads that lexerStartParallel would use to lex a
+ * source file.
  *
- * file: pointer to the file (should be open, will be rewinded and
- *   will not be closed).
+ * source: the source file to be processed.
+ * nThreads: maximum number of threads to use (0 to use all cores).
+ * returns: the number of threads (1 if the source is lexed serially).
  *
  */
-void printFile(FILE* file);
+int lexerThreads(SourceFile* source, int nThreads);
 
 /*
- * Prints an error message and exits the program with exit code 1.
+ * Prints the contents of a source file (debug mode only).
+ *
+ * source: the source file to be printed.
+ *
+ */
+void printFile(SourceFile* source);
+
+/*
+ * Prints an error message and stops the compilation. When lexing a chunk
+ * of a source (see lexerStartParallel) the message is kept and the lexer
+ * jumps to lexerState.errorJump instead.
  *
  * msg: message to be printed.
  *
@@ -102,6 +158,64 @@ int isSingleCharToken(char character);
  */
 int startsDoubleOp(char character);
 
+/*
+ * Classifies an identifier-like word as a keyword or identifier. The word is
+ * read in place (it does not have to be NUL terminated).
+ *
+ * text: pointer to the first character of the word.
+ * size: number of characters in the word.
+ * returns: the keyword token type (TTIf, TTWhile, etc.), or TTId if the word
+ *   is not a keyword.
+ *
+ */
+TokenType keywordType(char* text, int size);
+
+/*
+ * Finds the end of an identifier or keyword, processing several characters
+ * at a time when SSE2/AVX2 are available.
+ *
+ * cur: first character to be checked.
+ * end: one past the last character of the source.
+ * returns: pointer to the first character that cannot be part of an
+ *   identifier, or end.
+ *
+ */
+char* scanIdentifier(char* cur, char* end);
+
+/*
+ * Finds the end of the contents of a string literal, processing several
+ * characters at a time when SSE2/AVX2 are available.
+ *
+ * cur: first character inside the string literal.
+ * end: one past the last character of the source.
+ * returns: pointer to the first '"' or '\n' found, or end.
+ *
+ */
+char* scanString(char* cur, char* end);
+
+/*
+ * Finds the end of a line, e.g. to skip a comment.
+ *
+ * cur: first character to be checked.
+ * end: one past the last character of the source.
+ * returns: pointer to the first '\n' found, or end.
+ *
+ */
+char* scanLine(char* cur, char* end);
+
+/*
+ * Skips whitespace, processing several characters at a time when SSE2/AVX2
+ * are available, and keeps track of the line breaks found.
+ *
+ * cur: first character to be checked.
+ * end: one past the last character of the source.
+ * lnum: line number, incremented for every line break skipped.
+ * lineStart: set to the character after the last line break skipped.
+ * returns: pointer to the first character that is not whitespace, or end.
+ *
+ */
+char* scanWhitespace(char* cur, char* end, int* lnum, char** lineStart);
+
 void printTokens();
 
 #endif
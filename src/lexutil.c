@@ -5,76 +5,275 @@
  *
  */
 
+#include <string.h>
 #include "cli.h"
 #include "util.h"
 #include "lexer.h"
+#include "compiler.h"
+
+// Vector operations used by the scanning functions. Each vector holds
+// SCAN_WIDTH characters, and comparisons give a mask with one bit per
+// character. Without SSE2/AVX2 only the scalar loops are used.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_SIMD
+#define SCAN_WIDTH 32
+typedef __m256i ScanVector;
+#define SCAN_LOAD(ptr) _mm256_loadu_si256((const __m256i*) (ptr))
+#define SCAN_SPLAT(ch) _mm256_set1_epi8((char) (ch))
+#define SCAN_EQ(a, b) _mm256_cmpeq_epi8((a), (b))
+#define SCAN_GT(a, b) _mm256_cmpgt_epi8((a), (b))
+#define SCAN_ADD(a, b) _mm256_add_epi8((a), (b))
+#define SCAN_OR(a, b) _mm256_or_si256((a), (b))
+#define SCAN_MASK(v) ((unsigned int) _mm256_movemask_epi8(v))
+#define SCAN_FULL_MASK 0xFFFFFFFFu
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCAN_SIMD
+#define SCAN_WIDTH 16
+typedef __m128i ScanVector;
+#define SCAN_LOAD(ptr) _mm_loadu_si128((const __m128i*) (ptr))
+#define SCAN_SPLAT(ch) _mm_set1_epi8((char) (ch))
+#define SCAN_EQ(a, b) _mm_cmpeq_epi8((a), (b))
+#define SCAN_GT(a, b) _mm_cmpgt_epi8((a), (b))
+#define SCAN_ADD(a, b) _mm_add_epi8((a), (b))
+#define SCAN_OR(a, b) _mm_or_si128((a), (b))
+#define SCAN_MASK(v) ((unsigned int) _mm_movemask_epi8(v))
+#define SCAN_FULL_MASK 0xFFFFu
+#endif
+
+#ifdef SCAN_SIMD
+// Compares every character of v against the range [lo, hi]. Characters are
+// shifted so that lo becomes -128, which allows a single signed comparison.
+#define SCAN_IN_RANGE(v, lo, hi) \
+  SCAN_GT(SCAN_SPLAT(-128 + (hi) - (lo) + 1), \
+    SCAN_ADD((v), SCAN_SPLAT(0x80 - (lo))))
+#endif
+
+// Shorthands for the character classes table
+#define AL (CC_ALPHA | CC_IDCHAR)
+#define DG (CC_DIGIT | CC_IDCHAR)
+#define SP CC_SPACE
+#define SG CC_SINGLE
+#define DB CC_DOUBLE
+
+const unsigned char charClass[256] = {
+  ['\t'] = SP, ['\n'] = SP, [' '] = SP,
+
+  ['('] = SG, [')'] = SG, ['{'] = SG, ['}'] = SG, [';'] = SG, ['*'] = SG,
+  ['%'] = SG, [':'] = SG, [','] = SG,
+
+  ['='] = DB, ['+'] = DB, ['-'] = DB, ['>'] = DB, ['<'] = DB,
+
+  ['0'] = DG, ['1'] = DG, ['2'] = DG, ['3'] = DG, ['4'] = DG,
+  ['5'] = DG, ['6'] = DG, ['7'] = DG, ['8'] = DG, ['9'] = DG,
+
+  ['_'] = CC_IDCHAR,
+
+  ['A'] = AL, ['B'] = AL, ['C'] = AL, ['D'] = AL, ['E'] = AL, ['F'] = AL,
+  ['G'] = AL, ['H'] = AL, ['I'] = AL, ['J'] = AL, ['K'] = AL, ['L'] = AL,
+  ['M'] = AL, ['N'] = AL, ['O'] = AL, ['P'] = AL, ['Q'] = AL, ['R'] = AL,
+  ['S'] = AL, ['T'] = AL, ['U'] = AL, ['V'] = AL, ['W'] = AL, ['X'] = AL,
+  ['Y'] = AL, ['Z'] = AL,
+
+  ['a'] = AL, ['b'] = AL, ['c'] = AL, ['d'] = AL, ['e'] = AL, ['f'] = AL,
+  ['g'] = AL, ['h'] = AL, ['i'] = AL, ['j'] = AL, ['k'] = AL, ['l'] = AL,
+  ['m'] = AL, ['n'] = AL, ['o'] = AL, ['p'] = AL, ['q'] = AL, ['r'] = AL,
+  ['s'] = AL, ['t'] = AL, ['u'] = AL, ['v'] = AL, ['w'] = AL, ['x'] = AL,
+  ['y'] = AL, ['z'] = AL
+};
+
+#undef AL
+#undef DG
+#undef SP
+#undef SG
+#undef DB
+
+// Size of the keywords table (must be a power of 2)
+#define KEYWORD_TABLE_SIZE 64
+
+// Length of the shortest and of the longest keywords
+#define MIN_KEYWORD_SIZE 2
+#define MAX_KEYWORD_SIZE 6
+
+// Perfect hash function for the keywords: every keyword falls in a
+// different slot of the keywords table. If a keyword is added, the
+// multiplier (or the table size) may have to be chosen again so that
+// there are no collisions.
+#define KEYWORD_HASH(text, size) \
+  (((unsigned char) (text)[0] + (unsigned char) (text)[(size) - 1] \
+    + 11 * (size)) & (KEYWORD_TABLE_SIZE - 1))
+
+typedef struct stKeyword {
+  char* text;
+  int size;
+  TokenType type;
+} Keyword;
+
+// Keywords indexed by their hash (the index is KEYWORD_HASH of the keyword)
+const Keyword keywordTable[KEYWORD_TABLE_SIZE] = {
+  [2] = { "false", 5, TTFalse },
+  [3] = { "not", 3, TTNot },
+  [4] = { "break", 5, TTBreak },
+  [5] = { "true", 4, TTTrue },
+  [8] = { "loop", 4, TTLoop },
+  [12] = { "match", 5, TTMatch },
+  [14] = { "next", 4, TTNext },
+  [17] = { "float", 5, TTFloat },
+  [19] = { "while", 5, TTWhile },
+  [21] = { "extern", 6, TTExtern },
+  [27] = { "export", 6, TTExport },
+  [28] = { "string", 6, TTString },
+  [34] = { "return", 6, TTReturn },
+  [37] = { "if", 2, TTIf },
+  [38] = { "and", 3, TTAnd },
+  [42] = { "fn", 2, TTFunc },
+  [54] = { "else", 4, TTElse },
+  [55] = { "or", 2, TTOr },
+  [57] = { "for", 3, TTFor },
+  [58] = { "bool", 4, TTBool },
+  [62] = { "int", 3, TTInt }
+};
 
 int isWhitespace(char character) {
-  if(character == ' ' || character == '\n' || character == '\t') return 1;
-  return 0;
+  return HAS_CLASS(character, CC_SPACE) != 0;
 }
 
 int isAlpha(char character) {
-  if((character >= 'a' && character <= 'z') ||
-    (character >= 'A' && character <= 'Z')) {
-    return 1;
-  }
-  return 0;
+  return HAS_CLASS(character, CC_ALPHA) != 0;
 }
 
 int isNum(char character) {
-  if(character >= '0' && character <= '9') return 1;
-  return 0;
+  return HAS_CLASS(character, CC_DIGIT) != 0;
 }
 
 int startsDoubleOp(char character) {
-  if(character == '=' || character == '+' || character == '-' ||
-     character == '>' || character == '<') return 1;
-  return 0;
+  return HAS_CLASS(character, CC_DOUBLE) != 0;
+}
+
+TokenType keywordType(char* text, int size) {
+  if(size < MIN_KEYWORD_SIZE || size > MAX_KEYWORD_SIZE) return TTId;
+
+  const Keyword* keyword = &keywordTable[KEYWORD_HASH(text, size)];
+  if(keyword->size == size && memcmp(keyword->text, text, size) == 0)
+    return keyword->type;
+  return TTId;
 }
 
 int isSingleCharToken(char ch) {
-  if(ch == '(' || ch == ')' || ch == '{' || ch == '}' ||
-     ch == ';' || ch == '*' || ch == '%' || ch == ':' ||
-     ch == ',')
-    return 1;
-  return 0;
+  return HAS_CLASS(ch, CC_SINGLE) != 0;
 }
 
-void printFile(FILE* file) {
-  if(file == stdin) return;
-  if(cli.outputType > OUT_DEBUG) return;
+char* scanIdentifier(char* cur, char* end) {
+#ifdef SCAN_SIMD
+  while(end - cur >= SCAN_WIDTH) {
+    ScanVector chars = SCAN_LOAD(cur);
+
+    // letters are checked in lowercase (setting bit 0x20)
+    ScanVector idChars = SCAN_OR(
+      SCAN_IN_RANGE(SCAN_OR(chars, SCAN_SPLAT(0x20)), 'a', 'z'),
+      SCAN_OR(SCAN_IN_RANGE(chars, '0', '9'),
+        SCAN_EQ(chars, SCAN_SPLAT('_'))));
 
-  rewind(file);
-  char ch = fgetc(file);
+    unsigned int others = ~SCAN_MASK(idChars) & SCAN_FULL_MASK;
+    if(others) return cur + __builtin_ctz(others);
+    cur += SCAN_WIDTH;
+  }
+#endif
+
+  while(cur < end && HAS_CLASS(*cur, CC_IDCHAR)) cur++;
+  return cur;
+}
+
+char* scanString(char* cur, char* end) {
+#ifdef SCAN_SIMD
+  while(end - cur >= SCAN_WIDTH) {
+    ScanVector chars = SCAN_LOAD(cur);
+    unsigned int stops = SCAN_MASK(SCAN_OR(
+      SCAN_EQ(chars, SCAN_SPLAT('"')), SCAN_EQ(chars, SCAN_SPLAT('\n'))));
+
+    if(stops) return cur + __builtin_ctz(stops);
+    cur += SCAN_WIDTH;
+  }
+#endif
+
+  while(cur < end && *cur != '"' && *cur != '\n') cur++;
+  return cur;
+}
+
+char* scanLine(char* cur, char* end) {
+  // the C library already searches single characters with the widest
+  // vector instructions of the running CPU
+  char* newline = memchr(cur, '\n', end - cur);
+  return newline ? newline : end;
+}
+
+char* scanWhitespace(char* cur, char* end, int* lnum, char** lineStart) {
+#ifdef SCAN_SIMD
+  while(end - cur >= SCAN_WIDTH) {
+    ScanVector chars = SCAN_LOAD(cur);
+    ScanVector newlines = SCAN_EQ(chars, SCAN_SPLAT('\n'));
+    ScanVector spaces = SCAN_OR(newlines, SCAN_OR(
+      SCAN_EQ(chars, SCAN_SPLAT(' ')), SCAN_EQ(chars, SCAN_SPLAT('\t'))));
 
-  while(!feof(file)) {
-    printf("%c", ch);
-    ch = fgetc(file);
+    unsigned int others = ~SCAN_MASK(spaces) & SCAN_FULL_MASK;
+    int count = others ? __builtin_ctz(others) : SCAN_WIDTH;
+
+    // only the line breaks before the first non-whitespace character count
+    unsigned int breaks = SCAN_MASK(newlines);
+    if(count < SCAN_WIDTH) breaks &= (1u << count) - 1;
+    if(breaks) {
+      *lnum += __builtin_popcount(breaks);
+      *lineStart = cur + (31 - __builtin_clz(breaks)) + 1;
+    }
+
+    if(others) return cur + count;
+    cur += SCAN_WIDTH;
+  }
+#endif
+
+  while(cur < end && HAS_CLASS(*cur, CC_SPACE)) {
+    if(*cur == '\n') {
+      (*lnum)++;
+      *lineStart = cur + 1;
+    }
+    cur++;
   }
+  return cur;
+}
+
+void printFile(SourceFile* source) {
+  if(cli.outputType > OUT_DEBUG) return;
+
+  fwrite(source->data, sizeof(char), source->size, stdout);
   printf("\n");
-  rewind(file);
 }
 
 void lexError(char* msg) {
-  if(cli.outputType > OUT_DEFAULT) exit(1);
+  if(lexerState.errorJump) { // lexing a chunk, the error is reported later
+    lexerState.errorMsg = (char*) malloc(strlen(msg) + 1);
+    strcpy(lexerState.errorMsg, msg);
+    longjmp(*lexerState.errorJump, 1);
+  }
+
+  int chnum = lexerState.cur - lexerState.lineStart + 1;
+  if(cli.outputType > OUT_DEFAULT)
+    failCompilation(PHASE_LEXER, msg, lexerState.lnum, chnum);
 
   fprintf(stderr, "\nLexical " ERROR_COLOR_START "ERROR" COLOR_END
     ": %s\n%s: line: %d, column: %d.\n", msg,
-    lexerState.filename, lexerState.lnum, lexerState.chnum);
-  printCharInFile(lexerState.file, lexerState.filename,
-    lexerState.lnum, lexerState.chnum);
-  exit(1);
+    lexerState.source->filename, lexerState.lnum, chnum);
+  printCharInFile(lexerState.source, lexerState.lnum, chnum);
+  failCompilation(PHASE_LEXER, msg, lexerState.lnum, chnum);
 }
 
 void printTokens() {
   if(cli.outputType != OUT_DEBUG) return;
 
   for(int i = 0; i < lexerState.nTokens; i++) {
-    Token* t = lexerState.tokens[i];
-    printf("\n\n||%s||, type:%d, pos:%d,%d\n",
-      t->name, t->type, t->lnum, t->chnum);
-    printTokenInFile(lexerState.file, lexerState.filename, t);
+    Token* t = &lexerState.tokens[i];
+    printf("\n\n||%.*s||, type:%d, pos:%d,%d\n", t->nameSize,
+      tokenText(lexerState.source, t), t->type, t->lnum, t->chnum);
+    printTokenInFile(lexerState.source, t);
   }
 }
-
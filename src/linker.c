@@ -0,0 +1,416 @@
+/*
+ *
+ *
+ * Linker of object files into a static executable.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "linker.h"
+#include "arena.h"
+#include "cli.h"
+#include "compiler.h"
+#include "intern.h"
+#include "source.h"
+#include "util.h"
+#include "xgen.h"
+
+// Fills the gaps between the code of the objects (int3)
+#define CODE_PADDING 0xCC
+
+__thread LinkerState linkerState;
+
+/*
+ * Loads an object file and checks that it can be linked.
+ *
+ * object: where to leave it.
+ * name: the name of the file.
+ *
+ */
+void loadObject(LinkerObject* object, char* name);
+
+/*
+ * Places the code and the global variables of the objects in the
+ * executable: the global variables first, and then the code, starting at a
+ * new page.
+ *
+ */
+void placeSections();
+
+/*
+ * Records the addresses of the global symbols defined by the objects.
+ *
+ */
+void defineSymbols();
+
+/*
+ * Copies the code of the objects and fills in their relocations.
+ *
+ */
+void relocateCode();
+
+/*
+ * Gets the address of a symbol defined by an object.
+ *
+ * object: the object.
+ * symbol: the symbol.
+ * returns: its address in the executable.
+ *
+ */
+long definedAddress(LinkerObject* object, Elf64_Sym* symbol);
+
+/*
+ * Gets the address of a symbol referred to by an object, which may be
+ * defined by another one.
+ *
+ * object: the object.
+ * index: the position of the symbol in the symbols of the object.
+ * returns: its address in the executable (0 for an undefined weak symbol).
+ *
+ */
+long symbolAddress(LinkerObject* object, int index);
+
+/*
+ * Gets the name of a symbol of an object.
+ *
+ * object: the object.
+ * symbol: the symbol.
+ * returns: the name (it must not be modified).
+ *
+ */
+char* symbolName(LinkerObject* object, Elf64_Sym* symbol);
+
+/*
+ * Writes a number to the code, little endian.
+ *
+ * at: where to write it.
+ * value: the number.
+ * size: its size in bytes.
+ *
+ */
+void writeValue(char* at, long value, int size);
+
+/*
+ * Prints an error about a symbol and stops the link.
+ *
+ * fmt: the message, with a %s for the name of the symbol.
+ * name: the name of the symbol.
+ * fileName: the object file where it was found (NULL if none).
+ *
+ */
+void symbolError(char* fmt, char* name, char* fileName)
+  __attribute__((noreturn));
+
+/*
+ * Prints an error and stops the link.
+ *
+ * msg: the message.
+ * fileName: the object file where it was found (NULL if none).
+ *
+ */
+void linkerError(char* msg, char* fileName) __attribute__((noreturn));
+
+
+void linkerStart(char** objectNames, int nObjects, char* outputName) {
+  linkerState = (LinkerState) {
+    .objects = (LinkerObject*) arenaAlloc(&compArena,
+      sizeof(LinkerObject) * nObjects),
+    .nObjects = nObjects
+  };
+  memset(linkerState.objects, 0, sizeof(LinkerObject) * nObjects);
+
+  for(int i = 0; i < nObjects; i++)
+    loadObject(&linkerState.objects[i], objectNames[i]);
+
+  placeSections();
+  defineSymbols();
+  relocateCode();
+
+  int start = internName("_start", strlen("_start"));
+  if(linkerState.nameAddresses[start] < 0)
+    linkerError("No entry point: none of the objects has code outside "
+      "functions.", NULL);
+
+  int execFd = createExecFile(outputName);
+  writeOutput(execFd, linkerState.code, linkerState.codeSize);
+  writeExecHeaders(execFd, linkerState.nameAddresses[start],
+    linkerState.codeSize, linkerState.bssSize);
+  closeExecFile(execFd);
+}
+
+void releaseLinker() {
+  for(int i = 0; i < linkerState.nObjects; i++) {
+    if(linkerState.objects[i].file)
+      closeSource(linkerState.objects[i].file);
+  }
+  linkerState = (LinkerState) { .objects = NULL, .nObjects = 0 };
+}
+
+void loadObject(LinkerObject* object, char* name) {
+  SourceFile* file = loadSource(name);
+  if(!file) linkerError("Cannot read the object file.", name);
+  object->file = file;
+
+  Elf64_Ehdr* header = (Elf64_Ehdr*) file->data;
+  if(file->size < (long) sizeof(Elf64_Ehdr)
+     || memcmp(header->e_ident, ELFMAG, SELFMAG) != 0
+     || header->e_ident[EI_CLASS] != ELFCLASS64
+     || header->e_ident[EI_DATA] != ELFDATA2LSB
+     || header->e_type != ET_REL || header->e_machine != EM_X86_64)
+    linkerError("Not an x86-64 ELF64 object file.", name);
+
+  if(header->e_shentsize != sizeof(Elf64_Shdr)
+     || header->e_shoff + header->e_shnum * sizeof(Elf64_Shdr)
+        > (unsigned long) file->size)
+    linkerError("Malformed object file.", name);
+
+  object->sections = (Elf64_Shdr*) (file->data + header->e_shoff);
+  object->nSections = header->e_shnum;
+  object->sectionAddresses = (long*) arenaAlloc(&compArena,
+    sizeof(long) * object->nSections);
+
+  for(int i = 0; i < object->nSections; i++) {
+    Elf64_Shdr* section = &object->sections[i];
+    object->sectionAddresses[i] = -1;
+
+    if(section->sh_type != SHT_NOBITS
+       && section->sh_offset + section->sh_size > (unsigned long) file->size)
+      linkerError("Malformed object file.", name);
+    if(section->sh_type == SHT_REL)
+      linkerError("Relocations without addends are not supported.", name);
+
+    // the symbols (there is one table of them) and their names
+    if(section->sh_type == SHT_SYMTAB) {
+      if(section->sh_link >= (unsigned) object->nSections)
+        linkerError("Malformed object file.", name);
+      Elf64_Shdr* names = &object->sections[section->sh_link];
+      object->symbols = (Elf64_Sym*) (file->data + section->sh_offset);
+      object->nSymbols = section->sh_size / sizeof(Elf64_Sym);
+      object->names = file->data + names->sh_offset;
+      object->namesSize = names->sh_size;
+
+      if(names->sh_offset + names->sh_size > (unsigned long) file->size
+         || object->namesSize < 1
+         || object->names[object->namesSize - 1] != '\0')
+        linkerError("Malformed object file.", name);
+    }
+  }
+}
+
+void placeSections() {
+  // offsets first, as the code goes after all the global variables
+  for(int i = 0; i < linkerState.nObjects; i++) {
+    LinkerObject* object = &linkerState.objects[i];
+
+    for(int j = 0; j < object->nSections; j++) {
+      Elf64_Shdr* section = &object->sections[j];
+      if(!(section->sh_flags & SHF_ALLOC)) continue;
+
+      long align = section->sh_addralign > 1 ? section->sh_addralign : 1;
+      long* size;
+      if(section->sh_type == SHT_PROGBITS
+         && (section->sh_flags & SHF_EXECINSTR))
+        size = &linkerState.codeSize;
+      else if(section->sh_type == SHT_NOBITS) size = &linkerState.bssSize;
+      else if(section->sh_size == 0) continue;
+      else linkerError("Unsupported section (only code and uninitialized "
+        "data can be linked).", object->file->filename);
+
+      *size = (*size + align - 1) / align * align;
+      object->sectionAddresses[j] = *size;
+      *size += section->sh_size;
+    }
+  }
+
+  linkerState.codeAddress = execCodeAddress(linkerState.bssSize);
+  for(int i = 0; i < linkerState.nObjects; i++) {
+    LinkerObject* object = &linkerState.objects[i];
+
+    for(int j = 0; j < object->nSections; j++) {
+      if(object->sectionAddresses[j] < 0) continue;
+      object->sectionAddresses[j] +=
+        object->sections[j].sh_type == SHT_NOBITS ? EXEC_BASE_ADDRESS
+        : linkerState.codeAddress;
+    }
+  }
+}
+
+void defineSymbols() {
+  // every global name gets an id, whether it is defined or not
+  internerReset();
+  for(int i = 0; i < linkerState.nObjects; i++) {
+    LinkerObject* object = &linkerState.objects[i];
+
+    for(int j = 1; j < object->nSymbols; j++) {
+      Elf64_Sym* symbol = &object->symbols[j];
+      if(ELF64_ST_BIND(symbol->st_info) == STB_LOCAL) continue;
+      char* name = symbolName(object, symbol);
+      internName(name, strlen(name));
+    }
+  }
+
+  // room for _start, even if no object has it
+  int nNames = interner.nNames + 1;
+  linkerState.nameAddresses = (long*) arenaAlloc(&compArena,
+    sizeof(long) * nNames);
+  linkerState.nameWeak = (char*) arenaAlloc(&compArena, nNames);
+  for(int i = 0; i < nNames; i++) linkerState.nameAddresses[i] = -1;
+  memset(linkerState.nameWeak, 0, nNames);
+
+  // a weak definition gives way to a global one
+  for(int i = 0; i < linkerState.nObjects; i++) {
+    LinkerObject* object = &linkerState.objects[i];
+
+    for(int j = 1; j < object->nSymbols; j++) {
+      Elf64_Sym* symbol = &object->symbols[j];
+      int binding = ELF64_ST_BIND(symbol->st_info);
+      if(binding == STB_LOCAL || symbol->st_shndx == SHN_UNDEF) continue;
+
+      char* name = symbolName(object, symbol);
+      int id = internName(name, strlen(name));
+      char weak = binding == STB_WEAK;
+      if(linkerState.nameAddresses[id] >= 0) {
+        if(weak) continue;
+        if(!linkerState.nameWeak[id])
+          symbolError("Multiple definitions of '%s'.", name,
+            object->file->filename);
+      }
+
+      linkerState.nameAddresses[id] = definedAddress(object, symbol);
+      linkerState.nameWeak[id] = weak;
+    }
+  }
+}
+
+void relocateCode() {
+  long size = linkerState.codeSize;
+  linkerState.code = (char*) arenaAlloc(&compArena, size > 0 ? size : 1);
+  memset(linkerState.code, CODE_PADDING, size);
+
+  for(int i = 0; i < linkerState.nObjects; i++) {
+    LinkerObject* object = &linkerState.objects[i];
+    char* fileName = object->file->filename;
+
+    for(int j = 0; j < object->nSections; j++) {
+      Elf64_Shdr* section = &object->sections[j];
+      if(section->sh_type == SHT_PROGBITS
+         && object->sectionAddresses[j] >= 0) {
+        memcpy(linkerState.code
+          + (object->sectionAddresses[j] - linkerState.codeAddress),
+          object->file->data + section->sh_offset, section->sh_size);
+      }
+    }
+
+    for(int j = 0; j < object->nSections; j++) {
+      Elf64_Shdr* relocations = &object->sections[j];
+      if(relocations->sh_type != SHT_RELA) continue;
+
+      // the relocations of sections not linked (such as debugging
+      // information) are not needed
+      int target = relocations->sh_info;
+      if(target >= object->nSections
+         || object->sectionAddresses[target] < 0)
+        continue;
+      Elf64_Shdr* section = &object->sections[target];
+      if(section->sh_type != SHT_PROGBITS)
+        linkerError("Malformed object file.", fileName);
+
+      Elf64_Rela* rela = (Elf64_Rela*) (object->file->data
+        + relocations->sh_offset);
+      int nRelocations = relocations->sh_size / sizeof(Elf64_Rela);
+
+      for(int k = 0; k < nRelocations; k++) {
+        int type = ELF64_R_TYPE(rela[k].r_info);
+        int symbol = ELF64_R_SYM(rela[k].r_info);
+        int width = type == R_X86_64_64 ? 8 : 4;
+        if(symbol >= object->nSymbols
+           || rela[k].r_offset + width > section->sh_size)
+          linkerError("Malformed object file.", fileName);
+
+        long place = object->sectionAddresses[target] + rela[k].r_offset;
+        long value = symbolAddress(object, symbol) + rela[k].r_addend;
+        char* at = linkerState.code + (place - linkerState.codeAddress);
+
+        switch(type) {
+          case R_X86_64_NONE:
+            continue;
+          case R_X86_64_PC32:
+          case R_X86_64_PLT32:
+            value -= place;
+            // fall through
+          case R_X86_64_32S:
+            if(value < INT32_MIN || value > INT32_MAX)
+              linkerError("Relocation out of range.", fileName);
+            break;
+          case R_X86_64_32:
+            if(value < 0 || value > UINT32_MAX)
+              linkerError("Relocation out of range.", fileName);
+            break;
+          case R_X86_64_64:
+            break;
+          default:
+            linkerError("Unsupported relocation type.", fileName);
+        }
+        writeValue(at, value, width);
+      }
+    }
+  }
+}
+
+long definedAddress(LinkerObject* object, Elf64_Sym* symbol) {
+  if(symbol->st_shndx == SHN_ABS) return symbol->st_value;
+  if(symbol->st_shndx == SHN_COMMON)
+    symbolError("Common symbol '%s' not supported.",
+      symbolName(object, symbol), object->file->filename);
+
+  if(symbol->st_shndx >= object->nSections
+     || object->sectionAddresses[symbol->st_shndx] < 0)
+    symbolError("Symbol '%s' is in a section that is not linked.",
+      symbolName(object, symbol), object->file->filename);
+  return object->sectionAddresses[symbol->st_shndx] + symbol->st_value;
+}
+
+long symbolAddress(LinkerObject* object, int index) {
+  Elf64_Sym* symbol = &object->symbols[index];
+  if(index == 0) return 0; // no symbol
+
+  if(ELF64_ST_BIND(symbol->st_info) == STB_LOCAL)
+    return definedAddress(object, symbol);
+
+  // global symbols are resolved among all the objects
+  char* name = symbolName(object, symbol);
+  long address = linkerState.nameAddresses[internName(name, strlen(name))];
+  if(address >= 0) return address;
+  if(ELF64_ST_BIND(symbol->st_info) == STB_WEAK) return 0;
+
+  symbolError("Undefined reference to '%s'.", name, object->file->filename);
+  return 0;
+}
+
+char* symbolName(LinkerObject* object, Elf64_Sym* symbol) {
+  if(symbol->st_name >= object->namesSize)
+    linkerError("Malformed object file.", object->file->filename);
+  return object->names + symbol->st_name;
+}
+
+void writeValue(char* at, long value, int size) {
+  for(int i = 0; i < size; i++) at[i] = value >> (8 * i);
+}
+
+void symbolError(char* fmt, char* name, char* fileName) {
+  char msg[strlen(fmt) + strlen(name)];
+  sprintf(msg, fmt, name);
+  linkerError(msg, fileName);
+}
+
+void linkerError(char* msg, char* fileName) {
+  if(cli.outputType <= OUT_DEFAULT) {
+    fprintf(stderr, "\nLink " ERROR_COLOR_START "ERROR" COLOR_END ": %s\n",
+      msg);
+    if(fileName) fprintf(stderr, "%s.\n", fileName);
+  }
+  failCompilation(PHASE_LINKER, msg, 0, 0);
+}
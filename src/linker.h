@@ -0,0 +1,64 @@
+/*
+ *
+ *
+ * Linker of the object files written with -c. It places their code one
+ * after another, and their global variables before it, as in the
+ * executables of a single source (see xgen.h), resolves the names that each
+ * one uses from the others, and fills in their relocations.
+ *
+ * Only the objects of the compiler and others as simple are supported:
+ * ELF64 relocatable files for x86-64 with code (.text) and global variables
+ * without initial values (.bss), and no other allocated sections.
+ *
+ */
+
+#ifndef LINKER_H
+#define LINKER_H
+
+#include <elf.h>
+#include "datast.h"
+
+// An object file being linked
+typedef struct stLinkerObject {
+  SourceFile* file;
+  Elf64_Shdr* sections;
+  int nSections;
+  long* sectionAddresses;  // where each section is loaded (-1: nowhere)
+  Elf64_Sym* symbols;
+  int nSymbols;
+  char* names;  // of the symbols
+  long namesSize;
+} LinkerObject;
+
+// State of the link in progress
+typedef struct stLinkerState {
+  LinkerObject* objects;
+  int nObjects;
+  long codeAddress;  // where the code of the executable is loaded
+  long codeSize;
+  long bssSize;
+  char* code;  // of the executable, with the relocations filled in
+  long* nameAddresses;  // of the global symbols, by name id (-1: undefined)
+  char* nameWeak;  // whether the definition of each name is weak
+} LinkerState;
+
+extern __thread LinkerState linkerState;
+
+/*
+ * Links object files into an executable. It stops the compilation in
+ * progress if an object cannot be linked (see failCompilation).
+ *
+ * objectNames: the names of the object files.
+ * nObjects: the number of object files.
+ * outputName: the name of the executable (NULL for the default one).
+ *
+ */
+void linkerStart(char** objectNames, int nObjects, char* outputName);
+
+/*
+ * Releases the object files and the memory of the last link.
+ *
+ */
+void releaseLinker();
+
+#endif
@@ -3,12 +3,15 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "cli.h"
-#include "lexer.h"
-#include "parser.h"
-#include "scoper.h"
-#include "codegen.h"
-#include "xgen.h"
+#include "source.h"
+#include "compiler.h"
+#include "batch.h"
+#include "server.h"
+#include "cache.h"
 
 /*
  * The main function should receive the source file (but it can be ommited
@@ -20,39 +23,88 @@ int main(int argc, char ** argv) {
   int filenameIdx = cli.sourceIdx;
   int outputIdx = cli.outputIdx;
 
-  FILE* sourcefile;
-  char* filename;
+  if(cli.cacheStats) return printCacheStats();
 
-  if(filenameIdx < 1) { // read from stdin
-    sourcefile = stdin;
-    filename = "<stdin>";
-  } else { // read specified file
-    sourcefile = fopen(argv[filenameIdx], "rt");
-
-    if(!sourcefile) {
+  if(cli.batchIdx >= 0) { // many sources, each one with its own output
+    Batch* batch = cli.batchIdx < argc ? loadBatch(argv[cli.batchIdx], &cli)
+      : NULL;
+    if(!batch) {
       if(cli.outputType <= OUT_DEFAULT)
-        fprintf(stderr, "ERROR: Invalid file name.\n");
+        fprintf(stderr, "ERROR: Invalid batch list file name.\n");
+      return 1;
+    }
 
+    int nFailed = compileBatch(batch, cli.jobs);
+    reportBatch(batch);
+    closeBatch(batch);
+    return nFailed > 0;
+  }
+
+  if(cli.server) return runServer(cli.jobs);
+
+  if(cli.link) { // the arguments that are not options are the objects
+    char** objectNames = (char**) malloc(sizeof(char*) * argc);
+    int nObjects = 0;
+    for(int i = 1; i < argc; i++) {
+      if(i != outputIdx && i != cli.batchIdx && argv[i][0] != '-')
+        objectNames[nObjects++] = argv[i];
+    }
+    if(nObjects == 0) {
+      if(cli.outputType <= OUT_DEFAULT)
+        fprintf(stderr, "ERROR: No object files to link.\n");
+      free(objectNames);
       return 1;
     }
 
-    filename = argv[filenameIdx];
+    CompilerContext ctx = {
+      .options = cli,
+      .outputName = outputIdx >= 0 ? argv[outputIdx] : NULL
+    };
+    int result = linkObjects(&ctx, objectNames, nObjects);
+    free(objectNames);
+    return result;
   }
 
-  lexerStart(sourcefile, filename);
-  parserStart(sourcefile, filename, lexerState.nTokens, lexerState.tokens);
+  SourceFile* source;
 
-  // Just generate the parser output for Graphviz
-  if(cli.outputType == OUT_GRAPHVIZ) return 0;
+  if(filenameIdx < 1) { // read from stdin
+    source = loadSourceFd(STDIN_FILENO, "<stdin>");
+  } else { // read specified file
+    source = loadSource(argv[filenameIdx]);
+  }
 
-  scopeCheckerStart(sourcefile, filename, parserState.ast);
-  codegenStart(sourcefile, filename, parserState.ast);
+  if(!source) {
+    if(cli.outputType <= OUT_DEFAULT)
+      fprintf(stderr, "ERROR: Invalid file name.\n");
 
-  char* outputName = NULL;
-  if(outputIdx >= 0) outputName = argv[outputIdx];
-  generateExec(filename, codegenState.code, outputName);
+    return 1;
+  }
 
-  fclose(sourcefile);
-  return 0;
-}
+  // with -c, the object file is named after the source by default
+  char* outputName = outputIdx >= 0 ? argv[outputIdx] : NULL;
+  char* objectName = NULL;
+  if(cli.object && !outputName && filenameIdx >= 1)
+    outputName = objectName = defaultOutputName(argv[filenameIdx], 1);
 
+  // the server prints nothing, so debugging output is only given here
+  if(cli.client && (cli.outputType == OUT_DEFAULT
+                    || cli.outputType == OUT_SILENT)) {
+    int result = runClient(&cli, source, filenameIdx < 1, outputName);
+    if(result >= 0) {
+      closeSource(source);
+      free(objectName);
+      return result;
+    }
+  }
+
+  CompilerContext ctx = {
+    .options = cli,
+    .source = source,
+    .outputName = outputName
+  };
+  int result = compile(&ctx);
+
+  closeSource(source);
+  free(objectName);
+  return result;
+}
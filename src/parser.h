@@ -9,191 +9,152 @@
 #include <stdio.h>
 #include "datast.h"
 
-// The parser is a LR(1) parser, and it uses a stack of subtrees that can
-// be reduced into larger subtrees when a production rule is matched. This
-// structure represents the stack.
+// Number of token types (TTExport is the last one)
+#define N_TOKEN_TYPES (TTExport + 1)
+
+// Kinds of values of the symbols on the stack of the parser
+typedef enum enParseValueKind {
+  PV_NONE,  // an absent optional symbol
+  PV_TOKEN,  // a token, not in the AST yet
+  PV_NODE,  // a node of the AST
+  PV_LIST  // a list of nodes (see ParserStack)
+} ParseValueKind;
+
+// Value of a symbol on the stack of the parser. Tokens only become terminal
+// nodes when a rule puts them in the AST.
+typedef struct stParseValue {
+  int kind;  // ParseValueKind
+  int index;  // node, token or start of a list
+  int count;  // number of nodes in a list
+} ParseValue;
+
+// Instructions of the code that builds the value of a rule when it is
+// reduced (see parseCode in parsetables.h). The code works on a stack of
+// operands, and leaves the value of the rule as the only operand.
+typedef enum enParseCode {
+  PC_END,  // end of the code
+  PC_VALUE,  // PC_VALUE i: pushes the value of the symbol i of the rule
+  PC_NONE,  // pushes an empty value
+  PC_NODE,  // PC_NODE type n: replaces n operands by a node of that type,
+            // which has them as children (lists are spliced, empty values
+            // are skipped)
+  PC_LIST  // PC_LIST n: replaces n operands by a list (only the first one
+           // can be a list, which is extended)
+} ParseCode;
+
+// A rule of the grammar
+typedef struct stParseRule {
+  short lhs;  // the non-terminal (column of the GOTO table)
+  short length;  // number of symbols
+  short nodes;  // maximum number of nodes created by the code
+  short code;  // start of the code in parseCode
+} ParseRule;
+
+// The stack of the LR parser: the states and the values of their symbols.
+// The nodes of the lists are kept apart, in the order of the values (lists
+// are always extended at the top). Tokens pulled from the lexer are kept
+// at their position in the stack, and are referred to by it.
 typedef struct stParserStack {
-  Node** nodes;
+  short* states;
+  ParseValue* values;
+  Token* tokens;
   int pointer;
   int maxSize;
+  int* items;  // nodes of the lists
+  int nItems;
+  int maxItems;
 } ParserStack;
 
 // Global state of the parser
 typedef struct stParserState {
-  FILE* file;
-  char* filename;
+  SourceFile* source;
   int nextToken;
   int nTokens;  // from lexerState
-  Token** tokens;  // from lexerState
-  int maxNodes;  // current size of the list of nodes
-  int nodeCount;  // number of nodes created so far
-  Node* ast;  // the final AST
+  Token* tokens;  // from lexerState (NULL when tokens are pulled one by one)
+  Token pending;  // when pulling tokens: the next token (TTEof at the end)
+  Node* ast;  // the root of the final AST
 } ParserState;
 
 // Global state of the parser
-extern ParserState parserState;
+extern __thread ParserState parserState;
 
 // The stack of subtrees of the LR parser
-extern ParserStack pStack;
-
-// The list of pointers to the nodes that comprise the trees
-extern Node** pNodes;
+extern __thread ParserStack pStack;
 
 /*
  * Starts the parser.
  *
- * file: pointer to the source file to process (file should be already
- *   open for reading/text mode). The file will be left open.
- * filename: name of the source file, used for messages.
+ * source: the source file being processed, used for messages.
  * nTokens: number of tokens processed by the lexer.
- * tokens: the array of tokens (pointers).
- *
- */
-void parserStart(FILE* file, char* filename, int nTokens, Token** tokens);
-
-/*
- * The parser is a LR(1) parser, and it uses a stack of subtrees that can
- * be reduced into larger subtrees when a production rule is matched. This
- * function initializes the structures that are used by the stack.
+ * tokens: the array of tokens.
  *
  */
-void initializeStack();
+void parserStart(SourceFile* source, int nTokens, Token* tokens);
 
 /*
- * The AST nodes are all stored in a dynamic list. This function allocates
- * memory for a new node, initializes it and manages the nodes list if
- * necessary.
+ * Starts the parser, pulling tokens from the lexer as they are needed
+ * instead of lexing the whole source first. Only the tokens of terminal
+ * nodes are kept, copied into the AST.
  *
- * type: the type of node (expression, statement, etc.).
- * returns: a pointer to the newly created node.
+ * source: the source file to be parsed, already loaded in memory.
  *
  */
-Node* newNode(NodeType type);
+void parserStartStream(SourceFile* source);
 
 /*
- * Helper function to facilitate node creation and addition to the stack.
- * It allocates memory for the child nodes and set the links between parent
- * and children.
- *
- * type: the type of node to be created.
- * nChildren: the number of children for the new node.
- * ...: a variable number of child nodes (the number must match nChildren).
- * returns: a pointer to the newly created node.
+ * Initializes the stack of the parser, with the initial state on it.
  *
  */
-Node* createAndPush(NodeType type, int nChildren, ...);
+void initializeStack();
 
 /*
- * Pushes a node onto the stack. This should be done either when a new token
- * is read and turned into a terminal node, or when a number of nodes on
- * the top of the stack match a production rule and are reduced into a new
- * node. This new node must be pushed into the stack.
- *
- * node: the node to be pushed.
+ * Doubles the size of the stack of the parser.
  *
  */
-void stackPush(Node* node);
+void growStack();
 
 /*
- * Pops n nodes from the top of the stack, and returns the last popped node.
- * When a number of nodes on the top of the stack match a production rule,
- * they must be popped and a new node (which possibly becomes parent of those)
- * must be pushed in their place.
+ * Adds a node after the nodes of the lists on the stack, that is, at the end
+ * of the last list.
  *
- * n: number of nodes to be popped.
- * returns: the last node popped.
+ * node: index of the node.
  *
  */
-Node* stackPop(int n);
+void listAdd(int node);
 
 /*
- * Allocates memory for the children of a node.
+ * Turns the value of a symbol into a node: tokens become new terminal
+ * nodes. There must be room for the new node (see astReserve).
  *
- * node: the parent node.
- * nChildren: the number of children that this node will have.
+ * value: the value (a token or a node).
+ * returns: the node.
  *
  */
-void allocChildren(Node* node, int nChildren);
+Node* valueNode(ParseValue* value);
 
 /*
  * Looks at the next token in queue of unprocessed tokens and returns it
  * (without removing it from the queue). This is the 1 in the LR(1) expression:
  * we are allowed to peek 1 token ahead to help us decide which rule to apply.
  *
- * returns: the next unprocessed token.
- *
- */
-Token lookAhead();
-
-/*
- * Gets a node at a specified offset from the top of the stack without
- * popping it.
- *
- * offset: 0 to get the node on the top of the stack, 1 for next, and so on...
- * returns: the node or NULL if the offset is not valid.
- *
- */
-Node* fromStackSafe(int offset);
-
-/*
- * Checks whether the node type is a type of statement (such as an if
- * statement, a while statement, a assignment statement, etc.).
- *
- * type: the node type to be checked.
- * returns: 1 if it is a type of statement, 0 otherwise.
- *
- */
-int isSubStatement(NodeType type);
-
-/*
- * Checks whether a token type is a assignment operator type (=, +=, -=, etc.).
- *
- * type: the token type to be checked.
- * returns: 1 if it is a assignment operator type, 0 otherwise.
- *
- */
-int isAssignmentOp(TokenType type);
-
-/*
- * Checks whether the node is a terminal node and that its token has the
- * specified type. If not, displays a syntax error and terminates the program.
- *
- * node: the node that will be checked.
- * type: the type that the token of this node must have.
- * msg: an error message to be displayed if the node's token does not have
- *   the correct type. This message will be preppended to a standard message
- *   saying that a type was expect but another found.
- *
- */
-void assertTokenEqual(Node* node, TokenType ttype, char* msg);
-
-/*
- * Checks whether the node has the specified type, if not displays a
- * syntax error and terminates the program.
- *
- * node: the node that will be checked.
- * type: the type that this node must have.
- * msg: an error message to be displayed if the node does not have the correct
- *   type. This message will be preppended to a standard message saying that
- *   a type was expect but another found.
+ * returns: the next unprocessed token (TTEof at the end).
  *
  */
-void assertEqual(Node* node, NodeType type, char* msg);
+Token* lookAhead();
 
 /*
- * Outputs a syntax error message and terminates the program.
+ * Outputs a syntax error message for an unexpected token, saying which
+ * tokens were expected if there are few of them, and terminates the
+ * program.
  *
- * format: a format string for the error message containing the error message
- *   and one %s that will be replaced by the node/token name.
- * node: the node that caused the error.
- * leafNode: a leaf from the error-causing node, which contains a token that
- * will be used to get the line and column number.
+ * token: the unexpected token.
+ * state: the state of the parser.
  *
  */
-void parsErrorHelper(char* format, Node* node, Node* leafNode);
+void syntaxError(Token* token, int state);
 
 /*
- * Outputs a syntax error message and terminates the program.
+ * Outputs a syntax error message and stops the compilation.
  *
  * msg: error message.
  * lnum: line number where the error is found.
@@ -202,12 +163,4 @@ void parsErrorHelper(char* format, Node* node, Node* leafNode);
  */
 void parsError(char* msg, int lnum, int chnum);
 
-/*
- * Debug function. Prints the current stack.
- *
- *
- */
-void printStack();
-
 #endif
-
@@ -2,234 +2,138 @@
  *
  * Helper functions for the parser. Mostly data structures.
  *
- * The parser will use a stack of pointers to subtrees. The nodes of these
- * subtress will be in a list.
+ * The parser uses a stack of states, along with the values of their symbols
+ * (tokens, or subtrees referred to by the index of their roots in the node
+ * array of the AST).
  *
  */
 
 #include <stdlib.h>
 #include <string.h>
-#include <stdarg.h>
 #include "cli.h"
 #include "util.h"
 #include "parser.h"
+#include "parsetables.h"
 #include "ast.h"
+#include "arena.h"
+#include "compiler.h"
 
-// Initial size allocated for the stack (will be whenever necessary)
+// Initial size allocated for the stack (will be doubled whenever necessary)
 #define INITIAL_STACK_SIZE 100
 
-// Initial size allocated for the dynamic list of nodes (doubled when needed)
-#define INITIAL_MAX_NODES 250
+// Initial size allocated for the nodes of the lists on the stack
+#define INITIAL_LIST_SIZE 100
+
+// Maximum number of expected tokens listed in syntax error messages
+#define MAX_EXPECTED 4
+
+// Maximum number of characters of the unexpected token in error messages
+#define MAX_ERROR_TOKEN 32
 
 void initializeStack() {
   pStack = (ParserStack) {
-    .pointer = -1,
-    .nodes = NULL,
-    .maxSize = INITIAL_STACK_SIZE
+    .pointer = 0,
+    .maxSize = INITIAL_STACK_SIZE,
+    .nItems = 0,
+    .maxItems = INITIAL_LIST_SIZE
   };
 
-  parserState.nodeCount = 0;
-  parserState.maxNodes = INITIAL_MAX_NODES;
-  pNodes = (Node**) malloc(sizeof(Node*) * parserState.maxNodes);
-  pStack.nodes = (Node**) malloc(INITIAL_STACK_SIZE * sizeof(Node*));
+  pStack.states = (short*) arenaAlloc(&compArena,
+    INITIAL_STACK_SIZE * sizeof(short));
+  pStack.values = (ParseValue*) arenaAlloc(&compArena,
+    INITIAL_STACK_SIZE * sizeof(ParseValue));
+  pStack.tokens = (Token*) arenaAlloc(&compArena,
+    INITIAL_STACK_SIZE * sizeof(Token));
+  pStack.items = (int*) arenaAlloc(&compArena,
+    INITIAL_LIST_SIZE * sizeof(int));
+
+  pStack.states[0] = 0;
+  pStack.values[0].kind = PV_NONE;
 }
 
-Node* createAndPush(NodeType type, int nChildren, ...) {
-  Node* nodePtr = newNode(type);
-  if(nChildren > 0) allocChildren(nodePtr, nChildren);
-  stackPush(nodePtr);
-
-  va_list nodePtrArgs;
-  va_start(nodePtrArgs, nChildren);
-
-  for(int i = 0; i < nChildren; i++) {
-    nodePtr->children[i] = va_arg(nodePtrArgs, Node*);
-    nodePtr->children[i]->parent = nodePtr;
-  }
-  va_end(nodePtrArgs);
-  return nodePtr;
+void growStack() {
+  pStack.states = (short*) arenaRealloc(&compArena, pStack.states,
+    sizeof(short) * pStack.maxSize, sizeof(short) * pStack.maxSize * 2);
+  pStack.values = (ParseValue*) arenaRealloc(&compArena, pStack.values,
+    sizeof(ParseValue) * pStack.maxSize,
+    sizeof(ParseValue) * pStack.maxSize * 2);
+  pStack.tokens = (Token*) arenaRealloc(&compArena, pStack.tokens,
+    sizeof(Token) * pStack.maxSize, sizeof(Token) * pStack.maxSize * 2);
+  pStack.maxSize *= 2;
 }
 
-Node* newNode(NodeType type) {
-  Node* node = (Node*) malloc(sizeof(Node));
-  node->type = type;
-  node->token = NULL;
-  node->children = NULL;
-  node->parent = NULL;
-  node->symTable = NULL;
-  node->cgData = NULL;
-
-  if(parserState.nodeCount >= parserState.maxNodes) {
-    pNodes = (Node**) realloc(pNodes, sizeof(Node*) * parserState.maxNodes * 2);
-    parserState.maxNodes *= 2;
+void listAdd(int node) {
+  if(pStack.nItems == pStack.maxItems) {
+    pStack.items = (int*) arenaRealloc(&compArena, pStack.items,
+      sizeof(int) * pStack.maxItems, sizeof(int) * pStack.maxItems * 2);
+    pStack.maxItems *= 2;
   }
-
-  pNodes[parserState.nodeCount] = node;
-  pNodes[parserState.nodeCount]->id = parserState.nodeCount;
-  parserState.nodeCount++;
-  return pNodes[parserState.nodeCount - 1];
+  pStack.items[pStack.nItems++] = node;
 }
 
-void stackPush(Node* node) {
-  if(pStack.pointer >= pStack.maxSize - 1) { // reallocate space for stack
-    pStack.nodes = (Node**) realloc(
-      pStack.nodes, sizeof(Node*) * pStack.maxSize * 2);
+Node* valueNode(ParseValue* value) {
+  if(value->kind == PV_NODE) return &compAst.nodes[value->index];
 
-    pStack.maxSize *= 2;
-  }
-  pStack.pointer++;
-  pStack.nodes[pStack.pointer] = node;
-}
-
-Node* stackPop(int n) {
-  Node* node = NULL;
-  if(pStack.pointer - (n - 1) >= 0)
-    node = pStack.nodes[pStack.pointer - (n - 1)];
-
-  pStack.pointer -= n;
+  Node* node = astAddNode(NTTerminal);
+  if(parserState.tokens) node->token = value->index;
+  else node->token = astAddToken(&pStack.tokens[value->index]);
   return node;
 }
 
-Token lookAhead() {
-  if(parserState.nextToken < parserState.nTokens)
-    return *parserState.tokens[parserState.nextToken];
+Token* lookAhead() {
+  if(parserState.tokens && parserState.nextToken < parserState.nTokens)
+    return &parserState.tokens[parserState.nextToken];
 
-  // Ideally this function shouldn't be called if there are no tokens left.
-  Token token = { NULL, 0, TTEof, 0, 0 };
-  return token;
+  // the next token pulled from the lexer, or the end of the file
+  return &parserState.pending;
 }
 
-void allocChildren(Node* node, int nChildren) {
-  node->children = (Node**) malloc(sizeof(Node*) * nChildren);
-  node->nChildren = nChildren;
+void syntaxError(Token* token, int state) {
+  char msg[2 * MAX_ERROR_TOKEN + MAX_EXPECTED * (MAX_NODE_NAME + 8)];
 
-  for(int i = 0; i < nChildren; i++) node->children[i] = NULL;
-}
+  if(token->type == TTEof) {
+    sprintf(msg, "Unexpected end of file.");
+  } else {
+    int size = token->nameSize;
+    if(size > MAX_ERROR_TOKEN) size = MAX_ERROR_TOKEN;
+    sprintf(msg, "Unexpected token '%.*s'.", size,
+      tokenText(parserState.source, token));
+  }
 
-Node* fromStackSafe(int offset) {
-  if(pStack.pointer >= offset) return pStack.nodes[pStack.pointer - offset];
-  return NULL;
-}
+  // the tokens that would have been accepted, if there are few of them
+  int expected[MAX_EXPECTED + 1];
+  int nExpected = 0;
 
-int isSubStatement(NodeType type) {
-  if(type == NTBreakSt || type == NTNextSt || type == NTIfSt ||
-     type == NTLoopSt || type == NTWhileSt || type == NTNoop ||
-     type == NTMatchSt || type == NTAssignment || type == NTCallSt ||
-     type == NTForSt || type == NTReturnSt)
-    return 1;
-  return 0;
-}
+  for(int col = 1; col < PARSE_COLUMNS && nExpected <= MAX_EXPECTED; col++)
+    if(parseAction[state][col] != 0) expected[nExpected++] = col;
 
-int isAssignmentOp(TokenType type) {
-  if(type == TTAssign || type == TTAdd || type == TTSub) return 1;
-  return 0;
-}
+  if(nExpected <= MAX_EXPECTED) {
+    for(int i = 0; i < nExpected; i++) {
+      strcat(msg, i == 0 ? " Expected " :
+        (i == nExpected - 1 ? " or " : ", "));
 
-void assertTokenEqual(Node* node, TokenType ttype, char* msg) {
-  if(node->type != NTTerminal) {
-    char* dfMsg = " Expected symbol, found %s.";
-    char* finalMsg = (char*) malloc(
-      sizeof(char) * (strlen(msg) + strlen(dfMsg) + MAX_NODE_NAME));
-    char* format = (char*) malloc(
-      sizeof(char) * (strlen(msg) + strlen(dfMsg)));
-
-    strcpy(format, msg);
-    strcat(format, dfMsg);
-    strReplaceNodeName(finalMsg, format, node->type);
-
-    Node* leafNode = astFirstLeaf(node);
-    int lnum = leafNode->token->lnum;
-    int chnum = leafNode->token->chnum;
-    parsError(finalMsg, lnum, chnum);
-  } else if(!(node->token)) {
-    Node* problematic = astFirstLeaf(node);
-
-    if(cli.outputType <= OUT_DEFAULT) {
-      fprintf(stderr, "Compiler bug: invalid terminal node.\n");
+      char name[MAX_NODE_NAME];
+      strReplaceTokenName(name, "%s", parseColumnToken[expected[i]]);
+      strcat(msg, name);
     }
-    exit(1);
-  } else if(node->token->type != ttype) {
-    char* dfMsg = " Expected %s, found %s.";
-    char* finalMsg = (char*) malloc(
-      sizeof(char) * (strlen(msg) + strlen(dfMsg) + 2 * MAX_NODE_NAME));
-    char* format = (char*) malloc(
-      sizeof(char) * (strlen(msg) + strlen(dfMsg)));
-
-    strcpy(format, msg);
-    strcat(format, dfMsg);
-
-    char* fmtName = "%s";
-    char strWrong[MAX_NODE_NAME];
-    char strExpect[MAX_NODE_NAME];
-    strReplaceTokenName(strWrong, fmtName, node->token->type);
-    strReplaceTokenName(strExpect, fmtName, ttype);
-    sprintf(finalMsg, format, strExpect, strWrong);
-
-    Node* leafNode = astFirstLeaf(node);
-    int lnum = leafNode->token->lnum;
-    int chnum = leafNode->token->chnum;
-    parsError(finalMsg, lnum, chnum);
-  }
-}
-
-void assertEqual(Node* node, NodeType type, char* msg) {
-  if(node->type != type) {
-    char* dfMsg = " Expected %s, found %s.";
-    char* finalMsg = (char*) malloc(
-      sizeof(char) * (strlen(msg) + strlen(dfMsg) + 2 * MAX_NODE_NAME));
-    char* format = (char*) malloc(
-      sizeof(char) * (strlen(msg) + strlen(dfMsg)));
-
-    strcpy(format, msg);
-    strcat(format, dfMsg);
-
-    char* fmtName = "%s";
-    char strWrong[MAX_NODE_NAME];
-    char strExpect[MAX_NODE_NAME];
-    strReplaceNodeAndTokenName(strWrong, fmtName, node);
-    strReplaceNodeName(strExpect, fmtName, type);
-    sprintf(finalMsg, format, strExpect, strWrong);
-
-    Node* leafNode = astFirstLeaf(node);
-    int lnum = leafNode->token->lnum;
-    int chnum = leafNode->token->chnum;
-    parsError(finalMsg, lnum, chnum);
+    strcat(msg, ".");
   }
-}
 
-void parsErrorHelper(char* format, Node* node, Node* leafNode) {
-  int len = strlen(format) + MAX_NODE_NAME;
-  char str[len];
-  strReplaceNodeAndTokenName(str, format, node);
-  parsError(str, leafNode->token->lnum, leafNode->token->chnum);
+  parsError(msg, token->lnum, token->chnum);
 }
 
 void parsError(char* msg, int lnum, int chnum) {
-  if(cli.outputType > OUT_DEFAULT) exit(1);
+  if(cli.outputType > OUT_DEFAULT)
+    failCompilation(PHASE_PARSER, msg, lnum, chnum);
 
   if(lnum > 0) {
     fprintf(stderr, "\nSyntax " ERROR_COLOR_START "ERROR" COLOR_END ": %s\n",
       msg);
-    printCharInFile(parserState.file, parserState.filename, lnum, chnum);
+    printCharInFile(parserState.source, lnum, chnum);
   } else {
     fprintf(stderr, "\nSyntax " ERROR_COLOR_START "ERROR" COLOR_END
-      ": %s\n%s.\n", msg, parserState.filename);
-  }
-  exit(1);
-}
-
-void printStack() {
-  if(cli.outputType > OUT_VERBOSE) return;
-
-  printf("Stack: ");
-  for(int i = 0; i <= pStack.pointer; i++) {
-    Node* node = pStack.nodes[i];
-
-    if(node->type == NTTerminal)
-      printf(" %s", node->token->name);
-    else
-      printf(" %d", node->type);
+      ": %s\n%s.\n", msg, parserState.source->filename);
   }
-  printf("\n");
+  failCompilation(PHASE_PARSER, msg, lnum, chnum);
 }
 
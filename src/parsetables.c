@@ -0,0 +1,1104 @@
+/*
+ *
+ *
+ * Parse tables of the LALR(1) parser. Generated by aux/lrgen from
+ * docs/grammar.txt: do not edit, change the grammar instead.
+ *
+ */
+
+#include "parsetables.h"
+
+const unsigned char parseColumn[N_TOKEN_TYPES] = {
+  [TTEof] = 1,
+  [TTId] = 2,
+  [TTLitInt] = 3,
+  [TTLitFloat] = 4,
+  [TTLitString] = 5,
+  [TTTrue] = 6,
+  [TTFalse] = 7,
+  [TTLPar] = 8,
+  [TTRPar] = 9,
+  [TTLBrace] = 10,
+  [TTRBrace] = 11,
+  [TTSemi] = 12,
+  [TTColon] = 13,
+  [TTComma] = 14,
+  [TTArrow] = 15,
+  [TTDiv] = 16,
+  [TTPlus] = 17,
+  [TTMinus] = 18,
+  [TTMod] = 19,
+  [TTMult] = 20,
+  [TTGreater] = 21,
+  [TTGEq] = 22,
+  [TTLess] = 23,
+  [TTLEq] = 24,
+  [TTEq] = 25,
+  [TTAssign] = 26,
+  [TTIncr] = 27,
+  [TTDecr] = 28,
+  [TTAdd] = 29,
+  [TTSub] = 30,
+  [TTIf] = 31,
+  [TTElse] = 32,
+  [TTFor] = 33,
+  [TTFunc] = 34,
+  [TTWhile] = 35,
+  [TTNext] = 36,
+  [TTBreak] = 37,
+  [TTInt] = 38,
+  [TTString] = 39,
+  [TTBool] = 40,
+  [TTFloat] = 41,
+  [TTAnd] = 42,
+  [TTOr] = 43,
+  [TTNot] = 44,
+  [TTReturn] = 45,
+  [TTLoop] = 46,
+  [TTExtern] = 47,
+  [TTExport] = 48,
+};
+
+const short parseColumnToken[PARSE_COLUMNS] = {
+  TTUnknown, TTEof, TTId, TTLitInt, TTLitFloat, TTLitString,
+  TTTrue, TTFalse, TTLPar, TTRPar, TTLBrace, TTRBrace,
+  TTSemi, TTColon, TTComma, TTArrow, TTDiv, TTPlus,
+  TTMinus, TTMod, TTMult, TTGreater, TTGEq, TTLess,
+  TTLEq, TTEq, TTAssign, TTIncr, TTDecr, TTAdd,
+  TTSub, TTIf, TTElse, TTFor, TTFunc, TTWhile,
+  TTNext, TTBreak, TTInt, TTString, TTBool, TTFloat,
+  TTAnd, TTOr, TTNot, TTReturn, TTLoop, TTExtern,
+  TTExport
+};
+
+const short parseAction[PARSE_STATES][PARSE_COLUMNS] = {
+  {0, -2, -2, 0, 0, 0, 0, 0, 0, 0, -2, 0, -2, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -2,
+   0, -2, -2, -2, -2, -2, -2, -2, -2, -2, 0, 0, 0, -2, -2, -2,
+   -2},
+  {0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -4, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 0, 0, 16, 17, 18,
+   19},
+  {0, 0, -72, -72, -72, -72, -72, -72, -72, 0, 0, 0, -72, 0, -72, -72,
+   0, 0, -72, 0, 0, 0, 0, 0, 0, 0, -72, -72, -72, -72, -72, 0,
+   0, 0, 0, 0, 0, 0, -72, -72, -72, -72, 0, 0, -72, 0, 0, 0,
+   0},
+  {0, 0, -9, 0, 0, 0, 0, 0, 0, 0, -9, -9, -9, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -9,
+   0, -9, 0, -9, -9, -9, -9, -9, -9, -9, 0, 0, 0, -9, -9, 0,
+   0},
+  {0, -12, -12, 0, 0, 0, 0, 0, 0, 0, -12, -12, -12, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -12,
+   -12, -12, -12, -12, -12, -12, -12, -12, -12, -12, 0, 0, 0, -12, -12, -12,
+   -12},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 44, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 45, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, -68, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, -69, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, -70, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 46, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 0, 0, 0, 0, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 49, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 50, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -3, -3, 0, 0, 0, 0, 0, 0, 0, -3, 0, -3, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -3,
+   0, -3, -3, -3, -3, -3, -3, -3, -3, -3, 0, 0, 0, -3, -3, -3,
+   -3},
+  {0, -5, -5, 0, 0, 0, 0, 0, 0, 0, -5, 0, -5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -5,
+   0, -5, -5, -5, -5, -5, -5, -5, -5, -5, 0, 0, 0, -5, -5, -5,
+   -5},
+  {0, -6, -6, 0, 0, 0, 0, 0, 0, 0, -6, 0, -6, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -6,
+   0, -6, -6, -6, -6, -6, -6, -6, -6, -6, 0, 0, 0, -6, -6, -6,
+   -6},
+  {0, -8, -8, 0, 0, 0, 0, 0, 0, 0, -8, 0, -8, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -8,
+   0, -8, -8, -8, -8, -8, -8, -8, -8, -8, 0, 0, 0, -8, -8, -8,
+   -8},
+  {0, -7, -7, 0, 0, 0, 0, 0, 0, 0, -7, 0, -7, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -7,
+   0, -7, -7, -7, -7, -7, -7, -7, -7, -7, 0, 0, 0, -7, -7, -7,
+   -7},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 51, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 53, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 54, 55, 56, 57, 58, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 61, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 12, 13, 14, 15, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, -72, -44, 0, 0, -44, -44, -44, 0,
+   -44, -44, -44, -44, -44, -44, -44, -44, -44, -44, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -44, -44, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -39, 0, 0, -39, -39, -39, 0,
+   -39, -39, -39, -39, -39, -39, -39, -39, -39, -39, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -39, -39, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -40, 0, 0, -40, -40, -40, 0,
+   -40, -40, -40, -40, -40, -40, -40, -40, -40, -40, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -40, -40, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -41, 0, 0, -41, -41, -41, 0,
+   -41, -41, -41, -41, -41, -41, -41, -41, -41, -41, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -41, -41, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -42, 0, 0, -42, -42, -42, 0,
+   -42, -42, -42, -42, -42, -42, -42, -42, -42, -42, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -42, -42, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -43, 0, 0, -43, -43, -43, 0,
+   -43, -43, -43, -43, -43, -43, -43, -43, -43, -43, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -43, -43, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 80, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 81, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 82, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -62,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 87, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, -25, -25, 0, 0, 0, 0, 0, 0, 0, -25, -25, -25, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -25,
+   -25, -25, -25, -25, -25, -25, -25, -25, -25, -25, 0, 0, 0, -25, -25, -25,
+   -25},
+  {0, -24, -24, 0, 0, 0, 0, 0, 0, 0, -24, -24, -24, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -24,
+   -24, -24, -24, -24, -24, -24, -24, -24, -24, -24, 0, 0, 0, -24, -24, -24,
+   -24},
+  {0, -19, -19, 0, 0, 0, 0, 0, 0, 0, -19, -19, -19, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -19,
+   -19, -19, -19, -19, -19, -19, -19, -19, -19, -19, 0, 0, 0, -19, -19, -19,
+   -19},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 88, 0, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, -21, -21, 0, 0, 0, 0, 0, 0, 0, -21, -21, -21, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -21,
+   -21, -21, -21, -21, -21, -21, -21, -21, -21, -21, 0, 0, 0, -21, -21, -21,
+   -21},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -13, -13, 0, 0, 0, 0, 0, 0, 0, -13, -13, -13, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -13,
+   -13, -13, -13, -13, -13, -13, -13, -13, -13, -13, 0, 0, 0, -13, -13, -13,
+   -13},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 91, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 92, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 93, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -37, -37, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -38, -38, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -66, 0, 0, -66, 0, -66, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 99, 0, 100, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -11, -11, 0, 0, 0, 0, 0, 0, 0, -11, -11, -11, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -11,
+   -11, -11, -11, -11, -11, -11, -11, -11, -11, -11, 0, 0, 0, -11, -11, -11,
+   -11},
+  {0, 0, -26, 0, 0, 0, 0, 0, 0, 0, -26, -26, -26, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -26,
+   0, -26, 0, -26, -26, -26, -26, -26, -26, -26, 0, 0, 0, -26, -26, 0,
+   0},
+  {0, 0, -10, 0, 0, 0, 0, 0, 0, 0, -10, -10, -10, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -10,
+   0, -10, 0, -10, -10, -10, -10, -10, -10, -10, 0, 0, 0, -10, -10, 0,
+   0},
+  {0, 0, -27, 0, 0, 0, 0, 0, 0, 0, -27, -27, -27, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -27,
+   0, -27, 0, -27, -27, -27, -27, -27, -27, -27, 0, 0, 0, -27, -27, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -48, 0, 0, -48, -48, -48, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -49, 0, 0, -49, -49, -49, 0,
+   -49, -49, -49, -49, -49, -49, -49, -49, -49, -49, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -49, -49, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 101, 0, 0, 0, 0, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 0, 0, 0, 0, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 115, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 118, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 119,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -63, 0, 120, -63,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 0, 0, 0, 0, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, -20, -20, 0, 0, 0, 0, 0, 0, 0, -20, -20, -20, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -20,
+   -20, -20, -20, -20, -20, -20, -20, -20, -20, -20, 0, 0, 0, -20, -20, -20,
+   -20},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -62, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -62,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -31, -31, 0, 0, 0, 0, 0, 0, 0, -31, -31, -31, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -31,
+   0, -31, -31, -31, -31, -31, -31, -31, -31, -31, 0, 0, 0, -31, -31, -31,
+   -31},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 126, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 101, 0, 0, 0, 0, -66, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 127, 0, 0, 0, 0, 100, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -34, -34, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -35, -35, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -36, -36, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, -14, -14, 0, 0, 0, 0, 0, 0, 0, -14, -14, -14, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -14,
+   -14, -14, -14, -14, -14, -14, -14, -14, -14, -14, 0, 0, 0, -14, -14, -14,
+   -14},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -47, 0, 0, -47, -47, -47, 0,
+   -47, -47, -47, -47, -47, -47, -47, -47, -47, -47, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -47, -47, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -50, 0, 0, -50, -50, -50, 0,
+   79, 75, 76, 77, 78, -50, -50, -50, -50, -50, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -51, 0, 0, -51, -51, -51, 0,
+   79, 75, 76, 77, 78, -51, -51, -51, -51, -51, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -52, 0, 0, -52, -52, -52, 0,
+   79, 75, 76, 77, 78, -52, -52, -52, -52, -52, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -53, 0, 0, -53, -53, -53, 0,
+   79, 75, 76, 77, 78, -53, -53, -53, -53, -53, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -54, 0, 0, -54, -54, -54, 0,
+   79, 75, 76, 77, 78, -54, -54, -54, -54, -54, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -55, 0, 0, -55, -55, -55, 0,
+   79, 75, 76, 77, 78, -55, -55, -55, -55, -55, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -55, -55, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -56, 0, 0, -56, -56, -56, 0,
+   79, 75, 76, 77, 78, -56, -56, -56, -56, -56, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -56, -56, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -57, 0, 0, -57, -57, -57, 0,
+   79, -57, -57, -57, 78, -57, -57, -57, -57, -57, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -57, -57, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -58, 0, 0, -58, -58, -58, 0,
+   79, -58, -58, -58, 78, -58, -58, -58, -58, -58, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -58, -58, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -59, 0, 0, -59, -59, -59, 0,
+   79, -59, -59, -59, 78, -59, -59, -59, -59, -59, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -59, -59, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -60, 0, 0, -60, -60, -60, 0,
+   -60, -60, -60, -60, -60, -60, -60, -60, -60, -60, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -60, -60, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -61, 0, 0, -61, -61, -61, 0,
+   -61, -61, -61, -61, -61, -61, -61, -61, -61, -61, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -61, -61, 0, 0, 0, 0,
+   0},
+  {0, -17, -17, 0, 0, 0, 0, 0, 0, 0, -17, -17, -17, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -17,
+   129, -17, -17, -17, -17, -17, -17, -17, -17, -17, 0, 0, 0, -17, -17, -17,
+   -17},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -45, 0, 0, -45, -45, -45, 0,
+   -45, -45, -45, -45, -45, -45, -45, -45, -45, -45, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -45, -45, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 130, 0, 0, 0, 0, 100, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 131, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 31, 32, 33, 34, 35, 36, 37, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 29, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 0, 0, 0, 0, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -64, 0, -64, -64,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -22, -22, 0, 0, 0, 0, 0, 0, 0, -22, -22, -22, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -22,
+   -22, -22, -22, -22, -22, -22, -22, -22, -22, -22, 0, 0, 0, -22, -22, -22,
+   -22},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 135, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 136,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 137, 0, 0, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, -15, -15, 0, 0, 0, 0, 0, 0, 0, -15, -15, -15, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -15,
+   -15, -15, -15, -15, -15, -15, -15, -15, -15, -15, 0, 0, 0, -15, -15, -15,
+   -15},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 138, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -67, 0, 0, -67, 0, -67, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 0, 0, 0, 0, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, -46, 0, 0, -46, -46, -46, 0,
+   -46, -46, -46, -46, -46, -46, -46, -46, -46, -46, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -46, -46, 0, 0, 0, 0,
+   0},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -33, 0,
+   79, 75, 76, 77, 78, 71, 72, 69, 70, 68, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 73, 74, 0, 0, 0, 0,
+   0},
+  {0, -28, -28, 0, 0, 0, 0, 0, 0, 0, -28, 0, -28, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -28,
+   0, -28, -28, -28, -28, -28, -28, -28, -28, -28, 0, 0, 0, -28, -28, -28,
+   -28},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -30, -30, 0, 0, 0, 0, 0, 0, 0, -30, 0, -30, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -30,
+   0, -30, -30, -30, -30, -30, -30, -30, -30, -30, 0, 0, 0, -30, -30, -30,
+   -30},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 0, 0, 0, 0, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, -32, -32, 0, 0, 0, 0, 0, 0, 0, -32, -32, -32, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -32,
+   0, -32, -32, -32, -32, -32, -32, -32, -32, -32, 0, 0, 0, -32, -32, -32,
+   -32},
+  {0, -16, -16, 0, 0, 0, 0, 0, 0, 0, -16, -16, -16, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -16,
+   -16, -16, -16, -16, -16, -16, -16, -16, -16, -16, 0, 0, 0, -16, -16, -16,
+   -16},
+  {0, -18, -18, 0, 0, 0, 0, 0, 0, 0, -18, -18, -18, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -18,
+   -18, -18, -18, -18, -18, -18, -18, -18, -18, -18, 0, 0, 0, -18, -18, -18,
+   -18},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 144, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 54, 55, 56, 57, 58, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -65, 0, -65, -65,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0},
+  {0, -29, -29, 0, 0, 0, 0, 0, 0, 0, -29, 0, -29, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -29,
+   0, -29, -29, -29, -29, -29, -29, -29, -29, -29, 0, 0, 0, -29, -29, -29,
+   -29},
+  {0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 4, 0, 5, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6,
+   0, 7, 0, 9, 10, 11, 0, 0, 0, 0, 0, 0, 0, 16, 17, 0,
+   0},
+  {0, -23, -23, 0, 0, 0, 0, 0, 0, 0, -23, -23, -23, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -23,
+   -23, -23, -23, -23, -23, -23, -23, -23, -23, -23, 0, 0, 0, -23, -23, -23,
+   -23}
+};
+
+const short parseGoto[PARSE_STATES][PARSE_NONTERMINALS] = {
+  {0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   2, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 20, 21, 0, 22, 23, 24, 0, 25, 0, 0, 0, 0, 26, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 28},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 38, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 40, 0, 0, 0, 0, 0, 41, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 42,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 43, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 47, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 48, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 52,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 59, 0, 0, 60, 0, 39,
+   0, 0},
+  {0, 0, 0, 62, 63, 0, 0, 64, 0, 25, 0, 0, 0, 0, 26, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 65, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 66, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 67, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 83,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 84, 85, 0, 86, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 89,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 90,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 94, 0, 0, 95, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 96, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 97, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 98, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 102, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 103, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 104, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 105, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 106, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 107, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 108, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 109, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 110, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 111, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 112, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 113, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 114, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 59, 0, 0, 116, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 117, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 121,
+   0, 0},
+  {0, 0, 0, 122, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 123, 85, 0, 86, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 124, 85, 0, 86, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 125, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 128, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 132, 0, 0, 0, 0, 39,
+   0, 0},
+  {0, 0, 0, 133, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 134, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 139, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 140, 0, 0, 0, 0, 0, 141,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 142,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 143, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0},
+  {0, 0, 0, 145, 0, 0, 0, 0, 0, 25, 0, 0, 0, 0, 0, 27,
+   0, 0},
+  {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0}
+};
+
+const ParseRule parseRules[PARSE_RULES] = {
+  { 0, 1, 0, 0 },  //  $accept := PROGRAM   (line 29)
+  { 16, 0, 0, 3 },  //  PROGRAM_PART* :=   (line 29)
+  { 16, 2, 0, 6 },  //  PROGRAM_PART* := PROGRAM_PART* PROGRAM_PART   (line 29)
+  { 1, 1, 1, 13 },  //  PROGRAM := PROGRAM_PART*   (line 29)
+  { 2, 1, 1, 19 },  //  PROGRAM_PART := STATEMENT   (line 31)
+  { 2, 1, 1, 25 },  //  PROGRAM_PART := FUNCTION   (line 32)
+  { 2, 1, 1, 31 },  //  PROGRAM_PART := DECLARATION   (line 33)
+  { 2, 1, 1, 37 },  //  PROGRAM_PART := EXTERN_FUNCTION   (line 34)
+  { 17, 0, 0, 43 },  //  BLOCK_PART* :=   (line 36)
+  { 17, 2, 0, 46 },  //  BLOCK_PART* := BLOCK_PART* BLOCK_PART   (line 36)
+  { 3, 3, 1, 53 },  //  STATEMENT := { BLOCK_PART* }   (line 36)
+  { 3, 1, 3, 59 },  //  STATEMENT := ;   (line 37)
+  { 3, 2, 1, 68 },  //  STATEMENT := ASSIGNMENT ;   (line 38)
+  { 3, 3, 2, 74 },  //  STATEMENT := IDENTIFIER CALL_PARAMS ;   (line 39)
+  { 3, 4, 2, 85 },  //  STATEMENT := IDENTIFIER ( ) ;   (line 40)
+  { 3, 5, 2, 95 },  //  STATEMENT := IDENTIFIER ( CALL_PARAMS ) ;   (line 40)
+  { 3, 4, 2, 106 },  //  STATEMENT := if EXPR : STATEMENT   (line 41)
+  { 3, 6, 2, 118 },  //  STATEMENT := if EXPR : STATEMENT else STATEMENT   (line 41)
+  { 3, 2, 2, 131 },  //  STATEMENT := return ;   (line 43)
+  { 3, 3, 2, 139 },  //  STATEMENT := return EXPR ;   (line 43)
+  { 3, 2, 2, 148 },  //  STATEMENT := loop STATEMENT   (line 44)
+  { 3, 4, 2, 157 },  //  STATEMENT := while EXPR : STATEMENT   (line 45)
+  { 3, 8, 3, 168 },  //  STATEMENT := for FOR_DECLARATION , EXPR , ASSIGNMENT : STATEMENT   (line 46)
+  { 3, 2, 4, 186 },  //  STATEMENT := break ;   (line 48)
+  { 3, 2, 4, 197 },  //  STATEMENT := next ;   (line 49)
+  { 4, 1, 0, 208 },  //  BLOCK_PART := STATEMENT   (line 51)
+  { 4, 1, 1, 211 },  //  BLOCK_PART := DECLARATION   (line 52)
+  { 5, 5, 1, 217 },  //  FUNCTION := fn IDENTIFIER PARAMS => STATEMENT   (line 56)
+  { 5, 6, 2, 227 },  //  FUNCTION := export fn IDENTIFIER PARAMS => STATEMENT   (line 58)
+  { 6, 5, 1, 239 },  //  EXTERN_FUNCTION := extern fn IDENTIFIER PARAMS ;   (line 61)
+  { 7, 3, 1, 247 },  //  DECLARATION := TYPE IDENTIFIER ;   (line 64)
+  { 7, 5, 1, 256 },  //  DECLARATION := TYPE IDENTIFIER = EXPR ;   (line 64)
+  { 8, 4, 1, 266 },  //  FOR_DECLARATION := TYPE IDENTIFIER = EXPR   (line 66)
+  { 9, 3, 2, 276 },  //  ASSIGNMENT := IDENTIFIER = EXPR   (line 68)
+  { 9, 3, 2, 286 },  //  ASSIGNMENT := IDENTIFIER += EXPR   (line 69)
+  { 9, 3, 2, 296 },  //  ASSIGNMENT := IDENTIFIER -= EXPR   (line 70)
+  { 9, 2, 2, 306 },  //  ASSIGNMENT := IDENTIFIER ++   (line 71)
+  { 9, 2, 2, 314 },  //  ASSIGNMENT := IDENTIFIER --   (line 72)
+  { 10, 1, 2, 322 },  //  EXPR := int_literal   (line 74)
+  { 10, 1, 2, 328 },  //  EXPR := float_literal   (line 75)
+  { 10, 1, 2, 334 },  //  EXPR := string_literal   (line 76)
+  { 10, 1, 2, 340 },  //  EXPR := true   (line 77)
+  { 10, 1, 2, 346 },  //  EXPR := false   (line 78)
+  { 10, 1, 2, 352 },  //  EXPR := identifier   (line 79)
+  { 10, 3, 1, 358 },  //  EXPR := IDENTIFIER ( )   (line 80)
+  { 10, 4, 1, 365 },  //  EXPR := IDENTIFIER ( CALL_PARAMS )   (line 80)
+  { 10, 3, 0, 373 },  //  EXPR := ( EXPR )   (line 81)
+  { 10, 2, 2, 376 },  //  EXPR := not EXPR   (line 82)
+  { 10, 2, 2, 384 },  //  EXPR := - EXPR   (line 83)
+  { 10, 3, 2, 392 },  //  EXPR := EXPR == EXPR   (line 84)
+  { 10, 3, 2, 402 },  //  EXPR := EXPR < EXPR   (line 85)
+  { 10, 3, 2, 412 },  //  EXPR := EXPR <= EXPR   (line 86)
+  { 10, 3, 2, 422 },  //  EXPR := EXPR > EXPR   (line 87)
+  { 10, 3, 2, 432 },  //  EXPR := EXPR >= EXPR   (line 88)
+  { 10, 3, 2, 442 },  //  EXPR := EXPR and EXPR   (line 89)
+  { 10, 3, 2, 452 },  //  EXPR := EXPR or EXPR   (line 90)
+  { 10, 3, 2, 462 },  //  EXPR := EXPR + EXPR   (line 91)
+  { 10, 3, 2, 472 },  //  EXPR := EXPR - EXPR   (line 92)
+  { 10, 3, 2, 482 },  //  EXPR := EXPR % EXPR   (line 93)
+  { 10, 3, 2, 492 },  //  EXPR := EXPR * EXPR   (line 94)
+  { 10, 3, 2, 502 },  //  EXPR := EXPR / EXPR   (line 95)
+  { 11, 0, 1, 512 },  //  PARAMS :=   (line 97)
+  { 11, 1, 1, 517 },  //  PARAMS := ARGS   (line 97)
+  { 12, 2, 1, 523 },  //  ARGS := TYPE IDENTIFIER   (line 99)
+  { 12, 4, 1, 533 },  //  ARGS := ARGS , TYPE IDENTIFIER   (line 100)
+  { 13, 1, 0, 545 },  //  CALL_PARAMS := EXPR   (line 102)
+  { 13, 3, 0, 550 },  //  CALL_PARAMS := CALL_PARAMS , EXPR   (line 103)
+  { 14, 1, 2, 557 },  //  TYPE := int   (line 105)
+  { 14, 1, 2, 563 },  //  TYPE := string   (line 106)
+  { 14, 1, 2, 569 },  //  TYPE := float   (line 107)
+  { 14, 1, 2, 575 },  //  TYPE := bool   (line 108)
+  { 15, 1, 2, 581 }   //  IDENTIFIER := identifier   (line 110)
+};
+
+const short parseCode[] = {
+  PC_VALUE, 0, PC_END,
+  PC_LIST, 0, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_LIST, 2, PC_END,
+  PC_VALUE, 0, PC_NODE, NTProgram, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTProgramPart, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTProgramPart, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTProgramPart, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTProgramPart, 1, PC_END,
+  PC_LIST, 0, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_LIST, 2, PC_END,
+  PC_VALUE, 1, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTNoop, 1, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTCallSt, 2, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_NONE, PC_NODE, NTCallSt, 2, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 2, PC_NODE, NTCallSt, 2, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 1, PC_VALUE, 3, PC_NONE, PC_NODE, NTIfSt, 3, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 1, PC_VALUE, 3, PC_VALUE, 5, PC_NODE, NTIfSt, 3, PC_NODE, NTStatement, 1, PC_END,
+  PC_NONE, PC_NODE, NTReturnSt, 1, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 1, PC_NODE, NTReturnSt, 1, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 1, PC_NODE, NTLoopSt, 1, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 1, PC_VALUE, 3, PC_NODE, NTWhileSt, 2, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 1, PC_VALUE, 3, PC_VALUE, 5, PC_NODE, NTStatement, 1, PC_VALUE, 7, PC_NODE, NTForSt, 4, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTBreakSt, 2, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTNextSt, 2, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 0, PC_END,
+  PC_VALUE, 0, PC_NODE, NTStatement, 1, PC_END,
+  PC_VALUE, 1, PC_VALUE, 2, PC_VALUE, 4, PC_NODE, NTFunction, 3, PC_END,
+  PC_VALUE, 2, PC_VALUE, 3, PC_VALUE, 5, PC_VALUE, 0, PC_NODE, NTFunction, 4, PC_END,
+  PC_VALUE, 2, PC_VALUE, 3, PC_NODE, NTExternFunction, 2, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NONE, PC_NODE, NTDeclaration, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 3, PC_NODE, NTDeclaration, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 3, PC_NODE, NTDeclaration, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTAssignment, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTAssignment, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTAssignment, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTAssignment, 2, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTAssignment, 2, PC_END,
+  PC_VALUE, 0, PC_NODE, NTLiteral, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTLiteral, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTLiteral, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTLiteral, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTLiteral, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTIdentifier, 1, PC_END,
+  PC_VALUE, 0, PC_NONE, PC_NODE, NTCallExpr, 2, PC_END,
+  PC_VALUE, 0, PC_VALUE, 2, PC_NODE, NTCallExpr, 2, PC_END,
+  PC_VALUE, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTExpression, 2, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTExpression, 2, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_VALUE, 2, PC_NODE, NTExpression, 3, PC_END,
+  PC_NONE, PC_NODE, NTArgList, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTArgList, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 1, PC_NODE, NTArg, 2, PC_LIST, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 2, PC_VALUE, 3, PC_NODE, NTArg, 2, PC_LIST, 2, PC_END,
+  PC_VALUE, 0, PC_LIST, 1, PC_END,
+  PC_VALUE, 0, PC_VALUE, 2, PC_LIST, 2, PC_END,
+  PC_VALUE, 0, PC_NODE, NTType, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTType, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTType, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTType, 1, PC_END,
+  PC_VALUE, 0, PC_NODE, NTIdentifier, 1, PC_END
+};
@@ -0,0 +1,49 @@
+/*
+ *
+ *
+ * Parse tables of the LALR(1) parser. Generated by aux/lrgen from
+ * docs/grammar.txt: do not edit, change the grammar instead.
+ *
+ */
+
+#ifndef PARSETABLES_H
+#define PARSETABLES_H
+
+#include "parser.h"
+
+// Number of states of the parser
+#define PARSE_STATES 146
+
+// Number of columns of the ACTION table (0: tokens not in the grammar,
+// 1: end of file)
+#define PARSE_COLUMNS 49
+
+// Number of non-terminals (columns of the GOTO table)
+#define PARSE_NONTERMINALS 18
+
+// Number of rules (0 accepts the program)
+#define PARSE_RULES 72
+
+// Maximum number of operands of the code of a rule
+#define PARSE_MAX_OPERANDS 4
+
+// Column of the ACTION table of each token type
+extern const unsigned char parseColumn[N_TOKEN_TYPES];
+
+// Token type of each column of the ACTION table
+extern const short parseColumnToken[PARSE_COLUMNS];
+
+// ACTION table: 0 is an error, s > 0 shifts the token and goes to state
+// s, and r < 0 reduces rule -r - 1
+extern const short parseAction[PARSE_STATES][PARSE_COLUMNS];
+
+// GOTO table: state after reducing a rule of a non-terminal
+extern const short parseGoto[PARSE_STATES][PARSE_NONTERMINALS];
+
+// The rules of the grammar
+extern const ParseRule parseRules[PARSE_RULES];
+
+// The code of the rules (see ParseCode)
+extern const short parseCode[];
+
+#endif
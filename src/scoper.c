@@ -5,11 +5,14 @@
 #include "util.h"
 #include "ast.h"
 #include "cli.h"
+#include "arena.h"
+#include "compiler.h"
+#include "incremental.h"
 
-// Initial size of a symbol table
-#define MAX_INITIAL_SYMBOLS 10
+// Initial size of a symbol table (a power of two)
+#define MAX_INITIAL_SYMBOLS 8
 
-ScoperState scoperState;
+__thread ScoperState scoperState;
 
 /*
  * Tries to add a symbol to the symbol table of the nearest scope for the
@@ -18,9 +21,29 @@ ScoperState scoperState;
  * node: the node where to start the search for the symbol.
  * token: the token containing the name of the symbol.
  * type: type of symbol to be added.
+ * returns: the binding of the added symbol.
  *
  */
-void tryAddSymbol(Node* node, Token* token, SymbolType type);
+Binding tryAddSymbol(Node* node, Token* token, SymbolType type);
+
+/*
+ * Looks from a node upwards in the tree, through the chain of scopes, for
+ * the nearest symbol with a name.
+ *
+ * node: the node to start the search from.
+ * id: the id of the name of the symbol.
+ * returns: the binding of the symbol (with scope -1 if not found).
+ *
+ */
+Binding resolveName(Node* node, int id);
+
+/*
+ * Fills the side table of the innermost scope-bearing node of each node.
+ * Nodes are visited from the root down, so the scope of a parent is known
+ * before its children.
+ *
+ */
+void findScopes();
 
 /*
  * Does all the scope checking for a node. This includes adding declared
@@ -32,20 +55,29 @@ void tryAddSymbol(Node* node, Token* token, SymbolType type);
 void resolveScope(Node* node);
 
 /*
- * Finds and returns a symbol from a scope-bearing node (i.e. looks only in
- * this node, does not search upwards).
+ * Finds a symbol in a scope-bearing node (i.e. looks only in this node, does
+ * not search upwards).
  *
  * scopeNode: a scope-bearing node (that has a symbol table) wherein we want
  *   to find a symbol.
- * symToken: a token containing the name of the symbol.
- * returns: the symbol, or NULL if not found.
+ * id: the id of the name of the symbol.
+ * returns: the position of the symbol in the table, or -1 if not found.
  *
  */
-Symbol* findSymbol(Node* scopeNode, Token* symToken);
+int findSymbol(Node* scopeNode, int id);
 
 /*
- * Displays a scope error message and terminates the program with exit code 1
- * (error).
+ * Puts a symbol of a table in the first free slot for its name.
+ *
+ * st: the symbol table, with room in its slots.
+ * i: the position of the symbol.
+ *
+ */
+void indexSymbol(SymbolTable* st, int i);
+
+/*
+ * Displays a scope error message and stops the compilation (see
+ * failCompilation).
  *
  * msg: the message text.
  * lnum: line number of the error.
@@ -81,9 +113,10 @@ SymbolTable* createSymTable(Node* scopeNode);
  * scopeNode: the scope-bearing node whose symbol table will hold the
  *   new symbol.
  * symbol: the symbol to be added.
+ * returns: the position of the symbol in the table.
  *
  */
-void addSymbol(Node* scopeNode, Symbol symbol);
+int addSymbol(Node* scopeNode, Symbol symbol);
 
 /*
  * Debug function: prints the symbol table of a node.
@@ -114,162 +147,214 @@ void hoistFunctions(Node* ast);
 int bearsScope(Node* node);
 
 
-void scopeCheckerStart(FILE* file, char* filename, Node* ast) {
+void scopeCheckerStart(SourceFile* source, Node* ast) {
   if(!ast) return; // empty program
 
   scoperState = (ScoperState) {
-    .file = file,
-    .filename = filename
+    .source = source
   };
 
   if(cli.outputType <= OUT_DEBUG)
     printf("Starting scope checking...\n");
 
+  // symbol tables are kept in a side table of the AST
+  compAst.symTables = (SymbolTable**) arenaAlloc(&compArena,
+    sizeof(SymbolTable*) * compAst.nNodes);
+  memset(compAst.symTables, 0, sizeof(SymbolTable*) * compAst.nNodes);
+  compAst.bindings = (Binding*) arenaAlloc(&compArena,
+    sizeof(Binding) * compAst.nNodes);
+  memset(compAst.bindings, 0xff, sizeof(Binding) * compAst.nNodes);
+  compAst.scopes = (int*) arenaAlloc(&compArena,
+    sizeof(int) * compAst.nNodes);
+  findScopes();
+
   hoistFunctions(ast);
-  postorderTraverse(ast, &resolveScope);
+  if(incrementalState.enabled) prepareIncremental(ast);
+
+  // the parts of the program in order, which is their postorder; functions
+  // that did not change are not checked again (see incremental.h)
+  for(int i = 0; i < ast->nChildren; i++) {
+    Node* partNode = AST_CHILD(ast, i);
+    if(incrementalState.enabled && partNode->nChildren == 1
+       && AST_CHILD(partNode, 0)->type == NTFunction
+       && fingerprintFunction(ast, i)) continue;
+
+    postorderTraverse(partNode, &resolveScope);
+  }
+  resolveScope(ast);
 }
 
-void tryAddSymbol(Node* node, Token* token, SymbolType type) {
+Binding tryAddSymbol(Node* node, Token* token, SymbolType type) {
   Symbol newSym = {
     .token = token,
+    .id = token->id,
     .type = type
   };
-  Symbol* oldSym = lookupSymbol(node, token);
 
-  if(oldSym) {
-    char* fmt = "Redeclaration of '%s'.";
+  if(resolveName(node, token->id).scope >= 0) {
+    char* fmt = "Redeclaration of '%.*s'.";
     char msg[strlen(fmt) + token->nameSize];
-    sprintf(msg, fmt, token->name);
+    sprintf(msg, fmt, token->nameSize, tokenText(scoperState.source, token));
     scoperError(msg, token->lnum, token->chnum);
   }
   Node* scopeNode = getImmediateScope(node);
-  addSymbol(scopeNode, newSym);
+  return (Binding) {
+    .scope = AST_ID(scopeNode),
+    .symbol = addSymbol(scopeNode, newSym)
+  };
 }
 
-SymbolTable* createSymTable(Node* scopeNode) {
-  scopeNode->symTable = (SymbolTable*) malloc(sizeof(SymbolTable));
-  scopeNode->symTable->nSymbols = 0;
-  scopeNode->symTable->nArgs = 0;
-  scopeNode->symTable->nLocalVars = 0;
-  scopeNode->symTable->nStackVars = 0;
-  scopeNode->symTable->maxSize = MAX_INITIAL_SYMBOLS;
-  scopeNode->symTable->symbols = (Symbol**)
-    malloc(sizeof(Symbol*) * scopeNode->symTable->maxSize);
+void findScopes() {
+  for(int i = compAst.nNodes - 1; i >= 0; i--) {
+    Node* node = &compAst.nodes[i];
+    Node* parent = AST_PARENT(node);
+
+    if(bearsScope(node)) compAst.scopes[i] = i;
+    else if(!parent) genericError("Compiler bug: AST node without scope.");
+    else if(parent->type == NTForSt && whichChild(node) < 3) {
+      // special case: 'for' iteration declaration, expression and statement
+      // are in the scope of the 'for' body, which comes after them
+      if(parent->nChildren < 4 || AST_CHILD(parent, 3)->type != NTStatement)
+        genericError("Compiler bug: bad 'for' statement");
+
+      compAst.scopes[i] = compAst.scopes[AST_ID(AST_CHILD(parent, 3))];
+    }
+    else compAst.scopes[i] = compAst.scopes[node->parent];
+  }
+}
 
+SymbolTable* createSymTable(Node* scopeNode) {
+  AST_SYMTABLE(scopeNode) = (SymbolTable*) arenaAlloc(&compArena,
+    sizeof(SymbolTable));
+  AST_SYMTABLE(scopeNode)->nSymbols = 0;
+  AST_SYMTABLE(scopeNode)->nArgs = 0;
+  AST_SYMTABLE(scopeNode)->nLocalVars = 0;
+  AST_SYMTABLE(scopeNode)->nStackVars = 0;
+  AST_SYMTABLE(scopeNode)->maxSize = MAX_INITIAL_SYMBOLS;
+  AST_SYMTABLE(scopeNode)->symbols = (Symbol*) arenaAlloc(&compArena,
+    sizeof(Symbol) * MAX_INITIAL_SYMBOLS);
+  AST_SYMTABLE(scopeNode)->nSlots = 2 * MAX_INITIAL_SYMBOLS;
+  AST_SYMTABLE(scopeNode)->slots = (int*) arenaAlloc(&compArena,
+    sizeof(int) * 2 * MAX_INITIAL_SYMBOLS);
+  memset(AST_SYMTABLE(scopeNode)->slots, 0,
+    sizeof(int) * 2 * MAX_INITIAL_SYMBOLS);
+
+  // the slots go on from the nearest scope above with symbols (the blocks in
+  // between have none)
   Node* scopeAbove = getScopeAbove(scopeNode);
-  if(scopeAbove && scopeAbove->symTable) {
-    scopeNode->symTable->nStackVarsAcc = scopeAbove->symTable->nStackVarsAcc;
+  while(scopeAbove && !AST_SYMTABLE(scopeAbove))
+    scopeAbove = getScopeAbove(scopeAbove);
+  if(scopeAbove && AST_SYMTABLE(scopeAbove)) {
+    AST_SYMTABLE(scopeNode)->nStackVarsAcc =
+      AST_SYMTABLE(scopeAbove)->nStackVarsAcc;
   }
-  else scopeNode->symTable->nStackVarsAcc = 0;
+  else AST_SYMTABLE(scopeNode)->nStackVarsAcc = 0;
 
-  return scopeNode->symTable;
+  return AST_SYMTABLE(scopeNode);
 }
 
-void addSymbol(Node* scopeNode, Symbol symbol) {
+int addSymbol(Node* scopeNode, Symbol symbol) {
 //printf("Adding %s to NT %d\n", symbol.token->name, scopeNode->type);
-  SymbolTable* st = scopeNode->symTable;
+  SymbolTable* st = AST_SYMTABLE(scopeNode);
   if(!st) st = createSymTable(scopeNode);
 
   if(st->nSymbols >= st->maxSize) {
-    st->symbols = (Symbol**) realloc(
-      st->symbols, sizeof(Symbol*) * st->maxSize * 2);
-
+    st->symbols = (Symbol*) arenaRealloc(&compArena, st->symbols,
+      sizeof(Symbol) * st->maxSize, sizeof(Symbol) * st->maxSize * 2);
     st->maxSize *= 2;
+
+    // the slots are rebuilt, twice as many
+    st->nSlots *= 2;
+    st->slots = (int*) arenaAlloc(&compArena, sizeof(int) * st->nSlots);
+    memset(st->slots, 0, sizeof(int) * st->nSlots);
+    for(int i = 0; i < st->nSymbols; i++) indexSymbol(st, i);
   }
 
-  Symbol* newSym = (Symbol*) malloc(sizeof(Symbol));
+  Symbol* newSym = &st->symbols[st->nSymbols];
   *newSym = symbol;
-  st->symbols[st->nSymbols] = newSym;
+  indexSymbol(st, st->nSymbols);
 
-  if(st->symbols[st->nSymbols]->type == STLocal) {
-    st->symbols[st->nSymbols]->pos = st->nLocalVars;
+  // locals and arguments take the next free slot of the stack frame
+  if(newSym->type == STLocal) {
+    newSym->pos = st->nStackVarsAcc;
     st->nLocalVars++;
     st->nStackVarsAcc++;
-  } else if(st->symbols[st->nSymbols]->type == STArg) {
-    st->symbols[st->nSymbols]->pos = st->nArgs;
+  } else if(newSym->type == STArg) {
+    newSym->pos = st->nStackVarsAcc;
     st->nArgs++;
     st->nStackVars++;
     st->nStackVarsAcc++;
   }
 
+  // the function keeps the size of its frame, even if it has no symbols of
+  // its own (e.g. no arguments, and locals only in nested blocks)
   Node* mlsNode = getMlsNode(scopeNode);
-  if(mlsNode && st->nStackVarsAcc > mlsNode->symTable->nStackVars)
-    mlsNode->symTable->nStackVars = st->nStackVarsAcc;
+  if(mlsNode && !AST_SYMTABLE(mlsNode)) createSymTable(mlsNode);
+  if(mlsNode && st->nStackVarsAcc > AST_SYMTABLE(mlsNode)->nStackVars)
+    AST_SYMTABLE(mlsNode)->nStackVars = st->nStackVarsAcc;
 
-  st->nSymbols++;
+  return st->nSymbols++;
 }
 
-Symbol* lookupSymbol(Node* node, Token* symToken) {
-  Node* lookNode = node;
+void indexSymbol(SymbolTable* st, int i) {
+  int mask = st->nSlots - 1;
+  int slot = st->symbols[i].id & mask;  // ids are dense: already spread
 
-  while(1) {
-//printf("Searching %s in NT %d\n", symbol->token->name, lookNode->type);
-    printSymTable(lookNode);
+  while(st->slots[slot]) slot = (slot + 1) & mask;
+  st->slots[slot] = i + 1;
+}
 
-    if(bearsScope(lookNode)) {
-      Symbol* sym = findSymbol(lookNode, symToken);
-      if(sym) return sym;
-    }
-    if(!lookNode->parent) return NULL;
+Symbol* lookupSymbol(Node* node, Token* symToken) {
+  Binding binding = resolveName(node, symToken->id);
+  if(binding.scope < 0) return NULL;
+  return &compAst.symTables[binding.scope]->symbols[binding.symbol];
+}
 
-    if(lookNode->parent->type == NTForSt && whichChild(lookNode) < 3) {
-      // for the 'for' statement we have to look for symbols starting from
-      // the scope of the 'for' body
+Binding resolveName(Node* node, int id) {
+  // the 'for' iteration declaration, expression and statement start from
+  // the scope of the 'for' body (see findScopes)
+  int scope = compAst.scopes[AST_ID(node)];
 
-      if(lookNode->parent->nChildren < 4
-         || lookNode->parent->children[3]->type != NTStatement)
-        genericError("Compiler bug: bad 'for' statement");
-      lookNode = lookNode->parent->children[3];
-    }
-    else lookNode = lookNode->parent;
+  while(1) {
+    Node* scopeNode = &compAst.nodes[scope];
+    printSymTable(scopeNode);
+
+    int i = findSymbol(scopeNode, id);
+    if(i >= 0) return (Binding) { .scope = scope, .symbol = i };
+    if(scopeNode->parent < 0) return (Binding) { .scope = -1, .symbol = -1 };
+    scope = compAst.scopes[scopeNode->parent];
   }
 }
 
-Symbol* findSymbol(Node* scopeNode, Token* symToken) {
-  if(!scopeNode->symTable) return NULL;  // node doesn't have a symbol table
+int findSymbol(Node* scopeNode, int id) {
+  if(!AST_SYMTABLE(scopeNode)) return -1;  // node doesn't have a symbol table
 
-  SymbolTable* st = scopeNode->symTable;
-  if(st->nSymbols == 0) return NULL;
+  SymbolTable* st = AST_SYMTABLE(scopeNode);
+  int mask = st->nSlots - 1;
 
-  for(int i = 0; i < st->nSymbols; i++) {
-    Symbol* tabSymbol = st->symbols[i];
-    if(tabSymbol->token->nameSize != symToken->nameSize) continue;
-    if(strncmp(tabSymbol->token->name, symToken->name,
-         symToken->nameSize) == 0) return tabSymbol;
+  // linear probing, up to an empty slot
+  for(int slot = id & mask; st->slots[slot]; slot = (slot + 1) & mask) {
+    if(st->symbols[st->slots[slot] - 1].id == id) return st->slots[slot] - 1;
   }
-  return NULL;
+  return -1;
 }
 
 Node* getImmediateScope(Node* node) {
-  if(bearsScope(node)) return node;
-  if(!node->parent) {
-    genericError("Compiler bug: AST node without scope.");
-  }
-  if(node->parent->type == NTForSt && whichChild(node) < 3) {
-    // special case: 'for' iteration declaration, expression and statement
-    if(node->parent->nChildren < 4
-       || node->parent->children[3]->type != NTStatement)
-      genericError("Compiler bug: bad 'for' statement");
-
-    return getImmediateScope(node->parent->children[3]);
-  }
-  return getImmediateScope(node->parent);
+  return AST_SCOPE(node);
 }
 
 Node* getScopeAbove(Node* node) {
-  if(!node->parent) return NULL;
-  if(bearsScope(node->parent)) return node->parent;
-  return getScopeAbove(node->parent);
+  if(node->parent < 0) return NULL;
+  return AST_SCOPE(AST_PARENT(node));
 }
 
 Node* getMlsNode(Node* node) {
-  if(isMlsNode(node)) return node;
-  if(!node->parent) return NULL;
-  return getMlsNode(node->parent);
+  while(node && !isMlsNode(node)) node = getScopeAbove(node);
+  return node;
 }
 
 char isMlsNode(Node* node) {
-  if(!bearsScope(node)) return 0;
+  if(AST_SCOPE(node) != node) return 0;  // not scope-bearing
   Node* scopeAbove = getScopeAbove(node);
   if(scopeAbove && !getScopeAbove(scopeAbove)) return 1;
   return 0;
@@ -277,61 +362,69 @@ char isMlsNode(Node* node) {
 
 void hoistFunctions(Node* ast) {
   for(int i = 0; i < ast->nChildren; i++) {
-    Node* fNode = ast->children[i]->children[0];
+    Node* fNode = AST_CHILD(AST_CHILD(ast, i), 0);
 
-    if(fNode->type == NTFunction) {
-      Node* termNode = fNode->children[0]->children[0];
-      tryAddSymbol(fNode, termNode->token, STFunction);
+    if(fNode->type == NTFunction || fNode->type == NTExternFunction) {
+      Node* termNode = AST_CHILD(AST_CHILD(fNode, 0), 0);
+      compAst.bindings[AST_ID(AST_CHILD(fNode, 0))] =
+        tryAddSymbol(fNode, AST_TOKEN(termNode), STFunction);
     }
   }
 }
 
 void resolveScope(Node* node) {
   if(node->type == NTIdentifier) {
-    if(!node->parent)
+    if(node->parent < 0)
       genericError("Compiler bug: AST node missing parent.");
 
     Node* scopeNode = node;
-    Node* parent = node->parent;
+    Node* parent = AST_PARENT(node);
     SymbolType stype;
 
-    if(parent->type == NTExpression || parent->type == NTAssignment
-       || parent->type == NTCallExpr || parent->type == NTCallSt) {
+    if(parent->type != NTFunction && parent->type != NTExternFunction
+       && parent->type != NTArg
+       && (parent->type != NTDeclaration || AST_CHILD(parent, 1) != node)) {
       // identifier in use  -- check if declared
-      Token* token = node->children[0]->token;
-      Symbol* oldSym = lookupSymbol(node, token);
+      Token* token = AST_TOKEN(AST_CHILD(node, 0));
+      compAst.bindings[AST_ID(node)] = resolveName(node, token->id);
+      Symbol* oldSym = AST_SYMBOL(node);
 
       if(!oldSym) { // undeclared
-        char* fmt = "Use of undeclared variable or function '%s'.";
+        char* fmt = "Use of undeclared variable or function '%.*s'.";
         char msg[strlen(fmt) + token->nameSize];
-        sprintf(msg, fmt, token->name);
+        sprintf(msg, fmt, token->nameSize,
+          tokenText(scoperState.source, token));
 
         scoperError(msg, token->lnum, token->chnum);
       } else {
-        char isFunc = (parent->type == NTCallExpr || parent->type == NTCallSt);
+        char isFunc = (parent->type == NTCallExpr || parent->type == NTCallSt)
+          && AST_CHILD(parent, 0) == node;
 
         if(isFunc && oldSym->type != STFunction) {
-          char* fmt =
-            "'%s' has previously been declared as a variable, not a function.";
+          char* fmt = "'%.*s' has previously been declared as a variable, "
+            "not a function.";
 
           char msg[strlen(fmt) + token->nameSize];
-          sprintf(msg, fmt, token->name);
+          sprintf(msg, fmt, token->nameSize,
+            tokenText(scoperState.source, token));
 
           scoperError(msg, token->lnum, token->chnum);
         } else if(!isFunc && oldSym->type == STFunction) {
-          char* fmt = "'%s' has been declared as a function, not a variable.";
+          char* fmt =
+            "'%.*s' has been declared as a function, not a variable.";
           char msg[strlen(fmt) + token->nameSize];
-          sprintf(msg, fmt, token->name);
+          sprintf(msg, fmt, token->nameSize,
+            tokenText(scoperState.source, token));
 
           scoperError(msg, token->lnum, token->chnum);
         }
       }
     } else { // identifier in declaration
-      if(parent->type == NTFunction) { // function name
+      if(parent->type == NTFunction || parent->type == NTExternFunction) {
         //stype = STFunction;
-        return; // functions already hoisted
+        return; // function name: functions already hoisted
       } else if(parent->type == NTDeclaration) { // variable name
-        Node* ppNode = parent->parent;
+        Node* ppNode = AST_PARENT(parent);
 
         if(!ppNode)
           genericError("Compiler bug: AST node missing parent.");
@@ -343,25 +436,28 @@ void resolveScope(Node* node) {
         } else if(ppNode->type == NTForSt) { // local 'for' variable
           stype = STLocal;
 
-          if(ppNode->nChildren < 4 || ppNode->children[3]->type != NTStatement)
+          if(ppNode->nChildren < 4 || AST_CHILD(ppNode, 3)->type != NTStatement)
             genericError("Compiler bug: bad 'for' statement.");
 
-          scopeNode = ppNode->children[3];
+          scopeNode = AST_CHILD(ppNode, 3);
         }
 
       } else if(parent->type == NTArg) { // function argument
+        // those of external functions only document them
+        if(AST_PARENT(AST_PARENT(parent))->type == NTExternFunction) return;
         stype = STArg;
 
-        if(parent->parent->parent->nChildren < 3)
+        if(AST_PARENT(AST_PARENT(parent))->nChildren < 3)
           genericError("Compiler bug: Function AST node missing statement.");
 
-        scopeNode = parent->parent->parent->children[2];
+        scopeNode = AST_CHILD(AST_PARENT(AST_PARENT(parent)), 2);
       }
 
       if(node->nChildren < 1)
         genericError("Compiler bug: Identifier AST node without child.");
 
-      tryAddSymbol(scopeNode, node->children[0]->token, stype);
+      compAst.bindings[AST_ID(node)] =
+        tryAddSymbol(scopeNode, AST_TOKEN(AST_CHILD(node, 0)), stype);
     }
   }
 }
@@ -369,14 +465,11 @@ void resolveScope(Node* node) {
 int bearsScope(Node* node) {
   if(node->type == NTProgram) return 1;
   if(node->type == NTStatement) {
-    if(node->parent->type == NTFunction ||
-       (node->parent->type == NTForSt && whichChild(node) == 3)) return 1;
+    if(AST_PARENT(node)->type == NTFunction ||
+       (AST_PARENT(node)->type == NTForSt && whichChild(node) == 3)) return 1;
 
     for(int i = 0; i < node->nChildren; i++) {
-      if(!node->children[i]) {
-        genericError("Internal bug: NULL AST node child.");
-      }
-      if(node->children[i]->type != NTStatement) return 0;
+      if(AST_CHILD(node, i)->type != NTStatement) return 0;
     }
     return 1;
   }
@@ -384,32 +477,36 @@ int bearsScope(Node* node) {
 }
 
 void scoperError(char* msg, int lnum, int chnum) {
-  if(cli.outputType > OUT_DEFAULT) exit(1);
+  if(cli.outputType > OUT_DEFAULT)
+    failCompilation(PHASE_SCOPER, msg, lnum, chnum);
 
   if(lnum > 0) {
     fprintf(stderr, "\nScope " ERROR_COLOR_START "ERROR" COLOR_END
       ": %s\n", msg);
-    printCharInFile(scoperState.file, scoperState.filename, lnum, chnum);
+    printCharInFile(scoperState.source, lnum, chnum);
   } else {
     fprintf(stderr, "\nScope " ERROR_COLOR_START "ERROR" COLOR_END
-      ": %s\n%s.\n", msg, scoperState.filename);
+      ": %s\n%s.\n", msg, scoperState.source->filename);
   }
-  exit(1);
+  failCompilation(PHASE_SCOPER, msg, lnum, chnum);
 }
 
 void printSymTable(Node* scopeNode) {
   if(cli.outputType > OUT_DEBUG) return;
-  if(!scopeNode->symTable) {
+  if(!AST_SYMTABLE(scopeNode)) {
 //    printf("NT %d: No symtable.\n", scopeNode->type);
     return;
   }
-//  printf("NT %d: symtable %p.\n", scopeNode->type, scopeNode->symTable);
+//  printf("NT %d: symtable %p.\n", scopeNode->type, AST_SYMTABLE(scopeNode));
   printf("NT %d: symtable has %d.", scopeNode->type,
-    scopeNode->symTable->nSymbols);
-  if(scopeNode->symTable->nSymbols > 0) {
-    for(int i = 0; i < scopeNode->symTable->nSymbols; i++)
-      printf(" %s [T:%d]", scopeNode->symTable->symbols[i]->token->name,
-        scopeNode->symTable->symbols[i]->type);
+    AST_SYMTABLE(scopeNode)->nSymbols);
+  if(AST_SYMTABLE(scopeNode)->nSymbols > 0) {
+    for(int i = 0; i < AST_SYMTABLE(scopeNode)->nSymbols; i++) {
+      Token* token = AST_SYMTABLE(scopeNode)->symbols[i].token;
+      printf(" %.*s [T:%d]", token->nameSize,
+        tokenText(scoperState.source, token),
+        AST_SYMTABLE(scopeNode)->symbols[i].type);
+    }
   }
   printf("\n");
 }
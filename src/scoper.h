@@ -13,22 +13,20 @@
 
 // Represents the state of the scope checker
 typedef struct stScoperState {
-  FILE* file;
-  char* filename;
+  SourceFile* source;
 } ScoperState;
 
 // The state of the scope checker
-extern ScoperState scoperState;
+extern __thread ScoperState scoperState;
 
 /*
  * Looks from the specified node upwards in the tree to find a symbol that
  *
- * file: a pointer to the source file being checked.
- * filename: the name of the source file being checked.
+ * source: the source file being checked.
  * ast: the root node of the AST.
  *
  */
-void scopeCheckerStart(FILE* file, char* filename, Node* ast);
+void scopeCheckerStart(SourceFile* source, Node* ast);
 
 /*
  * Looks from the specified node upwards in the tree to find a symbol that
@@ -0,0 +1,495 @@
+/*
+ *
+ *
+ * Compile server and its client.
+ *
+ */
+
+#define _GNU_SOURCE  // struct ucred
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "server.h"
+#include "compiler.h"
+#include "source.h"
+#include "threadpool.h"
+#include "xgen.h"
+
+// Name of the socket, in $XDG_RUNTIME_DIR or else in a private directory
+// of the user in $TMPDIR (or SOCKET_PARENT), named SOCKET_DIR (%d is
+// replaced by the user id)
+#define SOCKET_NAME "ulpc.sock"
+#define SOCKET_PARENT "/tmp"
+#define SOCKET_DIR "ulpc-%d"
+
+// Connections waiting to be accepted by the server
+#define SERVER_BACKLOG 64
+
+// Maximum size of the working directory of a client (and of the other
+// names in a request)
+#define CWD_SIZE 4096
+
+// Maximum size of a source sent in a request
+#define MAX_SOURCE_SIZE (256l << 20)
+
+// Size of the version of the compiler in the requests
+#define VERSION_SIZE 16
+
+// Options of the client that are sent to the server, as bits of a request
+// (the server builds its options out of them)
+#define OPTION_HUGE_PAGES 1
+#define OPTION_NASM 2
+#define OPTION_CACHE 4
+#define OPTION_INCREMENTAL 8
+#define OPTION_OBJECT 16
+#define ALL_OPTIONS 31
+
+// A compilation asked by a client. The strings (NUL terminated) and the
+// source (if it has no name) follow it.
+typedef struct stServerRequest {
+  char version[VERSION_SIZE];  // of the client (it must be the same)
+  int options;  // OPTION_ bits
+  int jobs;  // threads to lex a big source (0: one per core)
+  int cwdSize;  // sizes of the strings, with their NULs:
+  int sourceNameSize;  // (0: the source follows)
+  int outputNameSize;  // (0: the default name)
+  long sourceSize;  // size of the source, if it follows
+} ServerRequest;
+
+// The outcome of a compilation, sent back to the client
+typedef struct stServerReply {
+  int failed;  // 1 if the compilation failed, -1 if it was not done
+  CompileError error;
+} ServerReply;
+
+// Path of the socket of the server, removed when the server is stopped
+char serverPath[sizeof(((struct sockaddr_un*) 0)->sun_path)];
+
+/*
+ * Finds the path of the socket of the server. Unless it is given or in
+ * $XDG_RUNTIME_DIR, it is in a directory that only the user can access.
+ *
+ * path: where to leave it (with room for sizeof(sun_path) characters).
+ * create: 1 to create the directory of the socket if it does not exist.
+ * returns: 1 if it was found, 0 if it does not fit in a socket address or
+ *   its directory is missing or not private.
+ *
+ */
+int socketPath(char* path, char create);
+
+/*
+ * Connects to the server, which must be run by the same user.
+ *
+ * path: the path of the socket.
+ * returns: the socket, or -1 if there is no server.
+ *
+ */
+int connectServer(char* path);
+
+/*
+ * Checks that the process at the other end of a socket is of this user.
+ *
+ * fd: the socket.
+ * returns: 1 if it is, 0 otherwise.
+ *
+ */
+int peerIsUser(int fd);
+
+/*
+ * Accepts and serves clients, until the server is stopped (a task of the
+ * thread pool, one per thread).
+ *
+ * listenFd: pointer to the listening socket.
+ * index: the number of the thread.
+ *
+ */
+void serveClients(void* listenFd, int index);
+
+/*
+ * Serves the compilation asked by a client.
+ *
+ * fd: the socket connected to the client.
+ *
+ */
+void serveClient(int fd);
+
+/*
+ * Checks the sizes and the options in a request, which come from the
+ * client, before they are used.
+ *
+ * request: the request.
+ * returns: 1 if they are valid, 0 otherwise.
+ *
+ */
+int validRequest(ServerRequest* request);
+
+/*
+ * Makes the options of a compilation asked by a client.
+ *
+ * request: the request (already checked).
+ * returns: the options.
+ *
+ */
+struct stCli requestOptions(ServerRequest* request);
+
+/*
+ * Tells a client that its request cannot be served.
+ *
+ * fd: the socket connected to the client.
+ * message: the error.
+ *
+ */
+void rejectRequest(int fd, char* message);
+
+/*
+ * Makes an absolute path out of a path relative to a directory.
+ *
+ * dir: the directory.
+ * path: the path (kept as is if it is absolute).
+ * returns: the absolute path (to be freed by the caller).
+ *
+ */
+char* joinPath(char* dir, char* path);
+
+/*
+ * Removes the socket and ends the server (the handler of the signals that
+ * stop it).
+ *
+ * signal: the signal.
+ *
+ */
+void stopServer(int signal);
+
+/*
+ * Reads a given number of bytes from a socket.
+ *
+ * fd: the socket.
+ * data: where to leave them.
+ * size: the number of bytes.
+ * returns: 1 if they were read, 0 otherwise.
+ *
+ */
+int readFully(int fd, void* data, long size);
+
+/*
+ * Writes a given number of bytes to a socket.
+ *
+ * fd: the socket.
+ * data: the bytes.
+ * size: the number of bytes.
+ * returns: 1 if they were written, 0 otherwise.
+ *
+ */
+int writeFully(int fd, void* data, long size);
+
+
+int runServer(int nThreads) {
+  if(!socketPath(serverPath, 1)) {
+    fprintf(stderr, "ERROR: No private path for the socket.\n");
+    return 1;
+  }
+
+  // a socket left by a server that is gone is replaced
+  int fd = connectServer(serverPath);
+  if(fd >= 0) {
+    close(fd);
+    fprintf(stderr, "ERROR: A server is running at %s.\n", serverPath);
+    return 1;
+  }
+  unlink(serverPath);
+
+  struct sockaddr_un address = { .sun_family = AF_UNIX };
+  strcpy(address.sun_path, serverPath);
+  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+  // only the user can connect, from the moment the socket exists
+  mode_t mask = umask(077);
+  int bound = fd >= 0
+    && bind(fd, (struct sockaddr*) &address, sizeof(address)) == 0;
+  umask(mask);
+  if(!bound || listen(fd, SERVER_BACKLOG) != 0) {
+    fprintf(stderr, "ERROR: Cannot listen at %s.\n", serverPath);
+    return 1;
+  }
+
+  struct sigaction stop = { .sa_handler = stopServer };
+  struct sigaction ignore = { .sa_handler = SIG_IGN };
+  sigaction(SIGINT, &stop, NULL);
+  sigaction(SIGTERM, &stop, NULL);
+  sigaction(SIGPIPE, &ignore, NULL); // clients that leave do not stop it
+
+  // each thread serves one client at a time, keeping the memory of its
+  // compilations for the next one
+  if(nThreads < 1) nThreads = availableCores();
+  runTasksWithCleanup(nThreads, nThreads, serveClients, &fd,
+    releaseCompilerMemory);
+
+  unlink(serverPath);
+  return 1;
+}
+
+void serveClients(void* listenFd, int index) {
+  (void) index;
+
+  while(1) {
+    int fd = accept(*(int*) listenFd, NULL, NULL);
+    if(fd < 0) {
+      if(errno == EINTR || errno == ECONNABORTED) continue;
+      return;
+    }
+
+    if(peerIsUser(fd)) serveClient(fd);
+    close(fd);
+  }
+}
+
+void serveClient(int fd) {
+  ServerRequest request;
+  if(!readFully(fd, &request, sizeof(request))) return;
+
+  ServerReply reply = { .failed = -1 };
+  if(strncmp(request.version, VERSION, VERSION_SIZE) != 0) {
+    writeFully(fd, &reply, sizeof(reply)); // the client compiles it
+    return;
+  }
+
+  if(!validRequest(&request)) {
+    rejectRequest(fd, "Invalid request.");
+    return;
+  }
+
+  long size = request.cwdSize + request.sourceNameSize
+    + request.outputNameSize;
+  char* strings = (char*) malloc(size);
+  if(!strings || !readFully(fd, strings, size)) {
+    free(strings);
+    return;
+  }
+  char* cwd = strings;
+  char* sourceName = cwd + request.cwdSize;
+  char* outputName = sourceName + request.sourceNameSize;
+
+  // each string must end within its size
+  if(cwd[request.cwdSize - 1] != '\0'
+     || (request.sourceNameSize > 0
+       && sourceName[request.sourceNameSize - 1] != '\0')
+     || (request.outputNameSize > 0
+       && outputName[request.outputNameSize - 1] != '\0')) {
+    rejectRequest(fd, "Invalid request.");
+    free(strings);
+    return;
+  }
+
+  // the names are relative to the directory of the client. The source
+  // keeps the absolute path it was loaded from, so that nothing depends on
+  // the directory of the server (the client prints the errors with its own
+  // name).
+  SourceFile* source = NULL;
+  char* path = NULL;
+  if(request.sourceNameSize > 0) {
+    path = joinPath(cwd, sourceName);
+    source = loadSource(path);
+  } else {
+    source = (SourceFile*) malloc(sizeof(SourceFile));
+    *source = (SourceFile) {
+      .filename = "<stdin>",
+      .data = (char*) malloc(request.sourceSize + 1),
+      .size = request.sourceSize,
+      .mapped = 0
+    };
+    if(!source->data || !readFully(fd, source->data, request.sourceSize)) {
+      closeSource(source);
+      source = NULL;
+    }
+  }
+
+  if(source) {
+    CompilerContext ctx = {
+      .options = requestOptions(&request),
+      .source = source,
+      .outputName = joinPath(cwd, request.outputNameSize > 0 ? outputName
+        : (request.options & OPTION_OBJECT ? OBJECT_FILE : EXEC_FILE)),
+      .lastPhase = PHASE_NONE,
+      .memoryOutput = 0
+    };
+
+    reply.failed = compile(&ctx);
+    reply.error = ctx.error;
+    free(ctx.outputName);
+    closeSource(source);
+    writeFully(fd, &reply, sizeof(reply));
+  } else {
+    rejectRequest(fd, "Invalid file name.");
+  }
+
+  free(path);
+  free(strings);
+}
+
+int validRequest(ServerRequest* request) {
+  return request->cwdSize > 0 && request->cwdSize <= CWD_SIZE
+    && request->sourceNameSize >= 0 && request->sourceNameSize <= CWD_SIZE
+    && request->outputNameSize >= 0 && request->outputNameSize <= CWD_SIZE
+    && request->sourceSize >= 0 && request->sourceSize <= MAX_SOURCE_SIZE
+    && (request->options & ~ALL_OPTIONS) == 0 && request->jobs >= 0;
+}
+
+struct stCli requestOptions(ServerRequest* request) {
+  // no more lexing threads than the cores of the server
+  int cores = availableCores();
+
+  return (struct stCli) {
+    .outputType = OUT_SILENT,
+    .sourceIdx = -1,
+    .outputIdx = -1,
+    .batchIdx = -1,
+    .jobs = request->jobs > 0 && request->jobs < cores ? request->jobs : 0,
+    .hugePages = (request->options & OPTION_HUGE_PAGES) != 0,
+    .nasm = (request->options & OPTION_NASM) != 0,
+    .cache = (request->options & OPTION_CACHE) != 0,
+    .incremental = (request->options & OPTION_INCREMENTAL) != 0,
+    .object = (request->options & OPTION_OBJECT) != 0
+  };
+}
+
+void rejectRequest(int fd, char* message) {
+  ServerReply reply = {
+    .failed = 1,
+    .error = { .phase = PHASE_NONE, .lnum = 0, .chnum = 0 }
+  };
+  strcpy(reply.error.message, message);
+  writeFully(fd, &reply, sizeof(reply));
+}
+
+int runClient(struct stCli* options, SourceFile* source, char fromStdin,
+  char* outputName) {
+  char path[sizeof(serverPath)];
+  char cwd[CWD_SIZE];
+  if(!socketPath(path, 0) || !getcwd(cwd, sizeof(cwd))) return -1;
+
+  int fd = connectServer(path);
+  if(fd < 0) return -1;
+
+  ServerRequest request = {
+    .options = (options->hugePages ? OPTION_HUGE_PAGES : 0)
+      | (options->nasm ? OPTION_NASM : 0)
+      | (options->cache ? OPTION_CACHE : 0)
+      | (options->incremental ? OPTION_INCREMENTAL : 0)
+      | (options->object ? OPTION_OBJECT : 0),
+    .jobs = options->jobs,
+    .cwdSize = strlen(cwd) + 1,
+    .sourceNameSize = fromStdin ? 0 : strlen(source->filename) + 1,
+    .outputNameSize = outputName ? strlen(outputName) + 1 : 0,
+    .sourceSize = fromStdin ? source->size : 0
+  };
+  strncpy(request.version, VERSION, VERSION_SIZE);
+
+  ServerReply reply;
+  int sent = writeFully(fd, &request, sizeof(request))
+    && writeFully(fd, cwd, request.cwdSize)
+    && writeFully(fd, source->filename, request.sourceNameSize)
+    && writeFully(fd, outputName, request.outputNameSize)
+    && writeFully(fd, source->data, request.sourceSize);
+  int received = sent && readFully(fd, &reply, sizeof(reply));
+  close(fd);
+  if(!received || reply.failed < 0) return -1;
+
+  if(reply.failed && options->outputType <= OUT_DEFAULT)
+    printCompileError(&reply.error, source->filename, source);
+  return reply.failed;
+}
+
+int socketPath(char* path, char create) {
+  char* name = getenv(SERVER_SOCKET_ENV);
+  size_t size = sizeof(serverPath);
+
+  if(name && *name) {
+    if(strlen(name) >= size) return 0;
+    strcpy(path, name);
+    return 1;
+  }
+
+  char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+  if(runtimeDir && *runtimeDir) {
+    if(strlen(runtimeDir) + 1 + strlen(SOCKET_NAME) >= size) return 0;
+    sprintf(path, "%s/%s", runtimeDir, SOCKET_NAME);
+    return 1;
+  }
+
+  char* parent = getenv("TMPDIR");
+  if(!parent || !*parent) parent = SOCKET_PARENT;
+  char dirName[32];
+  sprintf(dirName, SOCKET_DIR, (int) getuid());
+  if(strlen(parent) + strlen(dirName) + strlen(SOCKET_NAME) + 2 >= size)
+    return 0;
+  sprintf(path, "%s/%s", parent, dirName);
+
+  // the directory may have been made by someone else to take the socket
+  struct stat s;
+  if(create && mkdir(path, S_IRWXU) != 0 && errno != EEXIST) return 0;
+  if(lstat(path, &s) != 0 || !S_ISDIR(s.st_mode) || s.st_uid != getuid()
+     || (s.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+    return 0;
+
+  strcat(path, "/" SOCKET_NAME);
+  return 1;
+}
+
+int connectServer(char* path) {
+  struct sockaddr_un address = { .sun_family = AF_UNIX };
+  strcpy(address.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(fd < 0) return -1;
+  if(connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0
+     || !peerIsUser(fd)) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int peerIsUser(int fd) {
+  struct ucred peer;
+  socklen_t size = sizeof(peer);
+  return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &size) == 0
+    && peer.uid == getuid();
+}
+
+char* joinPath(char* dir, char* path) {
+  char* joined = (char*) malloc(strlen(dir) + strlen(path) + 2);
+  if(path[0] == '/') strcpy(joined, path);
+  else sprintf(joined, "%s/%s", dir, path);
+  return joined;
+}
+
+void stopServer(int signal) {
+  (void) signal;
+  unlink(serverPath);
+  _exit(0);
+}
+
+int readFully(int fd, void* data, long size) {
+  for(long done = 0; done < size; ) {
+    ssize_t n = read(fd, (char*) data + done, size - done);
+    if(n == 0 || (n < 0 && errno != EINTR)) return 0;
+    if(n > 0) done += n;
+  }
+  return 1;
+}
+
+int writeFully(int fd, void* data, long size) {
+  for(long done = 0; done < size; ) {
+    ssize_t n = write(fd, (char*) data + done, size - done);
+    if(n < 0 && errno != EINTR) return 0;
+    if(n > 0) done += n;
+  }
+  return 1;
+}
@@ -0,0 +1,51 @@
+/*
+ *
+ *
+ * Compile server. A resident compiler process accepts compilations over a
+ * Unix domain socket, so that compiling does not pay for starting a process
+ * each time, and the memory of the compilations (arenas, interned names,
+ * etc.) stays warm between them. The client is the same program, which
+ * sends its options and its source (or its name) to the server, and prints
+ * the outcome.
+ *
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "cli.h"
+#include "datast.h"
+
+// Environment variable with the path of the socket of the server
+#define SERVER_SOCKET_ENV "ULPC_SOCKET"
+
+/*
+ * Runs the compile server until it is interrupted (SIGINT or SIGTERM). The
+ * socket is at $ULPC_SOCKET, or by default in $XDG_RUNTIME_DIR, or else in
+ * a directory of the user in $TMPDIR (or /tmp) that only the user can
+ * access. Only clients of the same user are served.
+ *
+ * nThreads: number of compilations at the same time (0: one per core).
+ * returns: 1 if the server could not be started (it does not return
+ *   otherwise).
+ *
+ */
+int runServer(int nThreads);
+
+/*
+ * Has the compile server compile a source, and prints its errors as the
+ * compiler would.
+ *
+ * options: the options of the compilation.
+ * source: the source (which the server reads by its name, unless it comes
+ *   from stdin).
+ * fromStdin: 1 if the source was read from stdin, 0 if it is a file.
+ * outputName: the name of the executable (NULL for the default one).
+ * returns: the exit code of the compilation (0 or 1), or -1 if there is no
+ *   server to do it.
+ *
+ */
+int runClient(struct stCli* options, SourceFile* source, char fromStdin,
+  char* outputName);
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ *
+ *
+ * SHA-256 (FIPS 180-4).
+ *
+ */
+
+#include <string.h>
+#include "sha256.h"
+
+// Rotation of a 32 bit word to the right
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+// Constants of the rounds
+const uint32_t sha256Rounds[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+ * Hashes a block of 64 bytes into the state of a digest.
+ *
+ * sha: the digest.
+ * block: the block.
+ *
+ */
+void sha256Block(Sha256* sha, const unsigned char* block);
+
+
+void sha256Init(Sha256* sha) {
+  *sha = (Sha256) {
+    .state = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f,
+      0x9b05688c, 0x1f83d9ab, 0x5be0cd19 },
+    .size = 0
+  };
+}
+
+void sha256Update(Sha256* sha, const void* data, long size) {
+  const unsigned char* bytes = (const unsigned char*) data;
+  int used = sha->size % 64;
+  sha->size += size;
+
+  if(used > 0) { // complete the pending block first
+    int missing = 64 - used;
+    if(size < missing) {
+      memcpy(sha->block + used, bytes, size);
+      return;
+    }
+    memcpy(sha->block + used, bytes, missing);
+    sha256Block(sha, sha->block);
+    bytes += missing;
+    size -= missing;
+  }
+
+  for(; size >= 64; bytes += 64, size -= 64) sha256Block(sha, bytes);
+  memcpy(sha->block, bytes, size);
+}
+
+void sha256Final(Sha256* sha, unsigned char* digest) {
+  uint64_t bits = sha->size * 8;
+  int used = sha->size % 64;
+
+  // a 1 bit, zeros, and the size in bits (big endian) end the last block
+  unsigned char padding[72] = { 0x80 };
+  int paddingSize = (used < 56 ? 56 : 120) - used;
+  for(int i = 0; i < 8; i++)
+    padding[paddingSize + i] = (unsigned char) (bits >> (56 - 8 * i));
+  sha256Update(sha, padding, paddingSize + 8);
+
+  for(int i = 0; i < 32; i++)
+    digest[i] = (unsigned char) (sha->state[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+void sha256Block(Sha256* sha, const unsigned char* block) {
+  uint32_t w[64];
+  for(int i = 0; i < 16; i++) {
+    w[i] = (uint32_t) block[4 * i] << 24 | (uint32_t) block[4 * i + 1] << 16
+      | (uint32_t) block[4 * i + 2] << 8 | (uint32_t) block[4 * i + 3];
+  }
+  for(int i = 16; i < 64; i++) {
+    uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = sha->state[0], b = sha->state[1], c = sha->state[2],
+    d = sha->state[3], e = sha->state[4], f = sha->state[5],
+    g = sha->state[6], h = sha->state[7];
+
+  for(int i = 0; i < 64; i++) {
+    uint32_t s1 = ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25);
+    uint32_t t1 = h + s1 + ((e & f) ^ (~e & g)) + sha256Rounds[i] + w[i];
+    uint32_t s0 = ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22);
+    uint32_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  sha->state[0] += a;
+  sha->state[1] += b;
+  sha->state[2] += c;
+  sha->state[3] += d;
+  sha->state[4] += e;
+  sha->state[5] += f;
+  sha->state[6] += g;
+  sha->state[7] += h;
+}
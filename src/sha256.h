@@ -0,0 +1,51 @@
+/*
+ *
+ *
+ * SHA-256 digests, used to name the entries of the output cache after what
+ * they were compiled from (see cache.h).
+ *
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+
+// Size of a digest, in bytes
+#define SHA256_SIZE 32
+
+// A digest being computed
+typedef struct stSha256 {
+  uint32_t state[8];
+  uint64_t size;  // bytes hashed so far
+  unsigned char block[64];  // bytes not yet hashed (size % 64 of them)
+} Sha256;
+
+/*
+ * Starts a digest.
+ *
+ * sha: the digest.
+ *
+ */
+void sha256Init(Sha256* sha);
+
+/*
+ * Adds bytes to a digest.
+ *
+ * sha: the digest.
+ * data: the bytes.
+ * size: the number of bytes.
+ *
+ */
+void sha256Update(Sha256* sha, const void* data, long size);
+
+/*
+ * Ends a digest.
+ *
+ * sha: the digest.
+ * digest: where to leave it (SHA256_SIZE bytes).
+ *
+ */
+void sha256Final(Sha256* sha, unsigned char* digest);
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ *
+ *
+ * Loads source files into memory, either by mapping them (regular files) or
+ * by reading them completely into a buffer (pipes, terminals).
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source.h"
+
+// Initial size of the buffer used to read non-mappable inputs (doubled when
+// needed)
+#define INITIAL_READ_SIZE 65536
+
+/*
+ * Reads a file descriptor until EOF into a malloc'ed buffer.
+ *
+ * source: the source whose data and size fields will be filled.
+ * fd: the file descriptor to read from.
+ * returns: 1 on success, 0 on read errors.
+ *
+ */
+int readWholeFd(SourceFile* source, int fd);
+
+SourceFile* loadSource(char* filename) {
+  int fd = open(filename, O_RDONLY);
+  if(fd < 0) return NULL;
+
+  SourceFile* source = loadSourceFd(fd, filename);
+  close(fd);
+  return source;
+}
+
+SourceFile* loadSourceFd(int fd, char* name) {
+  SourceFile* source = (SourceFile*) malloc(sizeof(SourceFile));
+  source->filename = name;
+  source->data = NULL;
+  source->size = 0;
+  source->mapped = 0;
+
+  struct stat s;
+  if(fstat(fd, &s) == 0 && S_ISREG(s.st_mode) && s.st_size > 0) {
+    void* data = mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if(data != MAP_FAILED) {
+      posix_madvise(data, s.st_size, POSIX_MADV_SEQUENTIAL);
+      source->data = (char*) data;
+      source->size = s.st_size;
+      source->mapped = 1;
+      return source;
+    }
+  }
+
+  // not mappable (pipe, terminal, empty file...): read everything
+  if(!readWholeFd(source, fd)) {
+    free(source);
+    return NULL;
+  }
+  return source;
+}
+
+int readWholeFd(SourceFile* source, int fd) {
+  long maxSize = INITIAL_READ_SIZE;
+  char* data = (char*) malloc(sizeof(char) * maxSize);
+  long size = 0;
+
+  while(1) {
+    if(size >= maxSize) {
+      maxSize *= 2;
+      data = (char*) realloc(data, sizeof(char) * maxSize);
+    }
+
+    ssize_t n = read(fd, data + size, maxSize - size);
+    if(n == 0) break;
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      free(data);
+      return 0;
+    }
+    size += n;
+  }
+
+  source->data = data;
+  source->size = size;
+  return 1;
+}
+
+void closeSource(SourceFile* source) {
+  if(!source) return;
+
+  if(source->mapped) munmap(source->data, source->size);
+  else free(source->data);
+  free(source);
+}
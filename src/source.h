@@ -0,0 +1,47 @@
+/*
+ *
+ *
+ * Input layer of the compiler. The whole source file is made available in
+ * memory before lexing starts: regular files are memory-mapped, while pipes
+ * and terminals (e.g. stdin) are read completely into a single buffer.
+ *
+ * The same buffer is used by the lexer and by the error reporting
+ * functions, so the source is never read twice.
+ *
+ */
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include "datast.h"
+
+/*
+ * Loads a source file into memory.
+ *
+ * filename: path of the file to be loaded.
+ * returns: a pointer to the loaded source, or NULL if the file could not be
+ *   opened or read.
+ *
+ */
+SourceFile* loadSource(char* filename);
+
+/*
+ * Loads the contents of an already open file descriptor (such as stdin)
+ * into memory. The descriptor is read until EOF, and is left open.
+ *
+ * fd: the file descriptor to read from.
+ * name: name used to refer to this source in messages (e.g. "<stdin>").
+ * returns: a pointer to the loaded source, or NULL on read errors.
+ *
+ */
+SourceFile* loadSourceFd(int fd, char* name);
+
+/*
+ * Releases the memory used by a loaded source file.
+ *
+ * source: the source file to be released.
+ *
+ */
+void closeSource(SourceFile* source);
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ *
+ *
+ * Thread pool implementation using POSIX threads.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+// Work shared by the threads of a pool
+typedef struct stTaskQueue {
+  TaskFunction task;
+  void* arg;
+  int nTasks;
+  int nextTask;  // index of the next task not yet started
+  void (*cleanup)();  // called by each worker at the end (if not NULL)
+} TaskQueue;
+
+/*
+ * Main loop of the worker threads: takes and runs tasks until none is left.
+ *
+ * queue: the TaskQueue shared by the threads.
+ * returns: NULL.
+ *
+ */
+void* workerLoop(void* queue);
+
+void runTasks(int nThreads, int nTasks, TaskFunction task, void* arg) {
+  runTasksWithCleanup(nThreads, nTasks, task, arg, NULL);
+}
+
+void runTasksWithCleanup(int nThreads, int nTasks, TaskFunction task,
+  void* arg, void (*cleanup)()) {
+  TaskQueue queue = {
+    .task = task,
+    .arg = arg,
+    .nTasks = nTasks,
+    .nextTask = 0,
+    .cleanup = cleanup
+  };
+
+  if(nThreads > nTasks) nThreads = nTasks;
+  if(nThreads < 1) nThreads = 1;
+
+  pthread_t* threads = (pthread_t*) malloc(sizeof(pthread_t) * nThreads);
+  int nStarted = 0;
+
+  for(int i = 1; i < nThreads; i++) {
+    // if a thread cannot be created, the others do its share
+    if(pthread_create(&threads[nStarted], NULL, workerLoop, &queue) == 0)
+      nStarted++;
+  }
+
+  workerLoop(&queue);
+  for(int i = 0; i < nStarted; i++) pthread_join(threads[i], NULL);
+  free(threads);
+}
+
+void* workerLoop(void* queue) {
+  TaskQueue* q = (TaskQueue*) queue;
+
+  while(1) {
+    int index = __atomic_fetch_add(&q->nextTask, 1, __ATOMIC_RELAXED);
+    if(index >= q->nTasks) break;
+    q->task(q->arg, index);
+  }
+
+  if(q->cleanup) q->cleanup();
+  return NULL;
+}
+
+int availableCores() {
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n < 1 ? 1 : (int) n;
+}
@@ -0,0 +1,52 @@
+/*
+ *
+ *
+ * Minimal thread pool used to run independent tasks (such as lexing the
+ * chunks of a big source file) on several cores.
+ *
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// A task receives the shared argument given to runTasks and its index.
+typedef void (*TaskFunction)(void* arg, int index);
+
+/*
+ * Runs the tasks 0, 1, ..., nTasks - 1 on a pool of threads and waits for
+ * all of them to finish. The calling thread is one of the workers, and idle
+ * workers take the next task not yet started, so tasks of different sizes
+ * are balanced among threads.
+ *
+ * nThreads: number of threads to use (including the calling thread).
+ * nTasks: number of tasks to run.
+ * task: function that runs a single task.
+ * arg: argument passed to every task.
+ *
+ */
+void runTasks(int nThreads, int nTasks, TaskFunction task, void* arg);
+
+/*
+ * Runs tasks like runTasks, and then has each worker call a function before
+ * it ends (e.g. to free the memory that its tasks keep in thread-local
+ * state).
+ *
+ * nThreads: number of threads to use (including the calling thread).
+ * nTasks: number of tasks to run.
+ * task: function that runs a single task.
+ * arg: argument passed to every task.
+ * cleanup: function called by each worker once there are no tasks left.
+ *
+ */
+void runTasksWithCleanup(int nThreads, int nTasks, TaskFunction task,
+  void* arg, void (*cleanup)());
+
+/*
+ * Returns the number of processors available.
+ *
+ * returns: the number of online processors (at least 1).
+ *
+ */
+int availableCores();
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ *
+ *
+ * libulpc: compilation from memory to memory.
+ *
+ */
+
+#include <stdlib.h>
+#include "ulpc.h"
+
+int ulpcCompile(char* name, char* data, long size, UlpcOutput output,
+  UlpcResult* result) {
+  SourceFile source = {
+    .filename = name,
+    .data = data,
+    .size = size,
+    .mapped = 0
+  };
+
+  CompilerContext ctx = {
+    .options = {
+      .outputType = OUT_SILENT,
+      .sourceIdx = -1,
+      .outputIdx = -1,
+      .jobs = 1,
+      .hugePages = 0,
+      .nasm = (output == ULPC_ASM)
+    },
+    .source = &source,
+    .outputName = NULL,
+    .lastPhase = output == ULPC_TOKENS ? PHASE_LEXER
+      : (output == ULPC_AST ? PHASE_SCOPER : PHASE_NONE),
+    .memoryOutput = 1
+  };
+  compile(&ctx);
+
+  *result = (UlpcResult) {
+    .failed = ctx.failed,
+    .error = ctx.error,
+    .tokens = ctx.tokens,
+    .nTokens = ctx.nTokens,
+    .nodes = ctx.nodes,
+    .nNodes = ctx.nNodes,
+    .edges = ctx.edges,
+    .nEdges = ctx.nEdges,
+    .output = ctx.output,
+    .outputSize = ctx.outputSize
+  };
+  return result->failed;
+}
+
+void ulpcFreeResult(UlpcResult* result) {
+  free(result->tokens);
+  free(result->nodes);
+  free(result->edges);
+  free(result->output);
+  result->tokens = NULL;
+  result->nodes = NULL;
+  result->edges = NULL;
+  result->output = NULL;
+}
+
+void ulpcRelease() {
+  releaseCompilerMemory();
+}
@@ -0,0 +1,69 @@
+/*
+ *
+ *
+ * Interface of libulpc, the compiler as a library (build/libulpc.a).
+ * Sources are compiled from memory to memory: nothing is read from or
+ * written to files, nothing is printed, and errors are returned as
+ * diagnostics. Each thread can run its own compilations at the same time.
+ *
+ */
+
+#ifndef ULPC_H
+#define ULPC_H
+
+#include "compiler.h"
+
+// What a compilation produces
+typedef enum enUlpcOutput {
+  ULPC_TOKENS,  // the tokens of the source
+  ULPC_AST,  // the AST, checked by the scope checker
+  ULPC_ASM,  // the assembly code (nasm syntax)
+  ULPC_EXEC  // the executable image (a static ELF64 executable)
+} UlpcOutput;
+
+// The outcome of a compilation. The tokens, nodes, edges and output are
+// allocated for the caller, and freed by ulpcFreeResult.
+typedef struct stUlpcResult {
+  int failed;  // 1 if the compilation stopped with an error
+  CompileError error;  // the diagnostic of the error, if failed
+  Token* tokens;  // ULPC_TOKENS: all of them; ULPC_AST: those of the AST
+  int nTokens;
+  Node* nodes;  // ULPC_AST: the nodes, in postorder (the root is the last)
+  int nNodes;
+  int* edges;  // ULPC_AST: the children of the nodes (see Node)
+  int nEdges;
+  char* output;  // ULPC_ASM and ULPC_EXEC: the code
+  long outputSize;
+} UlpcResult;
+
+/*
+ * Compiles a source in memory. An empty program has no AST and no code.
+ *
+ * name: the name of the source.
+ * data: the source (it does not have to be NUL terminated). The tokens
+ *   refer to it by offset.
+ * size: the size of the source, in bytes.
+ * output: what to produce.
+ * result: where to leave the outcome.
+ * returns: 0 if the compilation succeeded, 1 if an error stopped it.
+ *
+ */
+int ulpcCompile(char* name, char* data, long size, UlpcOutput output,
+  UlpcResult* result);
+
+/*
+ * Frees what a compilation produced.
+ *
+ * result: the outcome of the compilation.
+ *
+ */
+void ulpcFreeResult(UlpcResult* result);
+
+/*
+ * Releases the memory that the calling thread keeps between compilations.
+ * It must be called before a thread that compiled sources ends.
+ *
+ */
+void ulpcRelease();
+
+#endif
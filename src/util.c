@@ -1,158 +1,116 @@
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "util.h"
 #include "cli.h"
+#include "ast.h"
+#include "compiler.h"
 
-int isLiteral(TokenType type) {
-  if(type == TTLitInt || type == TTLitFloat || type == TTLitString ||
-     type == TTLitBool || type == TTLitArray || type == TTTrue ||
-     type == TTFalse)
-    return 1;
-  return 0;
+char* tokenText(SourceFile* source, Token* token) {
+  return source->data + token->start;
 }
 
-int isType(TokenType type) {
-  if(type == TTInt || type == TTBool || type == TTString ||
-     type == TTFloat)
-    return 1;
-  return 0;
-}
-
-int isBinaryOp(TokenType type) {
-  if(type == TTEq || type == TTPlus || type == TTMinus ||
-     type == TTMult || type == TTDiv || type == TTGreater ||
-     type == TTLess || type == TTGEq || type == TTLEq ||
-     type == TTAnd || type == TTOr || type == TTMod)
-    return 1;
-  return 0;
-}
+unsigned int hashName(char* name, int size) {
+  uint64_t hash = size;
+  uint64_t word;
 
-int precedence(TokenType type) {
-  if(type == TTMult || type == TTDiv) return 0;
-  if(type == TTPlus || type == TTMinus) return 1;
-  if(type == TTMod) return 1;
-  if(type == TTNot) return 3;
-  if(type == TTAnd || type == TTOr) return 4;
-  if(type == TTGreater || type == TTGEq || type == TTEq ||
-     type == TTLess || type == TTLEq) return 5;
-  return -1;
-}
+  // 8 characters at a time, then the rest (padded with zeros)
+  for(; size >= 8; name += 8, size -= 8) {
+    memcpy(&word, name, 8);
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+    hash ^= hash >> 29;
+  }
+  word = 0;
+  memcpy(&word, name, size);
+  hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
 
-int isExprTerminator(TokenType type) {
-  if(type == TTColon || type == TTComma
-     || type == TTSemi || type == TTRPar) return 1;
-  return 0;
+  return (unsigned int) (hash ^ (hash >> 32));
 }
 
-int nodeIsToken(Node* node, TokenType type) {
-  if(!node) genericError("Internal error: AST node is NULL.");
-  if(node->type == NTTerminal) {
-    if(!node->token) {
-      genericError("Internal error: corrupted AST node.");
-    }
-    if(node->token->type == type) return 1;
+void hashBytes(void* data, long size, uint64_t* hash) {
+  unsigned char* bytes = (unsigned char*) data;
+  uint64_t a = hash[0] ^ (uint64_t) size;
+  uint64_t b = hash[1];
+  uint64_t word;
+
+  // two lanes with different multipliers, 8 bytes at a time, then the rest
+  // (padded with zeros: the size tells them apart)
+  for(; size >= 8; bytes += 8, size -= 8) {
+    memcpy(&word, bytes, 8);
+    a = (a ^ word) * 0x9e3779b97f4a7c15ull;
+    a ^= a >> 29;
+    b = (b + word) * 0xc2b2ae3d27d4eb4full;
+    b ^= b >> 31;
   }
-  return 0;
+  word = 0;
+  memcpy(&word, bytes, size);
+  a = (a ^ word) * 0x9e3779b97f4a7c15ull;
+  a ^= a >> 29;
+  b = (b + word) * 0xc2b2ae3d27d4eb4full;
+  b ^= b >> 31;
+
+  hash[0] = a;
+  hash[1] = b ^ a;
 }
 
-void printTokenInFile(FILE* file, char* filename, Token* token) {
-  rewind(file);
-
-  int BUFF_SIZE = 80;
-  char buff[BUFF_SIZE + 1];
-  char buff_mark[BUFF_SIZE + 1];
-
-  for(int i = 0; i <= BUFF_SIZE; i++) {
-    buff[i] = '\0';
-    buff_mark[i] = '\0';
-  }
-
-  int lnum = 1;
-  int chnum = 1;
-  while(!feof(file)) {
-    char ch = fgetc(file);
-
-    if(lnum == token->lnum) {
-      if(chnum < BUFF_SIZE) buff[chnum - 1] = ch;
-    } else if(lnum > token->lnum) break;
-
-    if(ch == '\n') {
-      lnum++;
-      chnum = 1;
-    } else chnum++;
-  }
-
-  for(int i = 0; i < BUFF_SIZE; i++) {
-    if(i + 1 < token->chnum || i + 1 >= token->chnum + token->nameSize) {
-      buff_mark[i] = ' ';
-    }
-    else buff_mark[i] = '^';
-  }
-
-  fprintf(stderr, "\nToken '%s':\n", token->name);
-  fprintf(stderr, "%s:%d:%d:\n\n", filename, token->lnum, token->chnum);
-  fprintf(stderr, "%s", buff);
-  fprintf(stderr, "%s\n", buff_mark);
+void printTokenInFile(SourceFile* source, Token* token) {
+  fprintf(stderr, "\nToken '%.*s':\n", token->nameSize,
+    tokenText(source, token));
+  fprintf(stderr, "%s:%d:%d:\n\n", source->filename, token->lnum,
+    token->chnum);
+  printMarkedLine(source, token->lnum, token->chnum, token->nameSize);
 }
 
-void printCharInFile(FILE* file, char* filename, int lnum, int chnum) {
-  rewind(file);
+void printCharInFile(SourceFile* source, int lnum, int chnum) {
+  fprintf(stderr, "%s: line %d, column %d:\n\n", source->filename,
+    lnum, chnum);
+  printMarkedLine(source, lnum, chnum, 1);
+}
 
+void printMarkedLine(SourceFile* source, int lnum, int chnum, int markSize) {
   int BUFF_SIZE = 80;
-  char buff[BUFF_SIZE + 1];
   char buff_mark[BUFF_SIZE + 1];
 
-  for(int i = 0; i <= BUFF_SIZE; i++) {
-    buff[i] = '\0';
-    buff_mark[i] = '\0';
-  }
-
-  int _lnum = 1;
-  int _chnum = 1;
-  while(!feof(file)) {
-    char ch = fgetc(file);
+  // find the beginning of the line
+  char* line = source->data;
+  char* end = source->data + source->size;
 
-    if(_lnum == lnum) {
-      if(_chnum < BUFF_SIZE) buff[_chnum - 1] = ch;
-    } else if(_lnum > lnum) break;
+  for(int l = 1; l < lnum && line < end; l++) {
+    char* newline = memchr(line, '\n', end - line);
+    line = newline ? newline + 1 : end;
+  }
 
-    if(ch == '\n') {
-      _lnum++;
-      _chnum = 1;
-    } else _chnum++;
+  // the line is printed with its line break, up to the buffer size
+  int lineSize = 0;
+  while(line + lineSize < end && lineSize < BUFF_SIZE - 1) {
+    lineSize++;
+    if(line[lineSize - 1] == '\n') break;
   }
 
   for(int i = 0; i < BUFF_SIZE; i++) {
-    if(i + 1 < chnum || i + 1 >= chnum + 1) {
+    if(i + 1 < chnum || i + 1 >= chnum + markSize) {
       buff_mark[i] = ' ';
     }
     else buff_mark[i] = '^';
   }
+  buff_mark[BUFF_SIZE] = '\0';
 
-  fprintf(stderr, "%s: line %d, column %d:\n\n", filename, lnum, chnum);
-  fprintf(stderr, "%s", buff);
+  fwrite(line, sizeof(char), lineSize, stderr);
+  if(lineSize > 0 && line[lineSize - 1] != '\n' && line + lineSize >= end)
+    fprintf(stderr, "\n"); // last line without line break
   fprintf(stderr, "%s\n", buff_mark);
 }
 
-void strReplaceNodeAndTokenName(char* str, char* format, Node* node) {
-  NodeType type = node->type;
-
-  if(type == NTTerminal) {
-    char strToken[node->token->nameSize + 10];
-    char* strTokenFormat = "token '%s'";
-    sprintf(strToken, strTokenFormat, node->token->name);
-    sprintf(str, format, strToken);
-  } else strReplaceNodeName(str, format, type);
-}
-
 void genericError(char* msg) {
   if(cli.outputType <= OUT_DEFAULT)
     fprintf(stderr, ERROR_COLOR_START "ERROR" COLOR_END ": %s\n", msg);
-  exit(1);
+  failCompilation(PHASE_NONE, msg, 0, 0);
 }
 
 void strReplaceTokenName(char* str, char* format, TokenType ttype) {
   switch(ttype) {
+    case TTEof: sprintf(str, format, "end of file"); break;
     case TTId: sprintf(str, format, "identifier"); break;
 
     // literals
@@ -207,6 +165,10 @@ void strReplaceTokenName(char* str, char* format, TokenType ttype) {
     case TTReturn: sprintf(str, format, "keyword 'return'"); break;;
     case TTLoop: sprintf(str, format, "keyword 'loop'"); break;
     case TTMatch: sprintf(str, format, "keyword 'match'"); break;
+    case TTTrue: sprintf(str, format, "keyword 'true'"); break;
+    case TTFalse: sprintf(str, format, "keyword 'false'"); break;
+    case TTExtern: sprintf(str, format, "keyword 'extern'"); break;
+    case TTExport: sprintf(str, format, "keyword 'export'"); break;
     default: sprintf(str, format, "other token");
   }
 }
@@ -234,14 +196,15 @@ void strReplaceNodeName(char* str, char* format, NodeType type) {
       break;
     case NTFunction: sprintf(str, format, "function declaration");
       break;
+    case NTExternFunction: sprintf(str, format,
+                                   "external function declaration");
+      break;
     case NTExpression: sprintf(str, format, "expression");
       break;
     case NTTerm: sprintf(str, format, "term");
       break;
     case NTLiteral: sprintf(str, format, "literal");
       break;
-    case NTBinaryOp: sprintf(str, format, "binary operator");
-      break;
     case NTProgram: sprintf(str, format, "complete program");
       break;
     case NTType: sprintf(str, format, "type");
@@ -252,8 +215,6 @@ void strReplaceNodeName(char* str, char* format, NodeType type) {
       break;
     case NTCallExpr: sprintf(str, format, "function call");
       break;
-    case NTCallParam: sprintf(str, format, "parameter expression");
-      break;
     case NTAssignment: sprintf(str, format, "assignment");
       break;
     case NTReturnSt: sprintf(str, format, "'return' statement");
@@ -271,13 +232,15 @@ void strReplaceNodeName(char* str, char* format, NodeType type) {
   }
 }
 
-void strReplaceNodeAbbrev(char* str, char* format, Node* node) {
+void strReplaceNodeAbbrev(SourceFile* source, char* str, char* format,
+  Node* node) {
   NodeType type = node->type;
 
   if(type == NTTerminal) {
-    char strToken[node->token->nameSize + 10];
-    char* strTokenFormat = "%s";
-    sprintf(strToken, strTokenFormat, node->token->name);
+    char strToken[AST_TOKEN(node)->nameSize + 10];
+    char* strTokenFormat = "%.*s";
+    sprintf(strToken, strTokenFormat, AST_TOKEN(node)->nameSize,
+      tokenText(source, AST_TOKEN(node)));
     sprintf(str, format, strToken);
   }
   else switch(type) {
@@ -301,14 +264,14 @@ void strReplaceNodeAbbrev(char* str, char* format, Node* node) {
       break;
     case NTFunction: sprintf(str, format, "F DECL");
       break;
+    case NTExternFunction: sprintf(str, format, "EXTERN F");
+      break;
     case NTExpression: sprintf(str, format, "EXPR");
       break;
     case NTTerm: sprintf(str, format, "TERM");
       break;
     case NTLiteral: sprintf(str, format, "LIT");
       break;
-    case NTBinaryOp: sprintf(str, format, "OP");
-      break;
     case NTProgram: sprintf(str, format, "PROGRAM");
       break;
     case NTType: sprintf(str, format, "TYPE");
@@ -319,8 +282,6 @@ void strReplaceNodeAbbrev(char* str, char* format, Node* node) {
       break;
     case NTCallExpr: sprintf(str, format, "CALL");
       break;
-    case NTCallParam: sprintf(str, format, "C PARAM");
-      break;
     case NTAssignment: sprintf(str, format, "ASSIGN");
       break;
     case NTReturnSt: sprintf(str, format, "RET st");
@@ -338,41 +299,38 @@ void strReplaceNodeAbbrev(char* str, char* format, Node* node) {
   }
 }
 
-void printNode(Node* node) {
+void printNode(SourceFile* source, Node* node) {
   printf("Node {\n");
 
   char nodeName[MAX_NODE_NAME];
-  strReplaceNodeAbbrev(nodeName, "%s", node);
+  strReplaceNodeAbbrev(source, nodeName, "%s", node);
   printf("  Type: [%d] %s\n", node->type, nodeName);
-  printf("  ID: %d\n", node->id);
+  printf("  ID: %d\n", AST_ID(node));
   printf("  #Children: %d\n", node->nChildren);
 
-  if(node->parent) {
+  if(node->parent >= 0) {
+    Node* parent = AST_PARENT(node);
     char parentNodeName[MAX_NODE_NAME];
-    strReplaceNodeAbbrev(parentNodeName, "%s", node->parent);
-    printf("  Parent: [%d] %s\n", node->parent->type, parentNodeName);
-
-    for(int i = 0; i < node->parent->nChildren; i++) {
-      if(node->parent->children[i]->id == node->id)
-        printf("  is child #%d\n", i);
-    }
+    strReplaceNodeAbbrev(source, parentNodeName, "%s", parent);
+    printf("  Parent: [%d] %s\n", parent->type, parentNodeName);
+    printf("  is child #%d\n", whichChild(node));
   }
   else printf("  Parent: NULL\n");
 
-  if(node->symTable) {
+  if(compAst.symTables && AST_SYMTABLE(node)) {
     printf("  Has symtable: true\n");
   }
   else printf("  Has symtable: false\n");
 
-  if(node->cgData) {
+  if(compAst.cgData && AST_CGDATA(node)) {
     printf("  Has CG Data: true\n");
   }
   else printf("  Has CG Data: false\n");
 
-  if(node->token) {
+  if(node->token >= 0) {
     char tokenName[MAX_NODE_NAME];
-    strReplaceTokenName(tokenName, "%s", node->token->type);
-    printf("  Token: [%d] %s\n", node->token->type, tokenName);
+    strReplaceTokenName(tokenName, "%s", AST_TOKEN(node)->type);
+    printf("  Token: [%d] %s\n", AST_TOKEN(node)->type, tokenName);
   }
   else printf("  Token: NULL\n");
 
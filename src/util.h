@@ -9,6 +9,7 @@
 #define UTIL_H
 
 #include <stdio.h>
+#include <stdint.h>
 #include "datast.h"
 
 // Colored messages in the terminal
@@ -19,73 +20,67 @@
 /*
  * Prints the line where a character is located and highlights the character.
  *
- * file: pointer to the source file (should be open, will be rewinded and
- *   will not be closed).
- * filename: name of the source file being processed.
+ * source: the source file being processed.
  * lnum: line number where the character appears.
  * chnum: column/position in the line where the character appears.
  *
  */
-void printCharInFile(FILE* file, char* filename, int lnum, int chnum);
+void printCharInFile(SourceFile* source, int lnum, int chnum);
 
 /*
  * Prints the line where the token is located and highlights the token.
  *
- * file: pointer to the source file (should be open, will be rewinded and
- *   will not be closed).
- * filename: name of the source file.
+ * source: the source file being processed.
  * token: pointer to the token to be printed.
  *
  */
-void printTokenInFile(FILE* file, char* filename, Token* token);
+void printTokenInFile(SourceFile* source, Token* token);
 
 /*
- * Checks whether a token type is a literal type.
+ * Prints a line of a source file, highlighting some of its characters.
  *
- * type: the token type to be checked.
- * returns: 1 if it is, 0 otherwise.
+ * source: the source file being processed.
+ * lnum: the line number.
+ * chnum: column/position of the first character to be highlighted.
+ * markSize: the number of characters to be highlighted.
  *
  */
-int isLiteral(TokenType type);
+void printMarkedLine(SourceFile* source, int lnum, int chnum, int markSize);
 
 /*
- * Checks whether a token type is a (data) type type.
+ * Gets the text of a token in the source file buffer. The text is not NUL
+ * terminated: token->nameSize gives its length.
  *
- * type: the token type to be checked.
- * returns: 1 if it is, 0 otherwise.
+ * source: the source file where the token was found.
+ * token: the token.
+ * returns: a pointer to the first character of the token.
  *
  */
-int isType(TokenType type);
+char* tokenText(SourceFile* source, Token* token);
 
 /*
- * Checks whether a token type is a binary operator.
+ * Hashes a name, e.g. an identifier (see intern.h). The characters are
+ * mixed 8 at a time.
  *
- * type: the token type to be checked.
- * returns: 1 if it is, 0 otherwise.
+ * name: the characters of the name.
+ * size: the number of characters.
+ * returns: the hash of the name.
  *
  */
-int isBinaryOp(TokenType type);
+unsigned int hashName(char* name, int size);
 
 /*
- * Gets the precedence of an operator token type.
+ * Mixes bytes into a 128-bit hash, e.g. to fingerprint code. It is not
+ * cryptographic, but it is much faster than SHA-256, and a change of the
+ * bytes leaves it the same only by a negligible chance. Several pieces can
+ * be hashed one after the other.
  *
- * type: the token type to be checked.
- * returns: The operator precedence. Maximum precedence is 0, meaning that
- *   such operations will be executed first. If not an operator, returns -1.
+ * data: the bytes.
+ * size: the number of bytes.
+ * hash: the hash so far (two words, zeros to start), updated.
  *
  */
-int precedence(TokenType type);
-
-/*
- * Checks whether the token type signals the end of an expression.
- *
- * type: the token type to be checked.
- * returns: 1 if it does, 0 otherwise.
- *
- */
-int isExprTerminator(TokenType type);
-
-int nodeIsToken(Node* node, TokenType type);
+void hashBytes(void* data, long size, uint64_t* hash);
 
 void genericError(char* msg);
 
@@ -93,11 +88,10 @@ void strReplaceTokenName(char* str, char* format, TokenType ttype);
 
 void strReplaceNodeName(char* str, char* format, NodeType type);
 
-void strReplaceNodeAndTokenName(char* str, char* format, Node* node);
-
-void strReplaceNodeAbbrev(char* str, char* format, Node* node);
+void strReplaceNodeAbbrev(SourceFile* source, char* str, char* format,
+  Node* node);
 
-void printNode(Node* node);
+void printNode(SourceFile* source, Node* node);
 
 #endif
 
@@ -1,104 +1,542 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <elf.h>
+#include <spawn.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include "xgen.h"
+#include "arena.h"
+#include "compiler.h"
 
-#define TEMP_DIR ".ulpc-temp"
+// Where the temporary directories are created if TMPDIR is not set, and
+// the name of each one (mkdtemp replaces the Xs)
+#define TEMP_PARENT "/tmp"
+#define TEMP_DIR "ulpc-XXXXXX"
 #define ASM_FILE "generated.asm"
 #define OBJ_FILE "obj.o"
-#define EXEC_FILE "a.out"
 #define ASSEMBLER_CMD "nasm"
 #define ASSEMBLER_OPT "-felf64"
 #define LINKER_CMD "ld"
 
-char TEMP_DIR_EXISTED;
+// Initial size of the buffer of an output written to memory (doubled when
+// needed)
+#define INITIAL_MEMORY_OUTPUT (64 * 1024)
+
+// Names of the sections of the executables, in the order of their headers
+// (after the null one)
+#define SECTION_NAMES "\0.text\0.bss\0.shstrtab"
+
+// Names of the sections of the object files, in the order of their headers
+// (.text and .bss are OBJECT_TEXT and OBJECT_BSS), and their offsets in it.
+// The empty .note.GNU-stack tells ld that the stack is not executable.
+#define OBJECT_SECTION_NAMES \
+  "\0.text\0.bss\0.rela.text\0.symtab\0.strtab\0.shstrtab\0.note.GNU-stack"
+#define OBJECT_SECTION_OFFSETS { 0, 1, 7, 12, 23, 31, 39, 49 }
+
+// Number of sections of the object files, the one with the names of the
+// sections, and position of the first symbol that is not a section or the
+// null one in their symbol tables
+#define OBJECT_SECTIONS 8
+#define OBJECT_SECTION_NAMES_INDEX 6
+#define OBJECT_FIRST_SYMBOL 3
+
+extern char** environ;
+
+// Temporary directory of this compilation, only used by nasm and ld, and the
+// paths of the files in it (NULL when there is none)
+__thread char* tempDir;
+__thread char* asmPath;
+__thread char* objPath;
+
+// Executable being written, removed by discardOutput unless it is closed
+__thread char* execName;
+
+// Output file being written (the executable or the assembly code), closed
+// by discardOutput if the compilation fails (-1 when there is none)
+__thread int outputFd = -1;
+
+// Output written to memory instead of a file (NULL when there is none)
+__thread char* memoryOutput;
+__thread long memoryOutputSize;
+__thread long maxMemoryOutput;  // allocated size of memoryOutput
+
+/*
+ * Prints an error about the output, and stops the compilation in progress
+ * (see failCompilation).
+ *
+ * msg: the error message.
+ *
+ */
+void outputError(char* msg);
+
+/*
+ * Makes room in the output written to memory.
+ *
+ * needed: the size the output must be able to hold, in bytes.
+ *
+ */
+void growMemoryOutput(long needed);
 
-void writeAsmFile(char* assemblyCode);
-void createObjectFile();
-void linkObject();
+/*
+ * Assembles the temporary assembly file with nasm.
+ *
+ * objectName: the name of the object file.
+ *
+ */
+void createObjectFile(char* objectName);
+
+/*
+ * Links the temporary object file into an executable with ld.
+ *
+ * outputName: the name of the executable (NULL for the default one).
+ *
+ */
+void linkObject(char* outputName);
+
+/*
+ * Runs an external tool (nasm or ld) and waits for it.
+ *
+ * argv: the name of the tool, found in the PATH, and its arguments (NULL
+ *   terminated).
+ * returns: the exit code of the tool, or -1 if it could not be run.
+ *
+ */
+int runTool(char** argv);
+
+/*
+ * Creates the temporary directory of this compilation, with the paths of
+ * its files.
+ *
+ */
 void createTempDir();
+
+/*
+ * Makes the path of a file of the temporary directory.
+ *
+ * name: the name of the file.
+ * returns: the path (to be freed by the caller).
+ *
+ */
+char* tempPath(char* name);
+
+/*
+ * Removes the temporary directory and its files, if there is one.
+ *
+ */
 void removeTempDir();
 
-void generateExec(char* filename, char* assemblyCode, char* outputName) {
-  if(!assemblyCode) return; // empty program
+/*
+ * Removes the executable being written, if there is one.
+ *
+ */
+void removeExecFile();
 
+int createAsmFile() {
+  // the directory goes away even if the compilation fails (see
+  // discardOutput)
   createTempDir();
-  writeAsmFile(assemblyCode);
-  createObjectFile();
-  linkObject(outputName);
+
+  int asmFd = open(asmPath, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if(asmFd < 0) outputError("Error creating temporary assembly file.");
+  outputFd = asmFd;
+  return asmFd;
+}
+
+void generateExec(char* filename, int asmFd, char* outputName) {
+  outputFd = -1;
+  if(close(asmFd) != 0) outputError("Error writing temporary assembly file.");
+
+  // with -c, the object file is the output
+  if(cli.object) createObjectFile(outputName ? outputName : OBJECT_FILE);
+  else {
+    createObjectFile(objPath);
+    linkObject(outputName);
+  }
 
   removeTempDir();
 }
 
-void writeAsmFile(char* assemblyCode) {
-  FILE* asmFile = fopen(TEMP_DIR "/" ASM_FILE, "w");
-  if(!asmFile) {
-    fprintf(stderr, "Error creating temporary assembly file.\n");
-    exit(1);
+int createExecFile(char* outputName) {
+  execName = outputName ? outputName : (cli.object ? OBJECT_FILE : EXEC_FILE);
+
+  // a new file, so that an executable that is running can be replaced
+  unlink(execName);
+  int execFd = open(execName, O_WRONLY | O_CREAT | O_TRUNC,
+    cli.object ? 0666 : 0777);
+  if(execFd < 0) {
+    execName = NULL;
+    outputError("Error creating the executable file.");
+  }
+  outputFd = execFd;
+
+  if(lseek(execFd, codeOffset(), SEEK_SET) < 0)
+    outputError("Error writing the executable file.");
+  return execFd;
+}
+
+long codeOffset() {
+  return cli.object ? OBJECT_CODE_OFFSET : EXEC_CODE_OFFSET;
+}
+
+long execCodeAddress(long bssSize) {
+  long bssPages = (bssSize + EXEC_PAGE_SIZE - 1) / EXEC_PAGE_SIZE;
+  return EXEC_BASE_ADDRESS + bssPages * EXEC_PAGE_SIZE;
+}
+
+void writeExecHeaders(int execFd, long entry, long codeSize, long bssSize) {
+  long namesOffset = EXEC_CODE_OFFSET + codeSize;
+  long sectionsOffset = (namesOffset + sizeof(SECTION_NAMES) + 7) & ~7L;
+  Elf64_Ehdr header = {
+    .e_ident = { ELFMAG0, ELFMAG1, ELFMAG2, ELFMAG3, ELFCLASS64, ELFDATA2LSB,
+      EV_CURRENT, ELFOSABI_SYSV },
+    .e_type = ET_EXEC,
+    .e_machine = EM_X86_64,
+    .e_version = EV_CURRENT,
+    .e_entry = entry,
+    .e_phoff = sizeof(Elf64_Ehdr),
+    .e_shoff = sectionsOffset,
+    .e_ehsize = sizeof(Elf64_Ehdr),
+    .e_phentsize = sizeof(Elf64_Phdr),
+    .e_phnum = 0,
+    .e_shentsize = sizeof(Elf64_Shdr),
+    .e_shnum = 4,
+    .e_shstrndx = 3
+  };
+
+  // the segments, by address: the global variables (only in memory) and
+  // the code
+  Elf64_Phdr segments[2];
+  if(bssSize > 0) {
+    segments[header.e_phnum++] = (Elf64_Phdr) {
+      .p_type = PT_LOAD, .p_flags = PF_R | PF_W,
+      .p_offset = 0, .p_vaddr = EXEC_BASE_ADDRESS,
+      .p_paddr = EXEC_BASE_ADDRESS, .p_filesz = 0, .p_memsz = bssSize,
+      .p_align = EXEC_PAGE_SIZE
+    };
+  }
+  long codeAddress = execCodeAddress(bssSize);
+  segments[header.e_phnum++] = (Elf64_Phdr) {
+    .p_type = PT_LOAD, .p_flags = PF_R | PF_X,
+    .p_offset = EXEC_CODE_OFFSET, .p_vaddr = codeAddress,
+    .p_paddr = codeAddress, .p_filesz = codeSize, .p_memsz = codeSize,
+    .p_align = EXEC_PAGE_SIZE
+  };
+
+  // the sections are only read by tools such as objdump and gdb
+  Elf64_Shdr sections[4] = {
+    { .sh_type = SHT_NULL },
+    { .sh_name = 1, .sh_type = SHT_PROGBITS,
+      .sh_flags = SHF_ALLOC | SHF_EXECINSTR, .sh_addr = codeAddress,
+      .sh_offset = EXEC_CODE_OFFSET, .sh_size = codeSize, .sh_addralign = 1 },
+    { .sh_name = 7, .sh_type = SHT_NOBITS, .sh_flags = SHF_ALLOC | SHF_WRITE,
+      .sh_addr = EXEC_BASE_ADDRESS, .sh_offset = EXEC_CODE_OFFSET,
+      .sh_size = bssSize, .sh_addralign = 4 },
+    { .sh_name = 12, .sh_type = SHT_STRTAB, .sh_offset = namesOffset,
+      .sh_size = sizeof(SECTION_NAMES), .sh_addralign = 1 }
+  };
+
+  writeOutputAt(execFd, &header, sizeof(header), 0);
+  writeOutputAt(execFd, segments, sizeof(Elf64_Phdr) * header.e_phnum,
+    sizeof(header));
+  writeOutputAt(execFd, SECTION_NAMES, sizeof(SECTION_NAMES), namesOffset);
+  writeOutputAt(execFd, sections, sizeof(sections), sectionsOffset);
+}
+
+void writeObjectHeaders(int objectFd, long codeSize, long bssSize,
+  ObjectSymbol* symbols, int nSymbols, ObjectRelocation* relocations,
+  int nRelocations) {
+  int nEntries = OBJECT_FIRST_SYMBOL + nSymbols;
+  Elf64_Sym* entries = (Elf64_Sym*) arenaAlloc(&compArena,
+    sizeof(Elf64_Sym) * nEntries);
+  int* entryIndex = (int*) arenaAlloc(&compArena, sizeof(int) * nSymbols);
+  long namesSize = 1;
+  for(int i = 0; i < nSymbols; i++) namesSize += strlen(symbols[i].name) + 1;
+  char* names = (char*) arenaAlloc(&compArena, namesSize);
+
+  // the null symbol and those of the sections, then the local symbols, and
+  // then the global ones
+  memset(entries, 0, sizeof(Elf64_Sym) * OBJECT_FIRST_SYMBOL);
+  entries[OBJECT_TEXT] = (Elf64_Sym) {
+    .st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION), .st_shndx = OBJECT_TEXT
+  };
+  entries[OBJECT_BSS] = (Elf64_Sym) {
+    .st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION), .st_shndx = OBJECT_BSS
+  };
+  names[0] = '\0';
+  long namesEnd = 1;
+  int nEntriesDone = OBJECT_FIRST_SYMBOL;
+  int firstGlobal = 0;
+
+  for(int global = 0; global <= 1; global++) {
+    if(global) firstGlobal = nEntriesDone;
+
+    for(int i = 0; i < nSymbols; i++) {
+      ObjectSymbol* symbol = &symbols[i];
+      if(symbol->global != global) continue;
+
+      int type = symbol->section == OBJECT_TEXT ? STT_FUNC
+        : (symbol->section == OBJECT_BSS ? STT_OBJECT : STT_NOTYPE);
+      entryIndex[i] = nEntriesDone;
+      entries[nEntriesDone++] = (Elf64_Sym) {
+        .st_name = namesEnd,
+        .st_info = ELF64_ST_INFO(global ? STB_GLOBAL : STB_LOCAL, type),
+        .st_shndx = symbol->section == OBJECT_UNDEFINED ? SHN_UNDEF
+          : symbol->section,
+        .st_value = symbol->value
+      };
+      namesEnd = stpcpy(names + namesEnd, symbol->name) - names + 1;
+    }
+  }
+
+  // calls to functions go through the PLT (if the linker makes one), and
+  // the global variables are addressed relative to the code
+  Elf64_Rela* entryRelocations = (Elf64_Rela*) arenaAlloc(&compArena,
+    sizeof(Elf64_Rela) * (nRelocations > 0 ? nRelocations : 1));
+  for(int i = 0; i < nRelocations; i++) {
+    ObjectRelocation* relocation = &relocations[i];
+    int type = symbols[relocation->symbol].section == OBJECT_BSS
+      ? R_X86_64_PC32 : R_X86_64_PLT32;
+    entryRelocations[i] = (Elf64_Rela) {
+      .r_offset = relocation->offset,
+      .r_info = ELF64_R_INFO(entryIndex[relocation->symbol], type),
+      .r_addend = relocation->addend
+    };
+  }
+
+  // after the code: the relocations, the symbols, their names, the names of
+  // the sections and the headers of the sections
+  long relocationsOffset = (OBJECT_CODE_OFFSET + codeSize + 7) & ~7L;
+  long relocationsSize = sizeof(Elf64_Rela) * nRelocations;
+  long symbolsOffset = relocationsOffset + relocationsSize;
+  long symbolsSize = sizeof(Elf64_Sym) * nEntries;
+  long namesOffset = symbolsOffset + symbolsSize;
+  long sectionNamesOffset = namesOffset + namesEnd;
+  long sectionsOffset = (sectionNamesOffset + sizeof(OBJECT_SECTION_NAMES)
+    + 7) & ~7L;
+
+  Elf64_Ehdr header = {
+    .e_ident = { ELFMAG0, ELFMAG1, ELFMAG2, ELFMAG3, ELFCLASS64, ELFDATA2LSB,
+      EV_CURRENT, ELFOSABI_SYSV },
+    .e_type = ET_REL,
+    .e_machine = EM_X86_64,
+    .e_version = EV_CURRENT,
+    .e_shoff = sectionsOffset,
+    .e_ehsize = sizeof(Elf64_Ehdr),
+    .e_shentsize = sizeof(Elf64_Shdr),
+    .e_shnum = OBJECT_SECTIONS,
+    .e_shstrndx = OBJECT_SECTION_NAMES_INDEX
+  };
+
+  int nameOffsets[OBJECT_SECTIONS] = OBJECT_SECTION_OFFSETS;
+  Elf64_Shdr sections[OBJECT_SECTIONS] = {
+    { .sh_type = SHT_NULL },
+    { .sh_type = SHT_PROGBITS, .sh_flags = SHF_ALLOC | SHF_EXECINSTR,
+      .sh_offset = OBJECT_CODE_OFFSET, .sh_size = codeSize,
+      .sh_addralign = 16 },
+    { .sh_type = SHT_NOBITS, .sh_flags = SHF_ALLOC | SHF_WRITE,
+      .sh_offset = OBJECT_CODE_OFFSET + codeSize, .sh_size = bssSize,
+      .sh_addralign = 8 },
+    { .sh_type = SHT_RELA, .sh_flags = SHF_INFO_LINK,
+      .sh_offset = relocationsOffset, .sh_size = relocationsSize,
+      .sh_link = 4, .sh_info = OBJECT_TEXT, .sh_addralign = 8,
+      .sh_entsize = sizeof(Elf64_Rela) },
+    { .sh_type = SHT_SYMTAB, .sh_offset = symbolsOffset,
+      .sh_size = symbolsSize, .sh_link = 5, .sh_info = firstGlobal,
+      .sh_addralign = 8, .sh_entsize = sizeof(Elf64_Sym) },
+    { .sh_type = SHT_STRTAB, .sh_offset = namesOffset, .sh_size = namesEnd,
+      .sh_addralign = 1 },
+    { .sh_type = SHT_STRTAB, .sh_offset = sectionNamesOffset,
+      .sh_size = sizeof(OBJECT_SECTION_NAMES), .sh_addralign = 1 },
+    { .sh_type = SHT_PROGBITS, .sh_offset = sectionNamesOffset,
+      .sh_addralign = 1 }
+  };
+  for(int i = 0; i < OBJECT_SECTIONS; i++)
+    sections[i].sh_name = nameOffsets[i];
+
+  writeOutputAt(objectFd, &header, sizeof(header), 0);
+  writeOutputAt(objectFd, entryRelocations, relocationsSize,
+    relocationsOffset);
+  writeOutputAt(objectFd, entries, symbolsSize, symbolsOffset);
+  writeOutputAt(objectFd, names, namesEnd, namesOffset);
+  writeOutputAt(objectFd, OBJECT_SECTION_NAMES, sizeof(OBJECT_SECTION_NAMES),
+    sectionNamesOffset);
+  writeOutputAt(objectFd, sections, sizeof(sections), sectionsOffset);
+}
+
+void closeExecFile(int execFd) {
+  outputFd = -1;
+  if(close(execFd) != 0) outputError("Error writing the executable file.");
+  execName = NULL;
+}
+
+int createMemoryOutput(char native) {
+  memoryOutputSize = 0;
+  growMemoryOutput(INITIAL_MEMORY_OUTPUT);
+
+  // room for the headers, which are written at the end
+  if(native) {
+    memset(memoryOutput, 0, codeOffset());
+    memoryOutputSize = codeOffset();
+  }
+  return MEMORY_OUTPUT;
+}
+
+char* takeMemoryOutput(long* size) {
+  char* output = memoryOutput;
+  *size = memoryOutputSize;
+  memoryOutput = NULL;
+  memoryOutputSize = maxMemoryOutput = 0;
+  return output;
+}
+
+void writeOutput(int fd, void* data, long size) {
+  if(fd == MEMORY_OUTPUT) {
+    writeOutputAt(fd, data, size, memoryOutputSize);
+    return;
   }
 
-  fprintf(asmFile, "%s", assemblyCode);
-  fclose(asmFile);
+  for(long done = 0; done < size; ) {
+    ssize_t n = write(fd, (char*) data + done, size - done);
+    if(n < 0) outputError("Error writing the output file.");
+    done += n;
+  }
 }
 
-void createObjectFile() {
-  int ret = system(ASSEMBLER_CMD " " ASSEMBLER_OPT " " TEMP_DIR "/" ASM_FILE
-    " -o " TEMP_DIR "/" OBJ_FILE);
+void writeOutputAt(int fd, void* data, long size, long offset) {
+  if(fd == MEMORY_OUTPUT) {
+    growMemoryOutput(offset + size);
+    if(offset > memoryOutputSize)
+      memset(memoryOutput + memoryOutputSize, 0, offset - memoryOutputSize);
+    memcpy(memoryOutput + offset, data, size);
+    if(offset + size > memoryOutputSize) memoryOutputSize = offset + size;
+    return;
+  }
 
-  if(ret != 0) { // error: stop
-    fprintf(stderr, "Assembler error. Object file not created.\n");
-    removeTempDir();
-    exit(1);
+  for(long done = 0; done < size; ) {
+    ssize_t n = pwrite(fd, (char*) data + done, size - done, offset + done);
+    if(n < 0) outputError("Error writing the output file.");
+    done += n;
   }
 }
 
+void growMemoryOutput(long needed) {
+  if(needed <= maxMemoryOutput) return;
+
+  long newSize = maxMemoryOutput > 0 ? maxMemoryOutput
+    : INITIAL_MEMORY_OUTPUT;
+  while(newSize < needed) newSize *= 2;
+
+  char* grown = (char*) realloc(memoryOutput, newSize);
+  if(!grown) outputError("Out of memory.");
+  memoryOutput = grown;
+  maxMemoryOutput = newSize;
+}
+
+void discardOutput() {
+  if(outputFd >= 0) close(outputFd);
+  outputFd = -1;
+  removeExecFile();
+  removeTempDir();
+
+  long size;
+  free(takeMemoryOutput(&size));
+}
+
+void outputError(char* msg) {
+  fprintf(stderr, "%s\n", msg);
+  failCompilation(PHASE_OUTPUT, msg, 0, 0);
+}
+
+void removeExecFile() {
+  if(execName) unlink(execName);
+  execName = NULL;
+}
+
+void createObjectFile(char* objectName) {
+  char* argv[] = { ASSEMBLER_CMD, ASSEMBLER_OPT, asmPath, "-o", objectName,
+    NULL };
+
+  // on errors, the directory is removed by discardOutput
+  if(runTool(argv) != 0)
+    outputError("Assembler error. Object file not created.");
+}
+
 void linkObject(char* outputName) {
-  int ret;
-
-  if(outputName == NULL) { // no output specified
-    ret = system(LINKER_CMD " " TEMP_DIR "/" OBJ_FILE " -o " EXEC_FILE);
-  } else { // use specified output name
-    char* fmt = LINKER_CMD " " TEMP_DIR "/" OBJ_FILE " -o %s";
-    char* cmdStr = (char*) malloc(sizeof(char) * (strlen(LINKER_CMD) +
-      strlen(TEMP_DIR) + strlen(OBJ_FILE) + strlen(outputName) + 10));
-    sprintf(cmdStr, fmt, outputName);
-    ret = system(cmdStr);
-    free(cmdStr);
+  char* argv[] = { LINKER_CMD, objPath, "-o",
+    outputName ? outputName : EXEC_FILE, NULL };
+
+  if(runTool(argv) != 0)
+    outputError("Linker error. Executable file not created.");
+}
+
+void linkObjectFiles(char** objectNames, int nObjects, char* outputName) {
+  char** argv = (char**) arenaAlloc(&compArena,
+    sizeof(char*) * (nObjects + 4));
+  argv[0] = LINKER_CMD;
+  memcpy(argv + 1, objectNames, sizeof(char*) * nObjects);
+  argv[nObjects + 1] = "-o";
+  argv[nObjects + 2] = outputName ? outputName : EXEC_FILE;
+  argv[nObjects + 3] = NULL;
+
+  if(runTool(argv) != 0)
+    outputError("Linker error. Executable file not created.");
+}
+
+int runTool(char** argv) {
+  // the tool is run directly (found in the PATH), without a shell
+  pid_t pid;
+  int err = posix_spawnp(&pid, argv[0], NULL, NULL, argv, environ);
+  if(err != 0) {
+    fprintf(stderr, "Error running %s: %s.\n", argv[0], strerror(err));
+    return -1;
   }
 
-  if(ret != 0) { // error: stop
-    fprintf(stderr, "Linker error. Executable file not created.\n");
-    removeTempDir();
-    exit(1);
+  int status;
+  while(waitpid(pid, &status, 0) < 0) {
+    if(errno != EINTR) return -1;
   }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
 }
 
 void createTempDir() {
-  TEMP_DIR_EXISTED = 0;
-  struct stat s;
-  int stat_ret = stat(TEMP_DIR, &s);
-
-  if(stat_ret == -1) {
-    if(errno == ENOENT) { // directory does not exist, create it
-      mkdir(TEMP_DIR, S_IRUSR | S_IWUSR | S_IXUSR);
-    } else {
-      fprintf(stderr, "Error creating temporary build directory.\n");
-      exit(1);
-    }
-  } else {
-    if(S_ISDIR(s.st_mode)) { // directory exists, use it
-      TEMP_DIR_EXISTED = 1;
-    } else { // exists but it is not a directory
-      fprintf(stderr, "Error: there exists a file with the same name as the "
-        "temporary build directory.\n");
-      exit(1);
-    }
+  // a new directory for each compilation, so that many of them can run at
+  // the same time
+  char* parent = getenv("TMPDIR");
+  if(!parent || !*parent) parent = TEMP_PARENT;
+
+  tempDir = (char*) malloc(strlen(parent) + strlen(TEMP_DIR) + 2);
+  sprintf(tempDir, "%s/%s", parent, TEMP_DIR);
+  if(!mkdtemp(tempDir)) {
+    free(tempDir);
+    tempDir = NULL;
+    outputError("Error creating temporary build directory.");
   }
+
+  asmPath = tempPath(ASM_FILE);
+  objPath = tempPath(OBJ_FILE);
+}
+
+char* tempPath(char* name) {
+  char* path = (char*) malloc(strlen(tempDir) + strlen(name) + 2);
+  sprintf(path, "%s/%s", tempDir, name);
+  return path;
 }
 
 void removeTempDir() {
-  if(!TEMP_DIR_EXISTED) system("rm -rf " TEMP_DIR);
+  if(!tempDir) return;
+
+  unlink(asmPath);
+  unlink(objPath);
+  rmdir(tempDir);
+  free(asmPath);
+  free(objPath);
+  free(tempDir);
+  tempDir = asmPath = objPath = NULL;
 }
 
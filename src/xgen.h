@@ -1,23 +1,206 @@
 /*
  *
  *
- * Executable generator. The task of this code is to take the assembly
- * generated by the code generator and transform it into an executable file.
+ * Executable generator. The task of this code is to take the code
+ * generated by the code generator and transform it into an executable file:
+ * either the machine code, which only needs the headers of a static ELF64
+ * executable, or the assembly code, which is processed by nasm and ld.
+ *
+ * With -c, the output is a relocatable ELF64 object file instead, to be
+ * linked with other ones (see linker.h).
  *
  */
 
 #ifndef XGEN_H
 #define XGEN_H
 
+// Address where the global variables of an executable are loaded (the
+// machine code goes after them, starting at a new page)
+#define EXEC_BASE_ADDRESS 0x400000
+
+// Size of a memory page
+#define EXEC_PAGE_SIZE 0x1000
+
+// Name of the executable when none is given
+#define EXEC_FILE "a.out"
+
+// Offset of the machine code in the executable file
+#define EXEC_CODE_OFFSET EXEC_PAGE_SIZE
+
+// Name of the object file when none is given (and the source has no name)
+#define OBJECT_FILE "a.o"
+
+// Offset of the machine code in an object file (after its ELF header)
+#define OBJECT_CODE_OFFSET 64
+
+// Sections of the symbols of an object file
+#define OBJECT_UNDEFINED 0  // defined in another object
+#define OBJECT_TEXT 1
+#define OBJECT_BSS 2
+
+// A symbol of an object file
+typedef struct stObjectSymbol {
+  char* name;
+  long value;  // offset in its section
+  char section;  // OBJECT_TEXT, OBJECT_BSS or OBJECT_UNDEFINED
+  char global;  // 1 if other objects see it, 0 if it is local
+} ObjectSymbol;
+
+// A 32-bit displacement of the machine code of an object file, filled in by
+// the linker with the address of a symbol plus an addend, relative to the
+// displacement
+typedef struct stObjectRelocation {
+  long offset;  // where it is, from the start of the machine code
+  int symbol;  // position of the symbol among the symbols of the object
+  long addend;
+} ObjectRelocation;
+
+// File descriptor that stands for an output written to memory (see
+// createMemoryOutput)
+#define MEMORY_OUTPUT -2
+
 /*
- * Generates an executable file from a string containing assembly code.
+ * Creates the temporary file where the assembly code is written.
+ *
+ * returns: the file descriptor of the file.
+ *
+ */
+int createAsmFile();
+
+/*
+ * Generates an executable file from the assembly code written to the
+ * temporary file.
  *
  * filename: the source file name.
- * assemblyCode: the string containing the assembly code.
+ * asmFd: the file descriptor of the temporary file (it is closed).
  * outputName: the name of the output file.
  *
  */
-void generateExec(char* filename, char* assemblyCode, char* outputName);
+void generateExec(char* filename, int asmFd, char* outputName);
+
+/*
+ * Creates the executable (or object) file where the machine code is
+ * written. The code goes from codeOffset() on, and the headers are written
+ * at the end by writeExecHeaders (or writeObjectHeaders). The file is
+ * removed if the compilation fails (see discardOutput).
+ *
+ * outputName: the name of the output file (NULL for the default one).
+ * returns: the file descriptor of the file.
+ *
+ */
+int createExecFile(char* outputName);
+
+/*
+ * Tells where the machine code goes in the output file: EXEC_CODE_OFFSET,
+ * or OBJECT_CODE_OFFSET with -c.
+ *
+ */
+long codeOffset();
+
+/*
+ * Tells where the machine code of an executable is loaded.
+ *
+ * bssSize: the size of the global variables, which are loaded before it.
+ * returns: the address of the first byte of the machine code.
+ *
+ */
+long execCodeAddress(long bssSize);
+
+/*
+ * Writes the ELF headers of an executable whose machine code was written.
+ *
+ * execFd: the file descriptor of the executable.
+ * entry: the address of the entry point.
+ * codeSize: the size of the machine code.
+ * bssSize: the size of the global variables.
+ *
+ */
+void writeExecHeaders(int execFd, long entry, long codeSize, long bssSize);
+
+/*
+ * Writes the ELF headers, symbols and relocations of an object file whose
+ * machine code was written.
+ *
+ * objectFd: the file descriptor of the object file.
+ * codeSize: the size of the machine code.
+ * bssSize: the size of the global variables.
+ * symbols: the symbols (in any order: the local ones are put first).
+ * nSymbols: the number of symbols.
+ * relocations: the relocations of the machine code.
+ * nRelocations: the number of relocations.
+ *
+ */
+void writeObjectHeaders(int objectFd, long codeSize, long bssSize,
+  ObjectSymbol* symbols, int nSymbols, ObjectRelocation* relocations,
+  int nRelocations);
+
+/*
+ * Links object files into an executable with ld (with --nasm).
+ *
+ * objectNames: the names of the object files.
+ * nObjects: the number of object files.
+ * outputName: the name of the executable (NULL for the default one).
+ *
+ */
+void linkObjectFiles(char** objectNames, int nObjects, char* outputName);
+
+/*
+ * Closes the executable file, which is then kept.
+ *
+ * execFd: the file descriptor of the executable.
+ *
+ */
+void closeExecFile(int execFd);
+
+/*
+ * Starts an output written to memory instead of a file: machine code (with
+ * room for the headers, as in the executable file) or assembly code.
+ *
+ * native: 1 for machine code, 0 for assembly code.
+ * returns: MEMORY_OUTPUT, to be used as the file descriptor of the output.
+ *
+ */
+int createMemoryOutput(char native);
+
+/*
+ * Takes the output written to memory, which is no longer kept here.
+ *
+ * size: where to leave the size of the output.
+ * returns: the output (to be freed by the caller), NULL if there is none.
+ *
+ */
+char* takeMemoryOutput(long* size);
+
+/*
+ * Appends data to an output.
+ *
+ * fd: the file descriptor of the output (or MEMORY_OUTPUT).
+ * data: the data.
+ * size: the size of the data, in bytes.
+ *
+ */
+void writeOutput(int fd, void* data, long size);
+
+/*
+ * Writes data at a position of an output, leaving the end of the output
+ * where it was (or at the end of the data, if it goes beyond it).
+ *
+ * fd: the file descriptor of the output (or MEMORY_OUTPUT).
+ * data: the data.
+ * size: the size of the data, in bytes.
+ * offset: the position of the data in the output.
+ *
+ */
+void writeOutputAt(int fd, void* data, long size, long offset);
+
+/*
+ * Cleans up the output of a compilation that did not finish: closes the
+ * file being written, and removes the executable that was not closed, the
+ * temporary directory and the output in memory that was not taken. Does
+ * nothing after a successful compilation.
+ *
+ */
+void discardOutput();
 
 #endif
 
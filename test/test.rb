@@ -10,6 +10,34 @@ BUILD_DIR = "build"
 $total = 0
 $success = 0
 
+# A directive of a case, given in its leading comments (e.g. "// exit: 0").
+def directive f, name
+  File.open(f, "rb") do |file|
+    file.each_line do |line|
+      return nil unless line.start_with? "//"
+      value = line[/^\/\/ #{name}: (.*)$/, 1]
+      return value.strip if value
+    end
+  end
+  nil
+end
+
+# Options of a case, given by a directive like "// options: -c". With
+# --link, the case is compiled into an object file, which is then linked.
+def test_command f
+  options = directive(f, "options").to_s
+  ulpc = "#{BUILD_DIR}/ulpc --silent"
+  exec = "#{BUILD_DIR}/#{TEST_EXEC}"
+
+  if options.split.include? "--link" then
+    object = "#{exec}.o"
+    "if #{ulpc} -c #{f} -o #{object} ; then " \
+      "#{ulpc} --link #{object} -o #{exec} ; echo $? ; else echo 2 ; fi"
+  else
+    "#{ulpc} #{options} #{f} -o #{exec} ; echo $?"
+  end
+end
+
 def run_tests dir, suite_label, expected_result
   puts suite_label
 
@@ -18,8 +46,7 @@ def run_tests dir, suite_label, expected_result
 
   files.each do |f|
     $total += 1
-    command = "#{BUILD_DIR}/ulpc --silent #{f} -o #{BUILD_DIR}/#{TEST_EXEC}" \
-      " ; echo $?"
+    command = test_command f
 
   #  puts "Running command:"
   #  puts "\t#{command}"
@@ -27,8 +54,15 @@ def run_tests dir, suite_label, expected_result
 
     result = `#{command}`
     filename = f.sub "#{dir}/", ""
-    
-    if result.strip == expected_result then 
+    passed = result.strip == expected_result
+
+    # a case with an exit value is also run, and must end with it
+    exit_value = directive f, "exit"
+    if passed && exit_value then
+      passed = `#{BUILD_DIR}/#{TEST_EXEC} ; echo $?`.strip == exit_value
+    end
+
+    if passed then
       $success += 1
       puts "\t#{SUCCESS_COLOR}pass#{END_COLOR} #{filename}"
     else 
@@ -39,6 +73,36 @@ def run_tests dir, suite_label, expected_result
   puts ""
 end
 
+# Each directory is a program split into modules: they are compiled with -c,
+# and the objects are linked and run, which must end with exit value 0.
+def run_module_tests dir, suite_label
+  puts suite_label
+
+  programs = `ls -d #{dir}/*/`.split "\n"
+
+  programs.each do |program|
+    $total += 1
+    ulpc = "#{BUILD_DIR}/ulpc --silent"
+    exec = "#{BUILD_DIR}/#{TEST_EXEC}"
+    sources = `ls #{program}*#{EXTENSION}`.split "\n"
+    objects = sources.each_index.map { |i| "#{exec}#{i}.o" }
+
+    compile = sources.zip(objects).map { |f, o| "#{ulpc} -c #{f} -o #{o}" }
+    command = (compile + ["#{ulpc} --link #{objects.join " "} -o #{exec}",
+      exec]).join(" && ") + " ; echo $?"
+    name = program.sub("#{dir}/", "").chomp "/"
+
+    if `#{command}`.strip == "0" then
+      $success += 1
+      puts "\t#{SUCCESS_COLOR}pass#{END_COLOR} #{name}"
+    else
+      puts "\t#{ERROR_COLOR}fail#{END_COLOR} #{name}"
+    end
+  end
+
+  puts ""
+end
+
 def print_totals
   failures = $total - $success
 
@@ -61,4 +125,5 @@ print "Running test suite...\n\n"
 
 run_tests "test/cases/pos", "Positive tests:", "0"
 run_tests "test/cases/neg", "Negative tests:", "1"
+run_module_tests "test/cases/modules", "Module tests:"
 print_totals